@@ -0,0 +1,104 @@
+// TWI transaction queue: polling a DS3231 and a 24Cxx
+//
+// Reads the time registers of a DS3231 (0x68) and the first 16 bytes
+// of a 24Cxx EEPROM (0x50) through the interrupt driven queue
+// (utility/twi_queue.h) on A4 (SDA) / A5 (SCL). Both transactions are
+// resubmitted as soon as they have completed, the main loop only calls
+// twiq_poll(). Every 2 seconds the time read last and the counters in
+// twiq_stat are printed.
+//
+// A missing device shows up as nack, a stuck bus as timeout.
+
+#include <Wire.h>
+#include <utility/twi_queue.h>
+
+#define RTC_ADDR    0x68
+#define EEP_ADDR    0x50
+
+uint8_t    rtcReg = 0, rtcBuf[7];
+uint8_t    eepAdr[2] = { 0, 0 }, eepBuf[16];
+twiq_trans rtc, eep;
+
+// results, copied in the callbacks: the buffers are rewritten as soon
+// as the transactions are submitted again
+uint8_t    hms[3], rtcValid = 0;
+uint8_t    eepFirst = 0xff;
+uint32_t   lastPrint;
+
+void rtcDone(twiq_trans *t)
+{
+  rtcValid = (TWIQ_DONE == t->status);
+  if (rtcValid) {
+    hms[0] = rtcBuf[2] & 0x3f;
+    hms[1] = rtcBuf[1];
+    hms[2] = rtcBuf[0] & 0x7f;
+  }
+}
+
+void eepDone(twiq_trans *t)
+{
+  if (TWIQ_DONE == t->status) {
+    eepFirst = eepBuf[0];
+  }
+}
+
+void print2(uint8_t bcd)
+{
+  Serial.print(bcd >> 4);
+  Serial.print(bcd & 0x0f);
+}
+
+void printStats(void)
+{
+  twiq_stats s;
+  uint16_t   n;
+
+  noInterrupts();                       // twiq_stat is updated by the ISR
+  s = *(twiq_stats *)&twiq_stat;
+  interrupts();
+  n = s.done + s.nack + s.timeout + s.error;      // latencySum covers all of them
+
+  if (rtcValid) {
+    print2(hms[0]); Serial.print(':');
+    print2(hms[1]); Serial.print(':');
+    print2(hms[2]);
+  } else {
+    Serial.print(F("--:--:--"));
+  }
+  Serial.print(F("  eep[0]: 0x"));
+  Serial.print(eepFirst, HEX);
+
+  Serial.print(F("  done: "));        Serial.print(s.done);
+  Serial.print(F("  nack: "));        Serial.print(s.nack);
+  Serial.print(F("  timeout: "));     Serial.print(s.timeout);
+  Serial.print(F("  error: "));       Serial.print(s.error);
+  Serial.print(F("  latency avg/max: "));
+  Serial.print(n ? s.latencySum / n : 0);
+  Serial.print('/');
+  Serial.print(s.latencyMax);
+  Serial.println(F(" us"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  twiq_init();
+  twiq_setup(&rtc, RTC_ADDR, &rtcReg, 1, rtcBuf, sizeof(rtcBuf), rtcDone);
+  twiq_setup(&eep, EEP_ADDR, eepAdr, 2, eepBuf, sizeof(eepBuf), eepDone);
+  lastPrint = millis();
+}
+
+void loop()
+{
+  twiq_poll();                          // callbacks, timeouts
+
+  twiq_submit(&rtc);                    // ignored while still queued
+  twiq_submit(&eep);
+
+  if (millis() - lastPrint >= 2000) {
+    lastPrint = millis();
+    printStats();
+    twiq_clearStats();
+  }
+}
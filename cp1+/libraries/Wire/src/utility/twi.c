@@ -39,6 +39,7 @@
 
 #include "pins_arduino.h"
 #include "twi.h"
+#include "cp1_i2ctr.h"
 
 static volatile uint8_t twi_state;
 static volatile uint8_t twi_slarw;
@@ -57,6 +58,7 @@ static volatile bool twi_do_reset_on_timeout = false;  // reset the TWI register
 
 static void (*twi_onSlaveTransmit)(void);
 static void (*twi_onSlaveReceive)(uint8_t*, int);
+static void (*twi_onMasterQueue)(uint8_t);
 
 static uint8_t twi_masterBuffer[TWI_BUFFER_LENGTH];
 static volatile uint8_t twi_masterBufferIndex;
@@ -384,6 +386,40 @@ void twi_attachSlaveTxEvent( void (*function)(void) )
   twi_onSlaveTransmit = function;
 }
 
+/* 
+ * Function twi_attachMasterQueue
+ * Desc     sets function that handles all master interrupts while
+ *          the bus is owned by the transaction queue (TWI_MQX)
+ * Input    function: handler, called from the ISR with TW_STATUS
+ * Output   none
+ */
+void twi_attachMasterQueue( void (*function)(uint8_t) )
+{
+  twi_onMasterQueue = function;
+}
+
+/* 
+ * Function twi_acquireBus
+ * Desc     hands the idle bus over to the transaction queue, the
+ *          blocking functions wait until it is TWI_READY again
+ * Input    none
+ * Output   1 .. bus acquired, state is TWI_MQX
+ *          0 .. twi busy or in a repeated start
+ */
+uint8_t twi_acquireBus(void)
+{
+  uint8_t sreg = SREG;
+  uint8_t ok = 0;
+
+  cli();
+  if ((TWI_READY == twi_state) && (false == twi_inRepStart) && twi_onMasterQueue) {
+    twi_state = TWI_MQX;
+    ok = 1;
+  }
+  SREG = sreg;
+  return ok;
+}
+
 /* 
  * Function twi_reply
  * Desc     sends byte or readys receive line
@@ -408,6 +444,8 @@ void twi_reply(uint8_t ack)
  */
 void twi_stop(void)
 {
+  i2ctr_stop(i2ctr_twi);
+
   // send stop condition
   TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT) | _BV(TWSTO);
 
@@ -440,6 +478,8 @@ void twi_stop(void)
  */
 void twi_releaseBus(void)
 {
+  i2ctr_stop(i2ctr_twi);
+
   // release bus
   TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT);
 
@@ -502,10 +542,16 @@ bool twi_manageTimeoutFlag(bool clear_flag){
 
 ISR(TWI_vect)
 {
+  if (TWI_MQX == twi_state) {
+    twi_onMasterQueue(TW_STATUS);
+    return;
+  }
+
   switch(TW_STATUS){
     // All Master
     case TW_START:     // sent start condition
     case TW_REP_START: // sent repeated start condition
+      i2ctr_start(i2ctr_twi);
       // copy device address and r/w bit to output register and ack
       TWDR = twi_slarw;
       twi_reply(1);
@@ -514,6 +560,7 @@ ISR(TWI_vect)
     // Master Transmitter
     case TW_MT_SLA_ACK:  // slave receiver acked address
     case TW_MT_DATA_ACK: // slave receiver acked data
+      i2ctr_write(i2ctr_twi, (TW_STATUS == TW_MT_SLA_ACK) ? twi_slarw : 0, 1);
       // if there is data to send, send it, otherwise stop 
       if(twi_masterBufferIndex < twi_masterBufferLength){
         // copy data to output register and ack
@@ -524,6 +571,7 @@ ISR(TWI_vect)
           twi_stop();
        } else {
          twi_inRepStart = true;	// we're gonna send the START
+         i2ctr_start(i2ctr_twi);
          // don't enable the interrupt. We'll generate the start, but we
          // avoid handling the interrupt until we're in the next transaction,
          // at the point where we would normally issue the start.
@@ -533,10 +581,12 @@ ISR(TWI_vect)
       }
       break;
     case TW_MT_SLA_NACK:  // address sent, nack received
+      i2ctr_write(i2ctr_twi, twi_slarw, 0);
       twi_error = TW_MT_SLA_NACK;
       twi_stop();
       break;
     case TW_MT_DATA_NACK: // data sent, nack received
+      i2ctr_write(i2ctr_twi, 0, 0);
       twi_error = TW_MT_DATA_NACK;
       twi_stop();
       break;
@@ -549,8 +599,12 @@ ISR(TWI_vect)
     case TW_MR_DATA_ACK: // data received, ack sent
       // put byte into buffer
       twi_masterBuffer[twi_masterBufferIndex++] = TWDR;
+      i2ctr_read(i2ctr_twi);
       __attribute__ ((fallthrough));
     case TW_MR_SLA_ACK:  // address sent, ack received
+      if (TW_STATUS == TW_MR_SLA_ACK) {
+        i2ctr_write(i2ctr_twi, twi_slarw, 1);
+      }
       // ack if more bytes are expected, otherwise nack
       if(twi_masterBufferIndex < twi_masterBufferLength){
         twi_reply(1);
@@ -561,10 +615,12 @@ ISR(TWI_vect)
     case TW_MR_DATA_NACK: // data received, nack sent
       // put final byte into buffer
       twi_masterBuffer[twi_masterBufferIndex++] = TWDR;
+      i2ctr_read(i2ctr_twi);
       if (twi_sendStop){
         twi_stop();
       } else {
         twi_inRepStart = true;	// we're gonna send the START
+        i2ctr_start(i2ctr_twi);
         // don't enable the interrupt. We'll generate the start, but we
         // avoid handling the interrupt until we're in the next transaction,
         // at the point where we would normally issue the start.
@@ -573,6 +629,7 @@ ISR(TWI_vect)
       }
       break;
     case TW_MR_SLA_NACK: // address sent, nack received
+      i2ctr_write(i2ctr_twi, twi_slarw, 0);
       twi_stop();
       break;
     // TW_MR_ARB_LOST handled by TW_MT_ARB_LOST case
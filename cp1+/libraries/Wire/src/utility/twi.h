@@ -39,6 +39,7 @@
   #define TWI_MTX   2
   #define TWI_SRX   3
   #define TWI_STX   4
+  #define TWI_MQX   5   // master, transaction queue (twi_queue.c)
   
   void twi_init(void);
   void twi_disable(void);
@@ -55,5 +56,7 @@
   void twi_setTimeoutInMicros(uint32_t, bool);
   void twi_handleTimeout(bool);
   bool twi_manageTimeoutFlag(bool);
+  uint8_t twi_acquireBus(void);
+  void twi_attachMasterQueue( void (*)(uint8_t) );
 
 #endif
@@ -0,0 +1,319 @@
+/*
+  twi_queue.c - non-blocking I2C master transaction queue on the TWI
+
+  The queue is a ring of transaction pointers:
+
+    [qdone, qact)  completed, callback not yet run (twiq_poll)
+    qact           on the bus
+    (qact, qput)   pending
+
+  While the queue owns the bus the TWI state is TWI_MQX and twi.c hands
+  every interrupt to twiq_isr. Consecutive transactions are chained with
+  STOP + START in one TWCR write, the bus is only given back (TWI_READY)
+  when the queue is empty.
+*/
+
+#include <inttypes.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <compat/twi.h>
+#include "Arduino.h" // for micros
+
+#include "twi.h"
+#include "twi_queue.h"
+#include "cp1_i2ctr.h"
+
+#define TWCR_GO    (_BV(TWEN) | _BV(TWIE) | _BV(TWINT))
+
+volatile twiq_stats twiq_stat;
+
+static twiq_trans * volatile twiq_ring[TWIQ_LENGTH];
+static volatile uint8_t twiq_put;
+static volatile uint8_t twiq_act;
+static volatile uint8_t twiq_done;
+
+static volatile uint8_t twiq_widx;
+static volatile uint8_t twiq_ridx;
+static volatile uint8_t twiq_reading;             // read phase (after rep. start)
+static volatile uint32_t twiq_busStart;           // micros() when the transaction got the bus
+static uint32_t twiq_timeout_us = 25000ul;
+
+static void twiq_isr(uint8_t status);
+
+/*
+ * Function twiq_init
+ * Desc     initializes the TWI and attaches the queue
+ * Input    none
+ * Output   none
+ */
+void twiq_init(void)
+{
+  twiq_put = twiq_act = twiq_done = 0;
+  twiq_clearStats();
+  twi_init();
+  twi_attachMasterQueue(twiq_isr);
+}
+
+/*
+ * Function twiq_setup
+ * Desc     prepares a transaction, it may be submitted again after
+ *          it has completed
+ * Input    t: transaction
+ *          address: 7bit i2c device address
+ *          wbuf, wlen: bytes to write (wlen 0: no write phase)
+ *          rbuf, rlen: buffer for bytes read (rlen 0: no read phase)
+ *          callback: called from twiq_poll() on completion, may be 0
+ * Output   none
+ */
+void twiq_setup(twiq_trans* t, uint8_t address, uint8_t* wbuf, uint8_t wlen,
+                uint8_t* rbuf, uint8_t rlen, twiq_callback callback)
+{
+  t->address = address;
+  t->wbuf = wbuf;
+  t->wlen = wlen;
+  t->rbuf = rbuf;
+  t->rlen = rlen;
+  t->callback = callback;
+  t->status = TWIQ_IDLE;
+  t->latency = 0;
+}
+
+/*
+ * Function twiq_begin
+ * Desc     puts transaction twiq_act on the bus, called with
+ *          interrupts disabled
+ * Input    twcr: TWCR bits that generate the (STOP +) START
+ * Output   none
+ */
+static void twiq_begin(uint8_t twcr)
+{
+  twiq_ring[twiq_act]->status = TWIQ_BUSY;
+  twiq_widx = 0;
+  twiq_ridx = 0;
+  twiq_reading = (0 == twiq_ring[twiq_act]->wlen) && (twiq_ring[twiq_act]->rlen);
+  twiq_busStart = micros();
+  TWCR = twcr;
+}
+
+/*
+ * Function twiq_complete
+ * Desc     finishes transaction twiq_act, updates the statistics and
+ *          chains the next pending transaction (ISR or interrupts
+ *          disabled)
+ * Input    status: TWIQ_DONE .. TWIQ_TIMEOUT
+ *          bus: 1 .. a STOP has to be sent, 0 .. TWI was reset
+ * Output   none
+ */
+static void twiq_complete(uint8_t status, uint8_t bus)
+{
+  twiq_trans* t = twiq_ring[twiq_act];
+  uint32_t lat = micros() - t->queued;
+
+  i2ctr_stop(i2ctr_twi);
+  t->latency = (lat > 0xfffful) ? 0xffff : lat;
+  t->status = status;
+
+  switch(status){
+    case TWIQ_DONE:      twiq_stat.done++; break;
+    case TWIQ_NACK_ADDR:
+    case TWIQ_NACK_DATA: twiq_stat.nack++; break;
+    case TWIQ_TIMEOUT:   twiq_stat.timeout++; break;
+    default:             twiq_stat.error++; break;
+  }
+  twiq_stat.latencySum += t->latency;
+  if (t->latency > twiq_stat.latencyMax) {
+    twiq_stat.latencyMax = t->latency;
+  }
+
+  twiq_act = (twiq_act + 1) % TWIQ_LENGTH;
+  if (!bus) {
+    return;                                       // bus is TWI_READY after the reset
+  }
+  if (twiq_act != twiq_put) {
+    twiq_begin(TWCR_GO | _BV(TWEA) | _BV(TWSTO) | _BV(TWSTA));   // STOP, then START
+  } else {
+    twi_stop();                                   // back to TWI_READY
+  }
+}
+
+/*
+ * Function twiq_isr
+ * Desc     master state machine, called by ISR(TWI_vect) in twi.c
+ *          while the state is TWI_MQX
+ * Input    status: TW_STATUS
+ * Output   none
+ */
+static void twiq_isr(uint8_t status)
+{
+  twiq_trans* t = twiq_ring[twiq_act];
+
+  switch(status){
+    case TW_START:
+    case TW_REP_START:
+      i2ctr_start(i2ctr_twi);
+      TWDR = (t->address << 1) | (twiq_reading ? TW_READ : TW_WRITE);
+      TWCR = TWCR_GO | _BV(TWEA);
+      break;
+
+    // write phase
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      i2ctr_write(i2ctr_twi, (TW_MT_SLA_ACK == status) ? t->address << 1 : 0, 1);
+      if (twiq_widx < t->wlen) {
+        TWDR = t->wbuf[twiq_widx++];
+        TWCR = TWCR_GO | _BV(TWEA);
+      } else if (t->rlen) {
+        twiq_reading = 1;
+        TWCR = TWCR_GO | _BV(TWSTA);              // repeated start
+      } else {
+        twiq_complete(TWIQ_DONE, 1);
+      }
+      break;
+    case TW_MT_SLA_NACK:
+    case TW_MR_SLA_NACK:
+      i2ctr_write(i2ctr_twi, (t->address << 1) | (twiq_reading ? TW_READ : TW_WRITE), 0);
+      twiq_complete(TWIQ_NACK_ADDR, 1);
+      break;
+    case TW_MT_DATA_NACK:
+      i2ctr_write(i2ctr_twi, 0, 0);
+      twiq_complete(TWIQ_NACK_DATA, 1);
+      break;
+
+    // read phase: ack all but the last byte
+    case TW_MR_DATA_ACK:
+      t->rbuf[twiq_ridx++] = TWDR;
+      i2ctr_read(i2ctr_twi);
+      __attribute__ ((fallthrough));
+    case TW_MR_SLA_ACK:
+      if (TW_MR_SLA_ACK == status) {
+        i2ctr_write(i2ctr_twi, (t->address << 1) | TW_READ, 1);
+      }
+      if (twiq_ridx + 1 < t->rlen) {
+        TWCR = TWCR_GO | _BV(TWEA);
+      } else {
+        TWCR = TWCR_GO;
+      }
+      break;
+    case TW_MR_DATA_NACK:
+      t->rbuf[twiq_ridx++] = TWDR;
+      i2ctr_read(i2ctr_twi);
+      twiq_complete(TWIQ_DONE, 1);
+      break;
+
+    case TW_MT_ARB_LOST:                          // also TW_MR_ARB_LOST
+      twiq_complete(TWIQ_ERROR, 0);
+      twi_releaseBus();
+      break;
+    case TW_BUS_ERROR:
+    default:
+      twiq_complete(TWIQ_ERROR, 0);
+      twi_stop();
+      break;
+  }
+}
+
+/*
+ * Function twiq_submit
+ * Desc     appends a prepared transaction to the queue and starts
+ *          the bus if it is idle
+ * Input    t: transaction (twiq_setup)
+ * Output   1 .. queued
+ *          0 .. queue full or t is still queued
+ */
+uint8_t twiq_submit(twiq_trans* t)
+{
+  uint8_t sreg, next;
+
+  if ((TWIQ_PENDING == t->status) || (TWIQ_BUSY == t->status)) {
+    return 0;
+  }
+  sreg = SREG;
+  cli();
+  next = (twiq_put + 1) % TWIQ_LENGTH;
+  if (next == twiq_done) {
+    SREG = sreg;
+    return 0;
+  }
+  t->status = TWIQ_PENDING;
+  t->queued = micros();
+  twiq_ring[twiq_put] = t;
+  twiq_put = next;
+  SREG = sreg;
+
+  twiq_poll();
+  return 1;
+}
+
+/*
+ * Function twiq_poll
+ * Desc     to be called from the main loop: runs the callbacks of
+ *          completed transactions, aborts a transaction that exceeds
+ *          the timeout and starts the bus if it became idle
+ * Input    none
+ * Output   none
+ */
+void twiq_poll(void)
+{
+  uint8_t sreg;
+  twiq_trans* t;
+
+  sreg = SREG;
+  cli();
+  if ((twiq_act != twiq_put) && (TWIQ_BUSY == twiq_ring[twiq_act]->status) &&
+      (twiq_timeout_us > 0ul) && ((micros() - twiq_busStart) > twiq_timeout_us)) {
+    twi_handleTimeout(true);                      // reset TWI, state TWI_READY
+    twiq_complete(TWIQ_TIMEOUT, 0);
+  }
+  if ((twiq_act != twiq_put) && (TWIQ_PENDING == twiq_ring[twiq_act]->status) && twi_acquireBus()) {
+    twiq_begin(TWCR_GO | _BV(TWEA) | _BV(TWSTA));
+  }
+  SREG = sreg;
+
+  while (twiq_done != twiq_act) {
+    t = twiq_ring[twiq_done];
+    twiq_done = (twiq_done + 1) % TWIQ_LENGTH;
+    if (t->callback) {
+      t->callback(t);
+    }
+  }
+}
+
+/*
+ * Function twiq_busy
+ * Desc     tells whether transactions are pending or on the bus
+ * Output   1 .. busy, 0 .. queue empty
+ */
+uint8_t twiq_busy(void)
+{
+  return (twiq_act != twiq_put);
+}
+
+/*
+ * Function twiq_setTimeoutInMicros
+ * Desc     maximum time a transaction may own the bus (0 = no timeout),
+ *          checked in twiq_poll()
+ * Input    timeout in microseconds
+ * Output   none
+ */
+void twiq_setTimeoutInMicros(uint32_t timeout)
+{
+  twiq_timeout_us = timeout;
+}
+
+/*
+ * Function twiq_clearStats
+ * Desc     resets the counters in twiq_stat
+ */
+void twiq_clearStats(void)
+{
+  uint8_t sreg = SREG;
+
+  cli();
+  twiq_stat.done = 0;
+  twiq_stat.nack = 0;
+  twiq_stat.timeout = 0;
+  twiq_stat.error = 0;
+  twiq_stat.latencyMax = 0;
+  twiq_stat.latencySum = 0;
+  SREG = sreg;
+}
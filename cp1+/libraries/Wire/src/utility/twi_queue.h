@@ -0,0 +1,92 @@
+/*
+  twi_queue.h - non-blocking I2C master transaction queue on the TWI
+
+  Transactions are prepared once (twiq_setup) and handed to the queue
+  (twiq_submit). The TWI interrupt runs them back to back, the main loop
+  calls twiq_poll() which runs the completion callbacks and handles
+  timeouts. The blocking twi_readFrom / twi_writeTo (Wire) wait while the
+  queue owns the bus.
+
+    #include <Wire.h>
+    #include <utility/twi_queue.h>
+
+    uint8_t    reg = 0, buf[7];
+    twiq_trans rtc;
+
+    twiq_init();
+    twiq_setup(&rtc, 0x68, &reg, 1, buf, 7, rtc_done);   // write, rep. start, read
+    twiq_submit(&rtc);
+    ...
+    loop: twiq_poll();
+
+  Kinds of transactions:
+    wlen > 0, rlen == 0  : write
+    wlen == 0, rlen > 0  : read
+    wlen > 0, rlen > 0   : write, repeated start, read
+    wlen == 0, rlen == 0 : address only (e.g. ack polling of a 24Cxx)
+*/
+
+#ifndef twi_queue_h
+#define twi_queue_h
+
+  #include <inttypes.h>
+
+  #ifdef __cplusplus
+  extern "C" {
+  #endif
+
+  #ifndef TWIQ_LENGTH
+  #define TWIQ_LENGTH 8                 // queue entries (one is kept free)
+  #endif
+
+  // twiq_trans.status
+  #define TWIQ_IDLE       0
+  #define TWIQ_PENDING    1             // queued
+  #define TWIQ_BUSY       2             // on the bus
+  #define TWIQ_DONE       3             // completed successfully
+  #define TWIQ_NACK_ADDR  4             // address sent, nack received
+  #define TWIQ_NACK_DATA  5             // data sent, nack received
+  #define TWIQ_ERROR      6             // bus error, arbitration lost
+  #define TWIQ_TIMEOUT    7
+
+  struct twiq_trans;
+  typedef void (*twiq_callback)(struct twiq_trans *);
+
+  typedef struct twiq_trans
+  {
+    uint8_t           address;          // 7 bit device address
+    uint8_t          *wbuf;
+    uint8_t           wlen;
+    uint8_t          *rbuf;
+    uint8_t           rlen;
+    twiq_callback     callback;         // called from twiq_poll(), may be 0
+    volatile uint8_t  status;
+    uint16_t          latency;          // us from twiq_submit to completion
+    uint32_t          queued;           // micros() at twiq_submit
+  } twiq_trans;
+
+  typedef struct
+  {
+    uint16_t done;                      // completed without error
+    uint16_t nack;                      // nack on address or data
+    uint16_t timeout;
+    uint16_t error;                     // bus error, arbitration lost
+    uint16_t latencyMax;                // us
+    uint32_t latencySum;                // us, all completed transactions
+  } twiq_stats;
+
+  extern volatile twiq_stats twiq_stat;
+
+  void twiq_init(void);
+  void twiq_setup(twiq_trans*, uint8_t, uint8_t*, uint8_t, uint8_t*, uint8_t, twiq_callback);
+  uint8_t twiq_submit(twiq_trans*);
+  void twiq_poll(void);
+  uint8_t twiq_busy(void);
+  void twiq_setTimeoutInMicros(uint32_t);
+  void twiq_clearStats(void);
+
+  #ifdef __cplusplus
+  }
+  #endif
+
+#endif
@@ -98,6 +98,9 @@ const uint8_t mnemset[mnemanz][13] PROGMEM =
   { "\x42"".org ?"}
 };
 
+// sortierter Index und Opcode-Tabelle zu mnemset
+#include "cp1_mnemidx.h"
+
 /* --------------------------------------------------
                       str_locase
 
@@ -130,7 +133,7 @@ void str_delch(uint8_t *str, uint8_t pos)
   uint8_t l,i;
   uint8_t *hptr;
 
-  l= strlen(str);
+  l= strlen((char *)str);
   hptr= str+pos;
   for (i= pos+1; i!= l+1; i++)
   {
@@ -180,11 +183,9 @@ uint8_t str_findch(uint8_t *str, uint8_t ch)
    -------------------------------------------------- */
 void str_delallch(uint8_t *str, uint8_t ch)
 {
-  uint8_t spos, slen;
-  uint8_t *hptr;
+  uint8_t spos;
   uint8_t cnt= 0;
 
-  hptr= str;
   spos= str_findch(str,ch);
   if (!spos) return;
   do
@@ -239,17 +240,11 @@ void str_replacech(uint8_t *str, uint8_t dest, uint8_t src)
    -------------------------------------------------- */
 void str_insert(uint8_t *dest, uint8_t *src, uint8_t pos)
 {
+  char buffer[20] = "";
 
-  uint8_t len, len2;
-
-  len= strlen(dest);
-  len2 = strlen(src);
-
-  uint8_t buffer[20] = "";
-
-  strcpy(buffer, dest+pos-1);
-  strcpy(dest + pos-1, src);
-  strcpy(dest + strlen(dest), buffer);
+  strcpy(buffer, (char *)dest+pos-1);
+  strcpy((char *)dest + pos-1, (char *)src);
+  strcpy((char *)dest + strlen((char *)dest), buffer);
   return;
 }
 
@@ -299,21 +294,21 @@ uint8_t str_split2asm(uint8_t *str, uint8_t *mnem, uint8_t *op1, uint8_t *op2)
   uint8_t *ptr;
   uint8_t manz = 0;
 
-  ptr = strtok(str, ",");
+  ptr = (uint8_t *)strtok((char *)str, ",");
 
   while (ptr)
   {
     manz++;
     switch (manz)
     {
-      case 1 : memcpy(mnem, ptr, strlen(ptr)+1); break;
-      case 2 : memcpy(op1, ptr, strlen(ptr)+1); break;
-      case 3 : memcpy(op2, ptr, strlen(ptr)+1); break;
+      case 1 : memcpy(mnem, ptr, strlen((char *)ptr)+1); break;
+      case 2 : memcpy(op1, ptr, strlen((char *)ptr)+1); break;
+      case 3 : memcpy(op2, ptr, strlen((char *)ptr)+1); break;
       default : break;
     }
     // Test ob strtok funktioniert wie gewuenscht
 //    if (ptr)  printf("%s\n\r", ptr);
-    ptr = strtok(NULL, ",");
+    ptr = (uint8_t *)strtok(NULL, ",");
   }
   return manz;
 }
@@ -343,7 +338,7 @@ uint8_t u8_atoi(uint8_t *src, uint8_t *atch, uint8_t *err)
 {
   uint16_t result;
   uint8_t *ptr;
-  uint8_t *hexmark = "0x";
+  const char *hexmark = "0x";
 
   result= 0;
   *atch= 0;
@@ -356,7 +351,7 @@ uint8_t u8_atoi(uint8_t *src, uint8_t *atch, uint8_t *err)
      src++;
   }
   if (*src == 0) { *err= 2; return 0; }
-  ptr = strstr(src, hexmark);
+  ptr = (uint8_t *)strstr((char *)src, hexmark);
   if (!(ptr== NULL))
   {
     // Zahlenstring hat Hexadezimalkennung
@@ -502,27 +497,27 @@ uint8_t mnem_getsearchstring(uint8_t *dest, uint8_t *src, uint8_t *error)
 
   op1[0]= 0; op2[0]= 0;
   opanz= str_split2asm(&src[0], &mnem[0], &op1[0], &op2[0]);  // zerlegt Assemblerbefehl in Bestandteile
-  strcpy(dest, mnem);
+  strcpy((char *)dest, (char *)mnem);
 
   // String wieder zusammen setzen
   if (opanz> 1)
   {
     data= u8_atoi(&op1[0], &atch, &err);
-    if (!err) strcpy(op1, "?");
-    if ((!err) && (atch)) strcpy(op1, "@?");
+    if (!err) strcpy((char *)op1, "?");
+    if ((!err) && (atch)) strcpy((char *)op1, "@?");
     if (err== 2) { *error= 2; return 0; }
-    strcat(dest, " ");
-    strcat(dest, op1);
+    strcat((char *)dest, " ");
+    strcat((char *)dest, (char *)op1);
   }
   if (opanz== 3)
   {
     data2= u8_atoi(&op2[0], &atch,  &err);
     if ((data> 0) && (data2> 0)) { *error= 3; return 0; }     // es koenen keine 2 Zahlenwerte angegeben sein
-    if (!err) strcpy(op2, "?");
-    if ((!err) && (atch)) strcpy(op2, "@?");
+    if (!err) strcpy((char *)op2, "?");
+    if ((!err) && (atch)) strcpy((char *)op2, "@?");
     if (err== 2) { *error= 2; return 0; }
-    strcat(dest, ",");
-    strcat(dest, op2);
+    strcat((char *)dest, ",");
+    strcat((char *)dest, (char *)op2);
   }
   if (data> 0) return data;
   if (data2> 0) return data2;
@@ -553,49 +548,40 @@ uint8_t mnem_getsearchstring(uint8_t *dest, uint8_t *src, uint8_t *error)
         5     : ungueltige Mnemonic
         6     : regulaerer Kommentar    
   -------------------------------------------------- */
-uint8_t assemble_line(uint8_t *src, uint16_t *prgword, kcomp *vcp1)
+uint8_t assemble_line(uint8_t *src, uint16_t *prgword, kcomp *)
 {
   uint8_t  mnemstr[15];
-  uint8_t  tmpstr[15];
-  uint8_t  *str;
   uint8_t  opc, data, err;
-  uint8_t  i, b, scan;
+  uint8_t  i, lo, hi, mid;
+  int      cmp;
 
   err= 0;
   data= mnem_getsearchstring(&mnemstr[0], src, &err);
   if (err) return err;
 
-  for (i= 0; i< mnemanz; i++)
+  // binaere Suche ueber die nach Mnemonic sortierte Liste (mnemsort)
+  lo= 0; hi= mnemanz;
+  while (lo < hi)
   {
-
-    // String aus PROGMEM in ein Array ins Ram umkopieren...
-    str= &tmpstr[0];
-    // ... und diesen String mit der Mnemonicliste vergleichen
-    scan= 0;
-    do
+    mid= (lo + hi) >> 1;
+    i= pgm_read_byte(&mnemsort[mid]);
+    cmp= strcmp_P((char *)mnemstr, (const char *)&mnemset[i][1]);
+    if (cmp < 0) { hi= mid; continue; }
+    if (cmp > 0) { lo= mid + 1; continue; }
+
+    opc= pgm_read_byte(&mnemset[i][0]);
+    if (opc== 255) opc= 0;
+    if (opc != 0x42)                    // .org
     {
-      b= pgm_read_byte(&mnemset[i][scan]);
-      *str= b;
-      str++;
-      scan++;
-    } while(b);
-
-    if ( (strstr(tmpstr, mnemstr)) && ((strlen(tmpstr)-1 == strlen(mnemstr))) )
+      *prgword= (opc*1000)+data;
+      return err;
+    }
+    else
     {
-      opc=tmpstr[0];
-      if (opc== 255) opc= 0;
-      if (opc != 0x42)                  // .org
-      {
-        *prgword= (opc*1000)+data;
-        return err;
-      }
-      else
-      {
-        err= 255;                       // als Kennung, dass prgword nur die zu
+      err= 255;                         // als Kennung, dass prgword nur die zu
                                         // setzende Addresse beinhaltet
-        *prgword= data;
-        return err;                                
-      }
+      *prgword= data;
+      return err;
     }
   }
   err= 5;
@@ -620,70 +606,62 @@ void disassemble_prgword(uint8_t *dest, uint16_t prgword)
   uint8_t  tmpstr[20];
   uint8_t  dezs[4];
   uint8_t  *str;
-  uint8_t  opc, data, err;
+  uint8_t  opc, data;
   uint8_t  i, b, scan;
 
   *dest= 0;
   opc= prgword >> 8; data= prgword & 0xff;
-  if (opc== 0) opc= 0xff;
-
-  for (i= 0; i< mnemanz; i++)
+  if (opc== 0xff) opc= 0;                       // Opcode 0xff wird wie ein Datum angezeigt
+  if (opc >= mnemopcanz) return;
+  i= pgm_read_byte(&mnemopc[opc]);              // Eintrag in mnemset zum Opcode
+  if (i== 0xff) return;
+
+  // String aus PROGMEM in ein Array ins Ram umkopieren
+  str= &tmpstr[0];
+  scan= 0;
+  do
   {
+    b= pgm_read_byte(&mnemset[i][scan]);
+    *str= b;
+    str++;
+    scan++;
+  } while(b);
 
-    // String aus PROGMEM in ein Array ins Ram umkopieren
-    str= &tmpstr[0];
-    scan= 0;
-    do
+  if ((opc> 15) && (opc< 19))             // Opcodes 16,17,18 gibt es jeweils 2 mal, je fuer
+                                          // Bit und Byteoperation
+  {
+    switch (opc)
     {
-      b= pgm_read_byte(&mnemset[i][scan]);
-      *str= b;
-      str++;
-      scan++;
-    } while(b);
+      case 16 :
+      {
+        if (data) strcpy((char *)tmpstr, "\x10""inb p1,?");
+             else strcpy((char *)tmpstr, "\x10""in p1");
+        break;
+      }
 
-    if (tmpstr[0]== opc)
-    {
-      if ((opc> 15) && (opc< 19))             // Opcodes 16,17,18 gibt es jeweils 2 mal, je fuer
-                                              // Bit und Byteoperation
+      case 17 :
       {
-        switch (opc)
-        {
-          case 16 :
-          {
-            if (data) strcpy(tmpstr, "\x10""inb p1,?");
-                 else strcpy(tmpstr, "\x10""in p1");
-            break;
-          }
-
-          case 17 :
-          {
-            if (data) strcpy(tmpstr, "\x11""outb p1,?");
-                 else strcpy(tmpstr, "\x11""out p1");
-            break;
-          }
-
-          case 18 :
-          {
-            if (data) strcpy(tmpstr, "\x12""outb p2,?");
-                 else strcpy(tmpstr, "\x12""out p2");
-            break;
-          }
-          default : break;
-        }
+        if (data) strcpy((char *)tmpstr, "\x11""outb p1,?");
+             else strcpy((char *)tmpstr, "\x11""out p1");
+        break;
       }
-//      puts_rom("   ");
-      str_delch(&tmpstr[0],0);
-      b= str_findch(&tmpstr[0],'?');
-      if (b)                                   // Datum einfuegen ?
+
+      case 18 :
       {
-        u8toa(&dezs[0], data);
-        str_insert(&tmpstr[0], &dezs[0], b);
-        str_delch(&tmpstr[0], b+2);
+        if (data) strcpy((char *)tmpstr, "\x12""outb p2,?");
+             else strcpy((char *)tmpstr, "\x12""out p2");
+        break;
       }
-//      puts_ram(&tmpstr[0]);
-      strcpy(dest, tmpstr);
-      i= mnemanz;                              // Suche abbrechen, da gefunden
+      default : break;
     }
   }
+  str_delch(&tmpstr[0],0);
+  b= str_findch(&tmpstr[0],'?');
+  if (b)                                   // Datum einfuegen ?
+  {
+    u8toa(&dezs[0], data);
+    str_insert(&tmpstr[0], &dezs[0], b);
+    str_delch(&tmpstr[0], b+2);
+  }
+  strcpy((char *)dest, (char *)tmpstr);
 }
-
@@ -0,0 +1,109 @@
+/* --------------------------------------------------------
+                       cp1_blkload.cpp
+
+     Blockweises Laden eines Programms mit CRC16 und
+     Quittung je Block (Protokoll siehe cp1_blkload.h)
+
+     Ein Block wird zwischengespeichert und erst nach
+     korrekter CRC in den Programmspeicher uebernommen, ein
+     gestoerter Blockkopf kann also keine anderen Bereiche
+     ueberschreiben. Die Anzeige wird nur einmal je Block
+     aktualisiert.
+
+     MCU: ATmega328p / Linux-Host
+
+     R. Seelig
+   -------------------------------------------------------- */
+
+#include "kosmos_cp1_v43.h"
+
+/* --------------------------------------------------
+                       blk_getc
+
+     wartet max. blk_timeout ms auf ein Zeichen
+
+     Rueckgabe: 1 = Zeichen in *ch, 0 = Timeout
+  -------------------------------------------------- */
+static uint8_t blk_getc(uint8_t *ch)
+{
+  uint16_t t;
+
+  for (t= 0; t< (blk_timeout * 50); t++)
+  {
+    if (uart_ischar())
+    {
+      *ch= uart_getchar();
+      return 1;
+    }
+    _delay_us(20);
+  }
+  return 0;
+}
+
+/* --------------------------------------------------
+                      blk_receive
+
+     empfaengt Bloecke bis EOT, CAN oder STP
+
+     Rueckgabe:
+       0x00 : Uebertragung vollstaendig
+       0x01 : Abbruch durch den Host
+       0x82 : STP wurde aktiviert
+  -------------------------------------------------- */
+uint8_t blk_receive(kcomp *vcp1)
+{
+  uint16_t buf[blk_maxwords];
+  uint8_t  ch, adr, n, i, lby, hby, ok;
+  uint16_t crc;
+
+  while (1)
+  {
+    // Blockanfang, alle anderen Zeichen werden verworfen
+    do
+    {
+      ch= 0;
+      if (uart_ischar()) ch= uart_getchar();
+      else
+      if (hal_readkey() == 0x82) return 0x82;
+    } while ((ch != blk_stx) && (ch != blk_eot) && (ch != blk_can));
+
+    if (ch != blk_stx)
+    {
+      if (ch == blk_can) return 1;
+      uart_putchar(blk_ack);
+      return 0;
+    }
+
+    ok= blk_getc(&adr) && blk_getc(&n);
+    ok= ok && (n > 0) && (n <= blk_maxwords) && ((uint16_t)adr + n <= memsize);
+    crc= 0;
+    if (ok)
+    {
+      crc= _crc_xmodem_update(crc, adr);
+      crc= _crc_xmodem_update(crc, n);
+    }
+    for (i= 0; ok && (i< n); i++)
+    {
+      ok= blk_getc(&lby) && blk_getc(&hby);
+      if (!ok) break;
+      crc= _crc_xmodem_update(crc, lby);
+      crc= _crc_xmodem_update(crc, hby);
+      buf[i]= (uint16_t)(hby << 8) | lby;
+    }
+    ok= ok && blk_getc(&lby) && blk_getc(&hby) && (crc == ((uint16_t)(hby << 8) | lby));
+
+    if (!ok)
+    {
+      while (blk_getc(&ch));                   // Rest des Blocks abwarten
+      uart_putchar(blk_nak);
+      continue;
+    }
+    for (i= 0; i< n; i++)
+    {
+      vcp1->mem[(uint8_t)(adr + i)]= buf[i];
+      cpu_invalidate(vcp1, adr + i);             // nur geaenderte Bereiche gelten als geaendert
+    }
+    hal_showacc(adr);
+    uart_putchar(blk_ack);
+  }
+}
@@ -0,0 +1,50 @@
+/* ------------------------------------------------------------------
+                            cp1_blkload.h
+
+     Header zum blockweisen Laden eines Programms ueber den UART
+     (Festprogramm 5, program_download)
+
+     Nach der Anmeldung 'B' (Antwort 'b') sendet der Host beliebig
+     viele Bloecke, jeder Block wird einzeln quittiert:
+
+       STX  adr  n  lo0 hi0 .. lo(n-1) hi(n-1)  crc_lo crc_hi
+
+         adr : Adresse des ersten Programmworts
+         n   : Anzahl Programmworte, 1 .. blk_maxwords
+         crc : CRC16 (XMODEM, Polynom 0x1021, Startwert 0) ueber
+               adr, n und die Datenbytes
+
+       Antwort ACK : Block uebernommen
+               NAK : CRC-Fehler, ungueltiger Block oder Timeout,
+                     der Host wiederholt den Block
+
+       EOT          Uebertragung beendet, Antwort ACK
+       CAN          Abbruch durch den Host (keine Antwort)
+
+     Es muessen nicht alle 256 Worte uebertragen werden, nicht
+     gesendete Bereiche bleiben unveraendert (nur geaenderte
+     Bereiche hochladen). Das alte Protokoll ('U', ein 'o' je
+     Wort) bleibt erhalten.
+
+     Linux-Gegenstelle: host/cp1_upload
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_blkload
+  #define in_cp1_blkload
+
+  #define  blk_stx            0x02
+  #define  blk_eot            0x04
+  #define  blk_ack            0x06
+  #define  blk_nak            0x15
+  #define  blk_can            0x18
+
+  #define  blk_maxwords       64     // max. Programmworte je Block
+  #define  blk_timeout        100    // Timeout in ms zwischen zwei Zeichen eines Blocks
+
+  uint8_t blk_receive(kcomp *vcp1);
+
+#endif
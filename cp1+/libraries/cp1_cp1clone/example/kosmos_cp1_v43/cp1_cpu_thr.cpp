@@ -0,0 +1,584 @@
+/* --------------------------------------------------------
+                       cp1_cpu_thr.cpp
+
+     die virtuelle CPU des Kosmos-CP1, Interpreter mit
+     Sprungtabelle (threaded dispatch)
+
+     Anstelle der zentralen switch-Anweisung von cpu_run
+     (cp1_cpu_v43.cpp) wird jeder Opcode ueber eine Tabelle
+     mit den Adressen der Befehlsroutinen angesprungen
+     (GCC: "labels as values"). Da der Opcode bereits beim
+     Holen des Befehls geprueft ist, entfallen Bereichspruef-
+     ung und Sprungverteiler des switch.
+
+       AVR  : Tabelle liegt im Flash (PROGMEM), alle Befehls-
+              routinen springen zu einer gemeinsamen Tastatur-
+              abfrage mit anschliessendem Verteiler zurueck
+              (spart Flash)
+       Host : Tabelle im RAM, jede Befehlsroutine besitzt
+              ihren eigenen Verteiler
+
+     Die Befehlsroutinen muessen exakt dasselbe Ergebnis
+     (Register, psw, sp, err) liefern wie die Gegenstuecke in
+     cpu_run. Geprueft wird das auf dem Host mit
+     ./host/cp1_diff (make check), das beide Varianten im
+     Gleichschritt ausfuehrt.
+
+     cpu_run_thr ersetzt cpu_run bei cpu_threaded == 1, auf
+     dem Host wird es immer uebersetzt. Bei cpu_sched == 1
+     laeuft cpu_step_n ueber cpu_step_thr ebenfalls mit der
+     Sprungtabelle.
+
+     MCU: ATmega / Linux-Host
+
+     R. Seelig
+   ----------------------------------------------- */
+
+#include "kosmos_cp1_v43.h"
+
+#if (cpu_threaded == 1) || !defined(__AVR__)
+
+#if defined(__AVR__)
+  #define thr_tabmem                    PROGMEM
+  #define thr_handler(opc)              ((void *)pgm_read_word(&thr_tab[opc]))
+#else
+  #define thr_tabmem
+  #define thr_handler(opc)              (thr_tab[opc])
+#endif
+
+// Befehl an vcp1->pc holen, pruefen und dessen Befehlsroutine anspringen
+#define thr_dispatch                                                            \
+{                                                                               \
+  pc= vcp1->pc;                                                                 \
+  memw= vcp1->mem[pc];                                                          \
+  opc= memw >> 8;                                                               \
+  data= memw & 0xff;                                                            \
+  if ((uint8_t)(opc - 1) >= opcmax) { err= opc ? 4 : 2; return; }               \
+  prof_count(opc, pc);                                                          \
+  goto *thr_handler(opc);                                                       \
+}
+
+// Zeitscheibe (cpu_step_n): Befehle zaehlen statt die Tastatur abzufragen
+#if (cpu_sched == 1)
+  #define thr_slice                                                             \
+  if (budget)                                                                   \
+  {                                                                             \
+    if (cpu_slicestate== cpu_sleep) return;       /* cdel, int 1 */             \
+    if (!--budget) { cpu_slicestate= cpu_busy; return; }                        \
+    thr_dispatch;                                                               \
+  }
+#else
+  #define thr_slice
+#endif
+
+// Abschluss eines Befehls: Tastaturabfrage (STP), dann naechster Befehl
+#if defined(__AVR__)
+  #define thr_next                      goto thr_readkey
+#else
+  #define thr_next                                                              \
+  {                                                                             \
+    thr_slice;                                                                  \
+    key= hal_readkey();                                                         \
+    if ((stepmode) || (key== 0x82)) goto thr_exit;                              \
+    thr_dispatch;                                                               \
+  }
+#endif
+
+/*  ---------------------------------------------------------
+                           cpu_exec_thr
+
+      wie cpu_exec, arbeitet den Programmspeicher ab, bis
+      eine HLT Anweisung auftritt, oder das Programm mittels
+      der STP Taste angehalten wird.
+
+      Uebergabe:
+        stepmode == 1 : Einzelschrittabarbeitung
+                    0 : Kontinuierlich
+
+        *vcp1    :  Zeiger auf Zustand Gesamtsystem
+
+        budget   :  0 : Tastaturabfrage nach jedem Befehl
+                   >0 : Zeitscheibe (cpu_step_thr), wie bei
+                        cpu_exec
+    --------------------------------------------------------- */
+static void cpu_exec_thr(kcomp *vcp1, uint8_t stepmode, uint16_t budget)
+{
+  static const void * const thr_tab[opcmax+1] thr_tabmem =
+  {
+    &&op_undef,                                                   //  0 (wird nie angesprungen)
+    &&op_hlt,   &&op_cdis,  &&op_cdel,  &&op_mvia,  &&op_lda,     //  1 ..  5
+    &&op_abs,   &&op_add,   &&op_sub,   &&op_jmp,   &&op_cmpe,    //  6 .. 10
+    &&op_jz,    &&op_cmpg,  &&op_cmpl,  &&op_notb,  &&op_andb,    // 11 .. 15
+    &&op_inp1,  &&op_outp1, &&op_outp2, &&op_lia,   &&op_ais,     // 16 .. 20
+    &&op_jmpi,  &&op_undef, &&op_undef, &&op_undef, &&op_djnz,    // 21 .. 25
+    &&op_inc,   &&op_dec,   &&op_mvib,  &&op_mvic,  &&op_mvid,    // 26 .. 30
+    &&op_mvie,  &&op_movab, &&op_movac, &&op_movad, &&op_movae,   // 31 .. 35
+    &&op_movba, &&op_movca, &&op_movda, &&op_movea, &&op_movbc,   // 36 .. 40
+    &&op_movbd, &&op_movbe, &&op_movcb, &&op_movcd, &&op_movce,   // 41 .. 45
+    &&op_not,   &&op_xor,   &&op_xri,   &&op_cpi,   &&op_cmp,     // 46 .. 50
+    &&op_jpl,   &&op_jpg,   &&op_jc,    &&op_slc,   &&op_src,     // 51 .. 55
+    &&op_and,   &&op_ani,   &&op_or,    &&op_ori,   &&op_adi,     // 56 .. 60
+    &&op_sbi,   &&op_mul,   &&op_int,   &&op_call,  &&op_ret      // 61 .. 65
+  };
+
+  uint16_t memw;
+  int      data, akku, opc, pc;
+  uint8_t  key;
+
+  #if (cpu_sched == 1)
+    if (budget) cpu_slicestate= cpu_halt;
+  #else
+    (void)budget;
+  #endif
+
+  hal_showmask(0x07);
+  key= 0;
+  thr_dispatch;
+
+  // nicht belegte Opcodes (22..24): wie im switch ohne Wirkung
+  op_undef:
+    thr_next;
+
+  // HLT (hlt)
+  op_hlt:
+    vcp1->pc++;
+    err= 0;
+    return;
+
+  // ANZ (cdis : call display)
+  op_cdis:
+    hal_showmask(0x07);
+    #if (cpu_sched == 1)
+      if (budget)
+      {
+        cpu_dispval= vcp1->a;
+        cpu_dispreq= 1;
+        vcp1->pc++;
+        thr_next;
+      }
+    #endif
+    hal_showacc(vcp1->a);
+    vcp1->pc++;
+    thr_next;
+
+  // VZG (cdel : call delay)
+  op_cdel:
+    #if (cpu_sched == 1)
+      if (budget)
+      {
+        prof_sleep_ms(data);
+        vcp1->pc++;
+        thr_next;
+      }
+    #endif
+    key= prof_delay(data);
+    vcp1->pc++;
+    if (key== 0x82) { err= 255; return; }
+    thr_next;
+
+  // AKO (mvi a,const)
+  op_mvia:
+    vcp1->a= data;
+    vcp1->pc++;
+    thr_next;
+
+  // LDA (mov a,mem)
+  op_lda:
+    vcp1->a= vcp1->mem[data];
+    vcp1->pc++;
+    thr_next;
+
+  // ABS (mov mem,a)
+  op_abs:
+    vcp1->mem[data]= vcp1->a;
+    cpu_invalidate(vcp1, data);
+    vcp1->pc++;
+    thr_next;
+
+  // ADD (add a,mem), Ueberlauf setzt Carry
+  op_add:
+    vcp1->psw &= 0xfc;
+    akku= vcp1->a;
+    akku += vcp1->mem[data];
+    if (akku > 255) vcp1->psw |= 0x02;
+    if (vcp1->mem[data] & 0xff00) { err= 5; return; }
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // SUB (sub a,mem), Unterlauf setzt Carry
+  op_sub:
+    vcp1->psw &= 0xfc;
+    akku= vcp1->a;
+    akku -= vcp1->mem[data];
+    if (akku < 0) vcp1->psw |= 0x02;
+    if (vcp1->mem[data] & 0xff00) { err= 5; return; }
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // SPU (jmp addr)
+  op_jmp:
+    vcp1->psw= 0;
+    vcp1->pc= data;
+    thr_next;
+
+  // VGL (cmpe a,mem :  compare equal)
+  op_cmpe:
+    vcp1->psw &= 0xfe;
+    if (vcp1->a== vcp1->mem[data]) vcp1->psw |= 1;
+    vcp1->pc++;
+    thr_next;
+
+  // SPB (jz addr)
+  op_jz:
+    if (vcp1->psw & 0x01) vcp1->pc= data; else vcp1->pc++;
+    vcp1->psw= 0;
+    thr_next;
+
+  // VGR (cmpg a,mem : compare greater)
+  op_cmpg:
+    vcp1->psw &= 0xfe;
+    if (vcp1->a > vcp1->mem[data]) vcp1->psw |= 0x01;
+    vcp1->pc++;
+    thr_next;
+
+  // VKL (cmpl a,mem :  compare less)
+  op_cmpl:
+    vcp1->psw &= 0xfe;
+    if (vcp1->a < vcp1->mem[data]) vcp1->psw |= 0x01;
+    vcp1->pc++;
+    thr_next;
+
+  // NEG (notb a : invert Bit0 accu)
+  op_notb:
+    akku= ~((vcp1->a) & 0x01);
+    vcp1->a= akku & 0x01;
+    vcp1->pc++;
+    thr_next;
+
+  // UND (andb a,mem : and bit0 with mem)
+  op_andb:
+    data= vcp1->mem[data] & 0x01;
+    vcp1->a= (vcp1->a & 0x01) & data;
+    vcp1->pc++;
+    thr_next;
+
+  // P1E (in p1 / inb p1 : read bit or byte from Port1)
+  op_inp1:
+    if (data > 8) { err= 5; return; }
+    if (data)
+    {
+      if (hal_p1_bitread(data-1)) vcp1->a= 1; else vcp1->a= 0;
+    }
+    else
+    {
+      vcp1->a= (hal_p1_byteread());
+    }
+    vcp1->pc++;
+    thr_next;
+
+  // P1A (out p1 / outb p1 : outputs a bit or a byte to Port1)
+  op_outp1:
+    if (data > 8) { err= 5; return; }
+    if (data)
+    {
+      hal_p1_bitwrite(data-1, vcp1->a & 0x01);
+    }
+    else
+    {
+      hal_p1_bytewrite(vcp1->a);
+    }
+    vcp1->pc++;
+    thr_next;
+
+  // P2A (out p2 / outb p2 : outputs a bit or a byte to Port2)
+  op_outp2:
+    if (data > 8) { err= 5; return; }
+    if (data)
+    {
+      hal_p2_bitwrite(data-1, vcp1->a & 0x01);
+    }
+    else
+    {
+      hal_p2_bytewrite(vcp1->a);
+    }
+    vcp1->pc++;
+    thr_next;
+
+  // LIA (mov a,@mem) load indirect
+  op_lia:
+    data= vcp1->mem[data];
+    if (data> memsize-1) { err= 3; return; }
+    data= vcp1->mem[data];
+    if (data> 255) { err= 6; return; }
+    vcp1->a= data;
+    vcp1->pc++;
+    thr_next;
+
+  // AIS (mov @mem,a) store indirect
+  op_ais:
+    data= vcp1->mem[data];
+    if (data> memsize-1) { err= 3; return; }
+    vcp1->mem[data]= vcp1->a;
+    cpu_invalidate(vcp1, data);
+    vcp1->pc++;
+    thr_next;
+
+  // SIU (jmp @mem) jump indirect
+  op_jmpi:
+    data= vcp1->mem[data];
+    if (data> memsize-1) { err= 3; return; }
+    vcp1->pc= data;
+    thr_next;
+
+  // djnz a,mem
+  op_djnz:
+    vcp1->a--;
+    if (vcp1->a) vcp1->pc= data; else vcp1->pc++;
+    thr_next;
+
+  // inc a
+  op_inc:
+    vcp1->psw &= ~(0x02);
+    if ((vcp1->a) == 255) { vcp1->psw |= 0x02; }
+    vcp1->a++;
+    vcp1->pc++;
+    thr_next;
+
+  // dec a
+  op_dec:
+    vcp1->psw &= ~(0x02);
+    if ((vcp1->a) == 0) { vcp1->psw |= 0x02; }
+    vcp1->a--;
+    vcp1->pc++;
+    thr_next;
+
+  // mvi b..e, const
+  op_mvib: vcp1->b= data; vcp1->pc++; thr_next;
+  op_mvic: vcp1->c= data; vcp1->pc++; thr_next;
+  op_mvid: vcp1->d= data; vcp1->pc++; thr_next;
+  op_mvie: vcp1->e= data; vcp1->pc++; thr_next;
+
+  // mov a, b..e
+  op_movab: vcp1->a= vcp1->b; vcp1->pc++; thr_next;
+  op_movac: vcp1->a= vcp1->c; vcp1->pc++; thr_next;
+  op_movad: vcp1->a= vcp1->d; vcp1->pc++; thr_next;
+  op_movae: vcp1->a= vcp1->e; vcp1->pc++; thr_next;
+
+  // mov b..e, a
+  op_movba: vcp1->b= vcp1->a; vcp1->pc++; thr_next;
+  op_movca: vcp1->c= vcp1->a; vcp1->pc++; thr_next;
+  op_movda: vcp1->d= vcp1->a; vcp1->pc++; thr_next;
+  op_movea: vcp1->e= vcp1->a; vcp1->pc++; thr_next;
+
+  // mov b, c..e
+  op_movbc: vcp1->b= vcp1->c; vcp1->pc++; thr_next;
+  op_movbd: vcp1->b= vcp1->d; vcp1->pc++; thr_next;
+  op_movbe: vcp1->b= vcp1->e; vcp1->pc++; thr_next;
+
+  // mov c, b / d / e
+  op_movcb: vcp1->c= vcp1->b; vcp1->pc++; thr_next;
+  op_movcd: vcp1->c= vcp1->d; vcp1->pc++; thr_next;
+  op_movce: vcp1->c= vcp1->e; vcp1->pc++; thr_next;
+
+  // not a
+  op_not:
+    vcp1->a= ~(vcp1->a);
+    vcp1->pc++;
+    thr_next;
+
+  // xor a,mem
+  op_xor:
+    vcp1->a ^= vcp1->mem[data];
+    vcp1->pc++;
+    thr_next;
+
+  // xri a,const
+  op_xri:
+    vcp1->a ^= data;
+    vcp1->pc++;
+    thr_next;
+
+  // cpi a,const
+  op_cpi:
+    vcp1->psw &= 0xf0;
+    if (vcp1->a == data) vcp1->psw |= 0x01;
+    if (vcp1->a < data) vcp1->psw |= 0x04;
+    if (vcp1->a > data) vcp1->psw |= 0x08;
+    vcp1->pc++;
+    thr_next;
+
+  // cmp a,mem : compare akku with memory
+  op_cmp:
+    vcp1->psw &= 0xf0;
+    if (vcp1->a == vcp1->mem[data]) vcp1->psw |= 0x01;
+    if (vcp1->a < vcp1->mem[data]) vcp1->psw |= 0x04;
+    if (vcp1->a > vcp1->mem[data]) vcp1->psw |= 0x08;
+    vcp1->pc++;
+    thr_next;
+
+  // jpl addr : jump less
+  op_jpl:
+    if (vcp1->psw & 0x04) vcp1->pc= data; else vcp1->pc++;
+    vcp1->psw= 0;
+    thr_next;
+
+  // jpg addr : jump greater
+  op_jpg:
+    if (vcp1->psw & 0x08) vcp1->pc= data; else vcp1->pc++;
+    vcp1->psw= 0;
+    thr_next;
+
+  // jc addr : jump carry
+  op_jc:
+    if (vcp1->psw & 0x02) vcp1->pc= data; else vcp1->pc++;
+    vcp1->psw= 0;
+    thr_next;
+
+  // slc a : shift left through carry
+  op_slc:
+    vcp1->psw &= ~(0x02);
+    akku= vcp1->a;
+    if (akku & 0x80) vcp1->psw |= 0x02;
+    vcp1->a= akku << 1;
+    vcp1->pc++;
+    thr_next;
+
+  // src a : shift right through carry
+  op_src:
+    vcp1->psw &= ~(0x02);
+    akku= vcp1->a;
+    if (akku & 0x01) vcp1->psw |= 0x02;
+    vcp1->a= akku >> 1;
+    vcp1->pc++;
+    thr_next;
+
+  // and a,mem
+  op_and:
+    vcp1->psw &= 0xfe;
+    akku= vcp1->a;
+    akku &= vcp1->mem[data];
+    if (vcp1->mem[data] & 0xff00) { err= 5; return; }
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // ani a,const (ein Datum ist immer <= 255, keine Pruefung noetig)
+  op_ani:
+    vcp1->psw &= 0xfe;
+    vcp1->a &= data;
+    vcp1->pc++;
+    thr_next;
+
+  // or a,mem
+  op_or:
+    vcp1->psw &= 0xfe;
+    akku= vcp1->a;
+    akku |= vcp1->mem[data];
+    if (vcp1->mem[data] & 0xff00) { err= 5; return; }
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // ori a,const
+  op_ori:
+    vcp1->psw &= 0xfe;
+    vcp1->a |= data;
+    vcp1->pc++;
+    thr_next;
+
+  // adi a,const
+  op_adi:
+    vcp1->psw &= 0xfc;
+    akku= vcp1->a;
+    akku += data;
+    if (akku > 255) vcp1->psw |= 0x02;
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // sbi a,const
+  op_sbi:
+    vcp1->psw &= 0xfc;
+    akku= vcp1->a;
+    akku -= data;
+    if (akku < 0) vcp1->psw |= 0x02;
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // mul a,b
+  op_mul:
+    vcp1->psw &= 0xfc;
+    akku= vcp1->a;
+    akku= akku * vcp1->b;
+    if (akku > 255) vcp1->psw |= 0x02;
+    vcp1->pc++;
+    vcp1->a= akku;
+    thr_next;
+
+  // int const: software interrupt
+  op_int:
+    #if (cpu_sched == 1)
+      // Softwareinterrupts schreiben selbst in die Anzeige
+      if (budget && cpu_dispreq) { hal_showacc(cpu_dispval); cpu_dispreq= 0; }
+    #endif
+    key= prof_intr(vcp1, data);
+    vcp1->pc++;
+    if (key== 0x82) { err= 255; return; }
+    if (err) return;
+    thr_next;
+
+  // call addr
+  op_call:
+    vcp1->stack[vcp1->sp]= vcp1->pc + 1;
+    vcp1->sp--;
+    if ((vcp1->sp) < 0) { err= 10; return; }
+    vcp1->pc= data;
+    thr_next;
+
+  // ret
+  op_ret:
+    if ((vcp1->sp) == 7) { err= 11; return; }
+    vcp1->sp++;
+    vcp1->pc= vcp1->stack[vcp1->sp];
+    thr_next;
+
+#if defined(__AVR__)
+  thr_readkey:
+    thr_slice;
+    key= hal_readkey();
+    if (!(stepmode) && (key != 0x82)) thr_dispatch;
+#endif
+
+  thr_exit:
+    if (key== 0x82) err= 255;                 // Programm wurde mit STP-Taste beendet
+}
+
+/*  ---------------------------------------------------------
+                           cpu_run_thr
+
+      wie cpu_run, mit der Sprungtabelle
+    --------------------------------------------------------- */
+void cpu_run_thr(kcomp *vcp1, uint8_t stepmode)
+{
+  cpu_exec_thr(vcp1, stepmode, 0);
+}
+
+#if (cpu_sched == 1)
+
+/*  ---------------------------------------------------------
+                           cpu_step_thr
+
+      Zeitscheibe zu budget Befehlen mit der Sprungtabelle
+      (fuer cpu_step_n)
+    --------------------------------------------------------- */
+void cpu_step_thr(kcomp *vcp1, uint16_t budget)
+{
+  cpu_exec_thr(vcp1, 0, budget);
+}
+
+#endif
+
+#endif
@@ -10,6 +10,38 @@
 
 #include "kosmos_cp1_v43.h"
 
+// Schreibzugriff auf adr fuer Watchpoints pruefen (nur in cpu_exec<1>)
+#if (cpu_debug == 1)
+  #define dbg_watch(adr)                                                        \
+  {                                                                             \
+    if (dbgmode && dbg_checkwp(adr)) { stop= dbg_hitwp; dbg.hitadr= (adr); }    \
+  }
+#else
+  #define dbg_watch(adr)
+#endif
+
+#if (cpu_sched == 1)
+  uint8_t  cpu_slicestate= cpu_halt;      // Zustand nach der letzten Zeitscheibe
+  uint8_t  cpu_sliced= 0;                 // 1: cpu_step_n laeuft (fuer softw_intr)
+  uint32_t cpu_wake;                      // Weckzeit (hal_millis) bei cpu_sleep
+  uint8_t  cpu_dispval;                   // zurueckgestellte Anzeige (cdis)
+  uint8_t  cpu_dispreq= 0;
+
+/*  ---------------------------------------------------------
+                           cpu_sleep_ms
+
+      versetzt das laufende Programm fuer ms Millisekunden
+      in den Zustand cpu_sleep. cpu_step_n kehrt danach
+      sofort zurueck und setzt die Ausfuehrung erst nach
+      Ablauf der Weckzeit fort.
+    --------------------------------------------------------- */
+void cpu_sleep_ms(uint32_t ms)
+{
+  cpu_wake= hal_millis() + ms;
+  cpu_slicestate= cpu_sleep;
+}
+#endif
+
 
 /*  ---------------------------------------------------------
                              cpu_reset
@@ -32,10 +64,13 @@ void cpu_reset(kcomp *vcp1)
 
   for (i= 0; i< memsize; i++)
     vcp1->mem[i]= 0;
+  cpu_invalidate_all(vcp1);
 }
 
+#if (cpu_threaded == 0) || (cpu_debug == 1)
+
 /*  ---------------------------------------------------------
-                             cpu_run
+                             cpu_exec
 
       arbeitet den Programmspeicher ab, solange, bis eine
       HLT Anweisung auftritt, oder das Programm mittels
@@ -46,27 +81,74 @@ void cpu_reset(kcomp *vcp1)
                     0 : Kontinuierlich
 
         *vcp1    :  Zeiger auf Zustand Gesamtsystem
+
+        budget   :  0 : Tastaturabfrage nach jedem Befehl
+                   >0 : Zeitscheibe (cpu_step_n), nach budget
+                        Befehlen zurueck mit cpu_busy. Ohne
+                        Tastaturabfrage, cdel schlaeft (cpu_sleep),
+                        cdis wird zurueckgestellt (cpu_dispreq)
+
+      dbgmode == 1 : zusaetzlich Haltepunkte, Watchpoints und
+                     Haltebedingungen pruefen (cp1_debug.h).
+                     Bei dbgmode == 0 entfallen die Pruefungen
+                     bereits beim Uebersetzen.
     --------------------------------------------------------- */
-void cpu_run(kcomp *vcp1, uint8_t stepmode)
+template <uint8_t dbgmode>
+static void cpu_exec(kcomp *vcp1, uint8_t stepmode, uint16_t budget)
 {
-  uint8_t  i;
   uint16_t memw;
   int      data, akku, opc, pc;
-  uint8_t  flag;
   uint8_t  key;
+  #if (cpu_debug == 1)
+    uint8_t  first, stop, dbgpc;
+
+    first= 1;
+  #endif
+  #if (cpu_sched == 1)
+    if (budget)
+    {
+      #if (cpu_debug == 1)
+        // Fortsetzung nach cpu_busy / cpu_sleep: Haltepunkt auch am ersten Befehl
+        if (cpu_slicestate != cpu_halt) first= 0;
+      #endif
+      cpu_slicestate= cpu_halt;
+    }
+  #else
+    (void) budget;                                    // Zeitscheiben nur bei cpu_sched == 1
+  #endif
 
-  showmask= 0x07;
+  hal_showmask(0x07);
   key= 0;
   do
   {
     pc= vcp1->pc;
-    if (pc> (memsize-1)) { err= 3; return; }
+    #if (cpu_debug == 1)
+      if (dbgmode)
+      {
+        // am Haltepunkt, von dem aus gestartet wurde, nicht erneut anhalten
+        if (!first && dbg_checkbp(pc))
+        {
+          dbg.hit= dbg_hitbp;
+          dbg.hitpc= pc;
+          err= dbg_errstop;
+          return;
+        }
+        first= 0; stop= 0; dbgpc= pc;
+      }
+    #endif
+    // pc ist 8 Bit breit und liegt immer im Speicher. Das Programmwort
+    // enthaelt Opcode (High-Byte) und Datum (Low-Byte) schon getrennt, ein
+    // Vergleich prueft auf 1..opcmax, danach braucht der switch keine
+    // Bereichspruefung
     memw= vcp1->mem[pc];
     opc= memw >> 8;
     data= memw & 0xff;
-    if (data> 255) { err= 4; return; }
-    if (opc> opcmax) { err= 4; return; }
-    if (opc== 0) { err= 2; return; }     // ein Datum ist kein Code und kann nicht ausgefuehrt werden
+    if ((uint8_t)(opc - 1) >= opcmax)
+    {
+      err= opc ? 4 : 2;                    // ein Datum ist kein Code und kann nicht ausgefuehrt werden
+      return;
+    }
+    prof_count(opc, pc);
 
     switch (opc)
     {
@@ -83,8 +165,17 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
       // ANZ (cdis : call display)
       case 2 :
       {
-        showmask= 0x07;
-        setdez(vcp1->a,0);
+        hal_showmask(0x07);
+        #if (cpu_sched == 1)
+          if (budget)
+          {
+            cpu_dispval= vcp1->a;
+            cpu_dispreq= 1;
+            vcp1->pc++;
+            break;
+          }
+        #endif
+        hal_showacc(vcp1->a);
         vcp1->pc++;
         break;
       }
@@ -92,7 +183,15 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
       // VZG (cdel : call delay)
       case 3 :
       {
-        key= cp1_delay(data);
+        #if (cpu_sched == 1)
+          if (budget)
+          {
+            prof_sleep_ms(data);
+            vcp1->pc++;
+            break;
+          }
+        #endif
+        key= prof_delay(data);
         vcp1->pc++;
         if (key== 0x82)
         {
@@ -123,6 +222,8 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
       case 6 :
       {
         vcp1->mem[data]= vcp1->a;
+        cpu_invalidate(vcp1, data);
+        dbg_watch(data);
         vcp1->pc++;
         break;
       }
@@ -242,11 +343,11 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
         if (data)                            // einzelnes Bit des Port1 lesen
         {
           // Zaehlung Klemmennummer beginnt mit 1
-          if (p1_bitread(data-1)) vcp1->a= 1; else vcp1->a= 0;
+          if (hal_p1_bitread(data-1)) vcp1->a= 1; else vcp1->a= 0;
         }
         else
         {
-          vcp1->a= (p1_byteread());
+          vcp1->a= (hal_p1_byteread());
         }
         vcp1->pc++;
         break;
@@ -258,12 +359,11 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
         if (data > 8) { err= 5; return; }       // es gibt keine Klemmennummer groesser als 8
         if (data)                               // einzelnes Bit des Port1 setzen
         {
-          p1_bitwrite(data-1, vcp1->a & 0x01);  // Klemmennr. beginnt mit 1 (und nicht mit 0)
+          hal_p1_bitwrite(data-1, vcp1->a & 0x01);  // Klemmennr. beginnt mit 1 (und nicht mit 0)
         }
         else
         {
-          p1_config(0xff);
-          p1_bytewrite(vcp1->a);
+          hal_p1_bytewrite(vcp1->a);
         }
         vcp1->pc++;
         break;
@@ -275,12 +375,11 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
         if (data > 8) { err= 5; return; }       // es gibt keine Klemmennummer groesser als 8
         if (data)                               // einzelnes Bit des Port2 setzen
         {
-          p2_bitwrite(data-1, vcp1->a & 0x01);  // Klemmennr. beginnt mit 1 (und nicht mit 0)
+          hal_p2_bitwrite(data-1, vcp1->a & 0x01);  // Klemmennr. beginnt mit 1 (und nicht mit 0)
         }
         else
         {
-          p2_config(0xff);
-          p2_bytewrite(vcp1->a);
+          hal_p2_bytewrite(vcp1->a);
         }
         vcp1->pc++;
         break;
@@ -304,6 +403,8 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
         data= vcp1->mem[data];       // data hat nun die Adresse, die im Memory stand
         if (data> memsize-1) { err= 3; return ; }
         vcp1->mem[data]= vcp1->a;
+        cpu_invalidate(vcp1, data);
+        dbg_watch(data);
         vcp1->pc++;
         break;
       }
@@ -468,6 +569,7 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
       {
         vcp1->a ^= vcp1->mem[data];
         vcp1->pc++;
+        break;
       }
 
       // xri a,const
@@ -665,7 +767,11 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
       // int const: call a software interrupt with number const
       case 63 :
       {
-        key= softw_intr(vcp1, data);
+        #if (cpu_sched == 1)
+          // Softwareinterrupts schreiben selbst in die Anzeige
+          if (budget && cpu_dispreq) { hal_showacc(cpu_dispval); cpu_dispreq= 0; }
+        #endif
+        key= prof_intr(vcp1, data);
         vcp1->pc++;
         if (key== 0x82)
         {
@@ -695,7 +801,113 @@ void cpu_run(kcomp *vcp1, uint8_t stepmode)
         vcp1->pc= vcp1->stack[vcp1->sp];          // Ruecksprungadresse holen und setzen
       }
     }
-    key= readshiftkeys();
+    #if (cpu_debug == 1)
+      if (dbgmode)
+      {
+        if (!stop && dbg_checkcond(vcp1)) stop= dbg_hitcond;
+        if (stop)
+        {
+          dbg.hit= stop;
+          dbg.hitpc= dbgpc;
+          err= dbg_errstop;
+          return;
+        }
+      }
+    #endif
+    #if (cpu_sched == 1)
+      if (budget)
+      {
+        if (cpu_slicestate== cpu_sleep) return;     // cdel, int 1
+        if (!--budget)
+        {
+          cpu_slicestate= cpu_busy;
+          return;
+        }
+        continue;
+      }
+    #endif
+    key= hal_readkey();
   } while (!(stepmode) && (key != 0x82));     // 0x82 = Funktion "STP"
   if (key== 0x82) err= 255;                   // missbrauchter Fehlercode als Kennung dass                                              // Programm mit STP-Taste beendet wurde
 }
+
+#endif
+
+/*  ---------------------------------------------------------
+                             cpu_run
+
+      arbeitet den Programmspeicher ab (siehe cpu_exec).
+      Sind Haltepunkte, Watchpoints oder Haltebedingungen
+      gesetzt, wird die Variante mit Pruefungen verwendet.
+    --------------------------------------------------------- */
+#if (cpu_threaded == 0) || (cpu_debug == 1)
+
+void cpu_run(kcomp *vcp1, uint8_t stepmode)
+{
+  #if (cpu_debug == 1)
+    if (dbg.active)
+    {
+      dbg.hit= 0;
+      cpu_exec<1>(vcp1, stepmode, 0);
+      return;
+    }
+  #endif
+  #if (cpu_threaded == 1)
+    cpu_run_thr(vcp1, stepmode);
+  #else
+    cpu_exec<0>(vcp1, stepmode, 0);
+  #endif
+}
+
+#endif
+
+#if (cpu_sched == 1)
+
+/*  ---------------------------------------------------------
+                            cpu_step_n
+
+      fuehrt hoechstens budget Befehle aus und kehrt dann
+      zurueck (nicht blockierend, siehe sched_run in
+      kosmos_cp1_v43.ino). Waehrend einer Weckzeit kehrt
+      cpu_step_n ohne Befehl zurueck.
+
+      Die Tastatur wird nicht abgefragt, STP muss der
+      Aufrufer auswerten. err muss vor dem Start des
+      Programms (wie bei cpu_run) geloescht sein.
+
+      Rueckgabe:
+        cpu_halt  : hlt, Fehler oder Debuggerhalt (err)
+        cpu_busy  : Zeitscheibe aufgebraucht
+        cpu_sleep : Programm wartet bis cpu_wake
+    --------------------------------------------------------- */
+uint8_t cpu_step_n(kcomp *vcp1, uint16_t budget)
+{
+  if (cpu_slicestate== cpu_sleep)
+  {
+    if ((int32_t)(hal_millis() - cpu_wake) < 0) return cpu_sleep;
+    prof_wake();
+    cpu_slicestate= cpu_busy;
+  }
+
+  cpu_sliced= 1;
+  #if (cpu_debug == 1)
+    if (dbg.active)
+    {
+      if (cpu_slicestate== cpu_halt) dbg.hit= 0;
+      cpu_exec<1>(vcp1, 0, budget);
+      cpu_sliced= 0;
+      if (err) cpu_slicestate= cpu_halt;
+      return cpu_slicestate;
+    }
+  #endif
+  #if (cpu_threaded == 1)
+    cpu_step_thr(vcp1, budget);
+  #else
+    cpu_exec<0>(vcp1, 0, budget);
+  #endif
+  cpu_sliced= 0;
+  if (err) cpu_slicestate= cpu_halt;          // Fehler nach cdel / int 1 im selben Befehl
+  return cpu_slicestate;
+}
+
+#endif
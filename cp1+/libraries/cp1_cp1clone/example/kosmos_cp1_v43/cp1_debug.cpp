@@ -0,0 +1,161 @@
+/* ------------------------------------------------------------------
+                             cp1_debug.cpp
+
+     Haltepunkte, Watchpoints und Haltebedingungen der virtuellen
+     CPU (cpu_debug == 1), siehe cp1_debug.h
+
+     Die Pruefungen selbst werden nur von der Variante von cpu_run
+     mit Pruefungen aufgerufen (cp1_cpu_v43.cpp).
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "kosmos_cp1_v43.h"
+
+#if (cpu_debug == 1)
+
+cpudbg dbg;
+
+static void dbg_update(void)
+{
+  dbg.active= dbg.bpanz || dbg.wpanz || dbg.condanz;
+}
+
+/* ---------------------------------------------------------
+                           dbg_clear
+
+     loescht alle Haltepunkte, Watchpoints und Bedingungen
+   --------------------------------------------------------- */
+void dbg_clear(void)
+{
+  memset(&dbg, 0, sizeof(dbg));
+}
+
+/* ---------------------------------------------------------
+                     dbg_toggle (intern)
+
+     setzt eine Adresse in einer Liste bzw. loescht sie,
+     wenn sie bereits vorhanden ist
+
+     Rueckgabe: 1 = gesetzt, 0 = geloescht, 0xff = Liste
+                voll
+   --------------------------------------------------------- */
+static uint8_t dbg_toggle(uint8_t *list, uint8_t *anz, uint8_t maxanz, uint8_t adr)
+{
+  uint8_t i;
+
+  for (i= 0; i< *anz; i++)
+  {
+    if (list[i] == adr)
+    {
+      (*anz)--;
+      list[i]= list[*anz];
+      dbg_update();
+      return 0;
+    }
+  }
+  if (*anz >= maxanz) return 0xff;
+  list[(*anz)++]= adr;
+  dbg_update();
+  return 1;
+}
+
+uint8_t dbg_togglebp(uint8_t adr)
+{
+  return dbg_toggle(dbg.bp, &dbg.bpanz, dbg_maxbp, adr);
+}
+
+uint8_t dbg_togglewp(uint8_t adr)
+{
+  return dbg_toggle(dbg.wp, &dbg.wpanz, dbg_maxwp, adr);
+}
+
+/* ---------------------------------------------------------
+                          dbg_addcond
+
+     fuegt eine Haltebedingung hinzu
+
+     Uebergabe:
+       src   : 'a'..'e' oder dbg_srcmem
+       adr   : Speicheradresse bei dbg_srcmem
+       op    : '=', '!', '<', '>'
+       value : Vergleichswert
+
+     Rueckgabe: 0 = ok, 0xff = keine Bedingung mehr frei
+   --------------------------------------------------------- */
+uint8_t dbg_addcond(uint8_t src, uint8_t adr, uint8_t op, uint16_t value)
+{
+  dbgcond *c;
+
+  if (dbg.condanz >= dbg_maxcond) return 0xff;
+  c= &dbg.cond[dbg.condanz++];
+  c->src= src;
+  c->adr= adr;
+  c->op= op;
+  c->value= value;
+  dbg_update();
+  return 0;
+}
+
+void dbg_clearcond(void)
+{
+  dbg.condanz= 0;
+  dbg_update();
+}
+
+uint8_t dbg_checkbp(uint8_t pc)
+{
+  uint8_t i;
+
+  for (i= 0; i< dbg.bpanz; i++)
+    if (dbg.bp[i] == pc) return 1;
+  return 0;
+}
+
+uint8_t dbg_checkwp(uint8_t adr)
+{
+  uint8_t i;
+
+  for (i= 0; i< dbg.wpanz; i++)
+    if (dbg.wp[i] == adr) return 1;
+  return 0;
+}
+
+/* ---------------------------------------------------------
+                         dbg_checkcond
+
+     Rueckgabe: 1, wenn eine der Bedingungen erfuellt ist
+   --------------------------------------------------------- */
+uint8_t dbg_checkcond(kcomp *vcp1)
+{
+  dbgcond  *c;
+  uint16_t v;
+  uint8_t  i;
+
+  for (i= 0; i< dbg.condanz; i++)
+  {
+    c= &dbg.cond[i];
+    switch (c->src)
+    {
+      case 'a' : v= vcp1->a; break;
+      case 'b' : v= vcp1->b; break;
+      case 'c' : v= vcp1->c; break;
+      case 'd' : v= vcp1->d; break;
+      case 'e' : v= vcp1->e; break;
+      default  : v= vcp1->mem[c->adr]; break;
+    }
+    switch (c->op)
+    {
+      case '=' : if (v == c->value) return 1; break;
+      case '!' : if (v != c->value) return 1; break;
+      case '<' : if (v <  c->value) return 1; break;
+      case '>' : if (v >  c->value) return 1; break;
+      default  : break;
+    }
+  }
+  return 0;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/* ------------------------------------------------------------------
+                             cp1_debug.h
+
+     Header zu Haltepunkten, Ueberwachung von Speicherzugriffen und
+     Haltebedingungen der virtuellen CPU (cpu_debug == 1)
+
+       Haltepunkt      : Programm haelt vor Ausfuehrung des Befehls
+                         an dieser Adresse
+       Watchpoint      : Programm haelt nach einem Schreibzugriff
+                         (mov adr,a / mov @adr,a) auf diese Adresse
+       Haltebedingung  : Programm haelt, sobald nach einem Befehl
+                         die Bedingung erfuellt ist, z.B. a == 0x10,
+                         @20 > 3
+
+     cpu_run ist zweimal uebersetzt (cp1_cpu_v43.cpp): ohne jede
+     Pruefung und mit den Pruefungen. Die Variante mit Pruefungen
+     wird nur verwendet, wenn mindestens ein Haltepunkt, Watchpoint
+     oder eine Bedingung gesetzt ist (dbg.active), ein normaler
+     Programmlauf ist damit so schnell wie ohne Debugger.
+
+     Ein Halt wird mit err == dbg_errstop gemeldet (wie err == 255
+     fuer die STP-Taste), Grund und Adresse stehen in dbg.hit und
+     dbg.hitpc. Einstellung im Terminal mit brea[k]points.
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_debug
+  #define in_cp1_debug
+
+  #if (cpu_debug == 1)
+
+    #define dbg_maxbp          4      // max. Anzahl Haltepunkte
+    #define dbg_maxwp          2      // max. Anzahl Watchpoints
+    #define dbg_maxcond        2      // max. Anzahl Haltebedingungen
+
+    #define dbg_errstop        254    // err: Programm an Haltepunkt angehalten
+
+    // Grund fuer den Halt (dbg.hit)
+    #define dbg_hitbp          1
+    #define dbg_hitwp          2
+    #define dbg_hitcond        3
+
+    // Quelle einer Bedingung: Register a..e oder Speicherwort
+    #define dbg_srcmem         'm'
+
+    typedef struct dbgcond
+    {
+      uint8_t  src;                 // 'a'..'e' oder dbg_srcmem
+      uint8_t  adr;                 // Adresse bei dbg_srcmem
+      uint8_t  op;                  // '=', '!', '<', '>'
+      uint16_t value;
+    } dbgcond;
+
+    typedef struct cpudbg
+    {
+      uint8_t  active;              // != 0: cpu_run mit Pruefungen
+      uint8_t  bpanz, wpanz, condanz;
+      uint8_t  bp[dbg_maxbp];
+      uint8_t  wp[dbg_maxwp];
+      dbgcond  cond[dbg_maxcond];
+      uint8_t  hit;                 // Grund des letzten Halts, 0 = keiner
+      uint8_t  hitpc;               // Adresse des ausloesenden Befehls
+      uint8_t  hitadr;              // Adresse bei Watchpoint
+    } cpudbg;
+
+    extern cpudbg dbg;
+
+    void    dbg_clear(void);
+    uint8_t dbg_togglebp(uint8_t adr);
+    uint8_t dbg_togglewp(uint8_t adr);
+    uint8_t dbg_addcond(uint8_t src, uint8_t adr, uint8_t op, uint16_t value);
+    void    dbg_clearcond(void);
+    uint8_t dbg_checkbp(uint8_t pc);
+    uint8_t dbg_checkwp(uint8_t adr);
+    uint8_t dbg_checkcond(kcomp *vcp1);
+
+  #endif
+
+#endif
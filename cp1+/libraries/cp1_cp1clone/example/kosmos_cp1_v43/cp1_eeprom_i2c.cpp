@@ -10,7 +10,7 @@
     09.01.2021   R. Seelig
   ------------------------------------------------------ */
 
-#include "cp1_eeprom_i2c.h"
+#include "kosmos_cp1_v43.h"
 
 /* ---------------------------------------------------------
                            i2c_delay
@@ -54,6 +54,7 @@ void i2c_sendstart(void)
 
   i2c_sda_lo();
   long_del();
+  i2ctr_start();
 }
 
 /* -------------------------------------------------------
@@ -97,6 +98,7 @@ void i2c_stop(void)
    short_del();
    i2c_sda_hi();
    long_del();
+   i2ctr_stop();
 }
 
 /* -------------------------------------------------------
@@ -162,6 +164,7 @@ uint8_t i2c_write(uint8_t data)
   i2c_scl_lo();
   long_del();
 
+  i2ctr_write(data, ack);
   return ack;
 }
 
@@ -236,6 +239,7 @@ uint8_t i2c_read(uint8_t ack)
 
   i2c_sda_hi();
 
+  i2ctr_read();
   return data;
 }
 
@@ -244,6 +248,38 @@ uint8_t i2c_read(uint8_t ack)
      Funktionen 24LCxx EEProm
    ################################################################# */
 
+uint8_t eep_pgsize= eep_pagesize;                 // Pagegroesse des angeschlossenen EEProms
+
+/* --------------------------------------------------
+     eep_ackpoll
+
+     wartet, bis das EEProm einen internen Schreib-
+     zyklus beendet hat. Waehrend des Schreibens
+     quittiert das EEProm seine Adresse nicht, die
+     Adresse wird deshalb so lange gesendet, bis ein
+     Acknowledge kommt (typ. deutlich frueher als
+     nach den max. 4 ms eines Schreibzyklus).
+
+     Rueckgabe:
+         1 : EEProm bereit
+         0 : keine Antwort nach eep_polls Versuchen
+   -------------------------------------------------- */
+uint8_t eep_ackpoll(void)
+{
+  uint16_t i;
+
+  for (i= 0; i< eep_polls; i++)
+  {
+    if (i2c_start(eep_addr))
+    {
+      i2c_stop();
+      return 1;
+    }
+    i2c_stop();
+  }
+  return 0;
+}
+
 /* --------------------------------------------------
      eep_write
 
@@ -256,47 +292,67 @@ void eep_write(uint16_t adr, uint8_t value)
   i2c_write16(adr);
   i2c_write(value);
   i2c_stop();
-  _delay_ms(4);
+  eep_ackpoll();
 }
 
 /* --------------------------------------------------
-     eep_erase
+     eep_isblank
 
-     loescht den gesamten Inhalt des EEPROMS
+     testet, ob len Bytes ab adr geloescht (0xff)
+     sind
    -------------------------------------------------- */
-void eep_erase(void)
+static uint8_t eep_isblank(uint16_t adr, uint8_t len)
 {
-  uint16_t cnt;
-  uint16_t adr, len;
-
-  adr= 0; len= 0x7fff;
+  uint8_t blank;
 
+  blank= 1;
   i2c_start(eep_addr);
   i2c_write16(adr);
+  i2c_start(eep_addr | 1);
+  while (--len)
+    if (i2c_read_ack() != 0xff) blank= 0;
+  if (i2c_read_nack() != 0xff) blank= 0;
+  i2c_stop();
+  return blank;
+}
 
-  cnt= 0;
+/* --------------------------------------------------
+     eep_erase
+
+     loescht den gesamten Inhalt des EEPROMS
+     (eep_size Bytes) pageweise
+
+     fast == 1 : Pages, die bereits vollstaendig
+                 geloescht sind, werden nicht
+                 geschrieben
+   -------------------------------------------------- */
+void eep_erase(uint8_t fast)
+{
+  uint16_t adr;
+  uint8_t  i;
+
+  adr= 0;
   do
   {
-    i2c_write(0xff);
-    cnt++;
-    adr++;
-
-    if ((adr % eep_pagesize == 0))                 // Pagegrenze des EEProms
+    if (!fast || !eep_isblank(adr, eep_pgsize))
     {
-      i2c_stop();
-      _delay_ms(4);                                // Wartezeit bis Page geschrieben ist
-      i2c_start(eep_addr);                         // neue Page oeffnen
+      i2c_start(eep_addr);
       i2c_write16(adr);
+      for (i= 0; i< eep_pgsize; i++) i2c_write(0xff);
+      i2c_stop();
+      eep_ackpoll();                               // warten bis Page geschrieben ist
     }
-  } while (cnt< len);
-  i2c_stop();
-  _delay_ms(4);
+    adr += eep_pgsize;
+  } while (adr < eep_size);
 }
 
 /* --------------------------------------------------
      eep_writebuf
 
-     schreibt mehrere Datenbytes in das EEProm
+     schreibt mehrere Datenbytes in das EEProm. An
+     jeder Pagegrenze wird die Page geschrieben und
+     per eep_ackpoll auf das Ende des Schreibzyklus
+     gewartet.
 
      Uebergabe:
          adr    : Adresse, ab der die Bytes im
@@ -309,6 +365,7 @@ void eep_writebuf(uint16_t adr, uint8_t *buf, uint16_t len)
 {
   uint16_t cnt;
 
+  if (!len) return;
   i2c_start(eep_addr);
   i2c_write16(adr);
 
@@ -320,16 +377,16 @@ void eep_writebuf(uint16_t adr, uint8_t *buf, uint16_t len)
     cnt++;
     adr++;
 
-    if ((adr % eep_pagesize == 0))                 // Pagegrenze des EEProms
+    if ((adr % eep_pgsize == 0) && (cnt < len))    // Pagegrenze des EEProms
     {
       i2c_stop();
-      _delay_ms(4);                                // Wartezeit bis Page geschrieben ist
+      eep_ackpoll();                               // warten bis Page geschrieben ist
       i2c_start(eep_addr);                         // neue Page oeffnen
       i2c_write16(adr);
     }
   } while (cnt< len);
   i2c_stop();
-  _delay_ms(4);
+  eep_ackpoll();
 }
 
 /* --------------------------------------------------
@@ -342,13 +399,10 @@ uint8_t eep_read(uint16_t adr)
 {
   uint8_t value;
 
-  _delay_ms(1);
-  i2c_start(eep_addr);                             // sicherheitshalber
-  i2c_stop();                                      // I2C Bus garantiert frei
+  eep_ackpoll();                                   // I2C Bus und EEProm garantiert frei
 
   i2c_start(eep_addr);
   i2c_write16(adr);
-  _delay_ms(5);
 
   i2c_start(0xa1);
 
@@ -375,8 +429,7 @@ void eep_readbuf(uint16_t adr, uint8_t *buf, uint16_t len)
 {
   uint16_t cnt;
 
-  i2c_start(eep_addr);                             // sicherheitshalber
-  i2c_stop();                                      // I2C Bus garantiert frei
+  eep_ackpoll();                                   // I2C Bus und EEProm garantiert frei
 
   i2c_start(eep_addr);
   i2c_write16(adr);
@@ -396,7 +449,6 @@ void eep_readbuf(uint16_t adr, uint8_t *buf, uint16_t len)
     cnt++;
     adr++;
   } while (cnt < len-1);
-  i2c_read_nack();                                  // noch einmal lesen um kein ack zu schicken
+  *buf= i2c_read_nack();                            // letztes Byte ohne ack lesen
   i2c_stop();                                       // und somit Adresszaehler EEPROM freigeben
-  _delay_ms(1);
 }
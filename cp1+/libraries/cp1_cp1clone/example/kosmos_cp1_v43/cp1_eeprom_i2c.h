@@ -41,8 +41,12 @@
   
   */
   
-  #define  eep_pagesize    8
+  #define  eep_pagesize    8            // Vorgabe fuer eep_pgsize (passt fuer alle 24LCxx)
   #define  eep_addr        0xa0
+  #define  eep_size        0x8000       // Groesse fuer eep_erase (24LC256)
+  #define  eep_polls       250          // max. Anzahl Adressierungen in eep_ackpoll (> 10 ms)
+
+  extern uint8_t eep_pgsize;            // Pagegroesse zur Laufzeit, z.B. 64 fuer 24LC256
   
 
   #define short_puls     1            // Einheiten fuer einen langen Taktimpuls
@@ -71,8 +75,9 @@
   #define i2c_read_ack()    i2c_read(1)
   #define i2c_read_nack()   i2c_read(0)
   
+  uint8_t eep_ackpoll(void);
   void eep_write(uint16_t adr, uint8_t value);
-  void eep_erase(void);
+  void eep_erase(uint8_t fast);
   void eep_writebuf(uint16_t adr, uint8_t *buf, uint16_t len);
   uint8_t eep_read(uint16_t adr);
   void eep_readbuf(uint16_t adr, uint8_t *buf, uint16_t len);
@@ -0,0 +1,76 @@
+/* ------------------------------------------------------------------
+                              cp1_hal.h
+
+     Hardwareabstraktion der virtuellen CPU
+
+     Die virtuelle CPU (cp1_cpu_v43.cpp) greift ausschliesslich
+     ueber die hier definierten hal_xxx Aufrufe auf Ports, An-
+     zeige, Tastatur, Zeitverzoegerung, Zeitbasis und Software-
+     interrupts zu.
+
+     Auf dem AVR sind die Aufrufe Makros, die direkt auf die
+     Funktionen der Module cp1_vports, cp1_tm1637 und auf
+     kosmos_cp1_v43.ino verweisen (kein zusaetzlicher Aufwand).
+
+     Fuer einen Build auf einem Linux-Host (Benchmark, siehe
+     ./host) werden die Funktionen in ./host/cp1_hal_host.cpp
+     implementiert.
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_hal
+  #define in_cp1_hal
+
+  #if defined(__AVR__)
+
+    extern volatile uint32_t millis_t0;        // Timerticker in kosmos_cp1_v43.ino
+
+    #define hal_showmask(mask)           (showmask= (mask))
+    #define hal_showacc(value)           setdez(value, 0)
+    #define hal_readkey()                readshiftkeys()
+    #define hal_delay(dtime)             cp1_delay(dtime)
+    #define hal_intr(vcp1, data)         softw_intr(vcp1, data)
+
+    // millis_t0 ist 32 Bit breit, bei freigegebenen Interrupts (sched_run)
+    // nur mit gesperrtem Interrupt konsistent lesbar
+    static inline uint32_t hal_millis(void)
+    {
+      uint32_t t;
+
+      ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { t= millis_t0; }
+      return t;
+    }
+
+    #define hal_p1_bitread(bitnr)        p1_bitread(bitnr)
+    #define hal_p1_byteread()            p1_byteread()
+    #define hal_p1_bitwrite(bitnr, val)  p1_bitwrite(bitnr, val)
+    #define hal_p1_bytewrite(val)        { p1_config(0xff); p1_bytewrite(val); }
+    #define hal_p2_bitwrite(bitnr, val)  p2_bitwrite(bitnr, val)
+    #define hal_p2_bytewrite(val)        { p2_config(0xff); p2_bytewrite(val); }
+
+  #else
+
+    /* ---------------------------------------------------------
+                   Prototypen (Implementierung Host)
+       --------------------------------------------------------- */
+
+    void    hal_showmask(uint8_t mask);
+    void    hal_showacc(uint32_t value);
+    uint8_t hal_readkey(void);
+    uint8_t hal_delay(uint32_t dtime);
+    uint8_t hal_intr(kcomp *vcp1, int data);
+    uint32_t hal_millis(void);
+
+    uint8_t hal_p1_bitread(uint8_t bitnr);
+    uint8_t hal_p1_byteread(void);
+    void    hal_p1_bitwrite(uint8_t bitnr, uint8_t value);
+    void    hal_p1_bytewrite(uint8_t value);
+    void    hal_p2_bitwrite(uint8_t bitnr, uint8_t value);
+    void    hal_p2_bytewrite(uint8_t value);
+
+  #endif
+
+#endif
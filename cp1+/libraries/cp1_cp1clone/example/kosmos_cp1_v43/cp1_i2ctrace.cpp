@@ -0,0 +1,198 @@
+/* ------------------------------------------------------------------
+                             cp1_i2ctrace.cpp
+
+     Mitschnitt der I2C Transaktionen auf dem EEProm-Bus
+     (cpu_i2ctrace == 1)
+
+     Der offene Datensatz wird mit der Startbedingung begonnen und
+     mit der Stopbedingung (bzw. einem wiederholten Start) in den
+     Ring uebernommen. Das erste Byte nach dem Start ist die
+     Adresse.
+
+     MCU  :   ATmega328p
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "kosmos_cp1_v43.h"
+
+#if (cpu_i2ctrace == 1)
+
+#define  i2ctr_faddr     0x40           // intern: Adressbyte steht noch aus
+#define  i2ctr_fopen     0x80           // intern: Datensatz ist offen
+
+static i2ctr_rec ring[i2ctr_size];
+static i2ctr_rec act;                   // offener Datensatz
+static uint8_t   rput, ranz;
+static volatile uint16_t tick_hi;       // oberes Wort der Ticks
+
+uint16_t i2ctr_lost;
+
+/* ---------------------------------------------------------
+                      ISR(TIMER1_OVF_vect)
+
+     zaehlt das obere Wort der Zeitbasis
+   --------------------------------------------------------- */
+ISR(TIMER1_OVF_vect)
+{
+  tick_hi++;
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_begin
+
+     startet Timer1 als Zeitbasis und leert den Ring
+   --------------------------------------------------------- */
+void i2ctrace_begin(void)
+{
+  TCCR1A= 0;                            // normal mode
+  TCCR1B= 1 << CS11;                    // Prescaler 8
+  TCNT1= 0;
+  TIFR1= 1 << TOV1;
+  TIMSK1= 1 << TOIE1;
+  i2ctrace_clear();
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_clear
+
+     verwirft alle Eintraege
+   --------------------------------------------------------- */
+void i2ctrace_clear(void)
+{
+  rput= 0; ranz= 0; i2ctr_lost= 0;
+  act.flags= 0;
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_ticks
+
+     Rueckgabe: Zeit in Timer1 Ticks (32 Bit)
+   --------------------------------------------------------- */
+uint32_t i2ctrace_ticks(void)
+{
+  uint16_t lo, hi;
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    lo= TCNT1;
+    hi= tick_hi;
+    // Ueberlauf, dessen Interrupt noch aussteht
+    if ((TIFR1 & (1 << TOV1)) && (lo < 0x8000)) hi++;
+  }
+  return ((uint32_t)hi << 16) | lo;
+}
+
+/* ---------------------------------------------------------
+                         i2ctrace_us
+
+     rechnet Timer1 Ticks (Prescaler 8) in us um
+   --------------------------------------------------------- */
+uint32_t i2ctrace_us(uint32_t ticks)
+{
+  #if (F_CPU == 16000000UL)
+    return ticks >> 1;
+  #elif (F_CPU == 8000000UL)
+    return ticks;
+  #else
+    return (uint64_t)ticks * 8 / (F_CPU / 1000000UL);
+  #endif
+}
+
+/* ---------------------------------------------------------
+                         i2ctr_commit
+
+     uebernimmt den offenen Datensatz in den Ring
+   --------------------------------------------------------- */
+static void i2ctr_commit(uint32_t now)
+{
+  uint32_t dur;
+
+  dur= now - act.start;
+  act.dur= (dur > 0xffff) ? 0xffff : dur;
+  act.flags &= ~(i2ctr_faddr | i2ctr_fopen);
+
+  ring[rput]= act;
+  rput++;
+  if (rput== i2ctr_size) rput= 0;
+  if (ranz < i2ctr_size) ranz++; else i2ctr_lost++;
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_start
+
+     Startbedingung (auch wiederholter Start)
+   --------------------------------------------------------- */
+void i2ctrace_start(void)
+{
+  uint32_t now;
+  uint8_t  rs;
+
+  now= i2ctrace_ticks();
+  rs= 0;
+  if (act.flags & i2ctr_fopen)
+  {
+    i2ctr_commit(now);                  // wiederholter Start beendet den Datensatz
+    rs= i2ctr_frstart;
+  }
+  act.start= now;
+  act.addr= 0;
+  act.cnt= 0;
+  act.flags= i2ctr_fopen | i2ctr_faddr | rs;
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_write
+
+     gesendetes Byte, ack: 1 = Acknowledge vom Slave
+   --------------------------------------------------------- */
+void i2ctrace_write(uint8_t data, uint8_t ack)
+{
+  if (!(act.flags & i2ctr_fopen)) return;
+  if (act.flags & i2ctr_faddr)
+  {
+    act.flags &= ~i2ctr_faddr;
+    act.addr= data >> 1;
+    if (data & 1) act.flags |= i2ctr_fread;
+    if (!ack) act.flags |= i2ctr_fnackadr;
+    return;
+  }
+  if (act.cnt < 0xff) act.cnt++;
+  if (!ack) act.flags |= i2ctr_fnackdat;
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_read
+
+     gelesenes Byte
+   --------------------------------------------------------- */
+void i2ctrace_read(void)
+{
+  if ((act.flags & i2ctr_fopen) && (act.cnt < 0xff)) act.cnt++;
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_stop
+
+     Stopbedingung
+   --------------------------------------------------------- */
+void i2ctrace_stop(void)
+{
+  if (act.flags & i2ctr_fopen) i2ctr_commit(i2ctrace_ticks());
+}
+
+/* ---------------------------------------------------------
+                        i2ctrace_get
+
+     kopiert Eintrag idx (0 = aeltester) nach rec
+
+     Rueckgabe: 1 = ok, 0 = idx nicht vorhanden
+   --------------------------------------------------------- */
+uint8_t i2ctrace_get(uint8_t idx, i2ctr_rec *rec)
+{
+  if (idx >= ranz) return 0;
+  *rec= ring[(rput + i2ctr_size - ranz + idx) % i2ctr_size];
+  return 1;
+}
+
+#endif
@@ -0,0 +1,74 @@
+/* ------------------------------------------------------------------
+                             cp1_i2ctrace.h
+
+     Header zum Mitschnitt der I2C Transaktionen auf dem EEProm-Bus
+
+     Bei cpu_i2ctrace == 1 rufen i2c_sendstart, i2c_write, i2c_read
+     und i2c_stop (cp1_eeprom_i2c.cpp) die i2ctr_xxx Makros auf.
+     Je Transaktion wird ein Datensatz (Adresse, Richtung, Anzahl
+     Bytes, Ack / Nack, Beginn und Dauer) in einem Ringpuffer mit
+     i2ctr_size Eintraegen abgelegt, der aelteste Eintrag wird ggf.
+     ueberschrieben. Anzeige (CSV) und Loeschen im Terminal mit
+     [i]2c trace.
+
+     Zeitbasis ist Timer1 (Prescaler 8, 1 us bei 8 MHz), das obere
+     Wort zaehlt der Ueberlaufinterrupt. Benutzt das CP1-Programm
+     PWM (cp1_pwm.cpp, ebenfalls Timer1), sind die Zeiten ab dann
+     ungueltig.
+
+     Bei cpu_i2ctrace == 0 sind alle i2ctr_xxx Makros leer.
+
+     MCU  :   ATmega328p
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_i2ctrace
+  #define in_cp1_i2ctrace
+
+  #if (cpu_i2ctrace == 1)
+
+    #define  i2ctr_size          16         // Eintraege im Ringpuffer (je 9 Byte RAM)
+
+    // i2ctr_rec.flags
+    #define  i2ctr_fread         0x01       // Lesezugriff
+    #define  i2ctr_fnackadr      0x02       // Nack auf die Adresse
+    #define  i2ctr_fnackdat      0x04       // Nack auf ein Datenbyte
+    #define  i2ctr_frstart       0x08       // mit wiederholtem Start begonnen
+
+    typedef struct i2ctr_rec
+    {
+      uint32_t start;                   // Timer1 Ticks bei der Startbedingung
+      uint16_t dur;                     // Dauer in Ticks (max. 0xffff)
+      uint8_t  addr;                    // 7-Bit Adresse
+      uint8_t  cnt;                     // Anzahl Datenbytes
+      uint8_t  flags;
+    } i2ctr_rec;
+
+    extern uint16_t i2ctr_lost;         // ueberschriebene Eintraege
+
+    void     i2ctrace_begin(void);
+    void     i2ctrace_clear(void);
+    uint32_t i2ctrace_ticks(void);
+    uint32_t i2ctrace_us(uint32_t ticks);
+    uint8_t  i2ctrace_get(uint8_t idx, i2ctr_rec *rec);
+    void     i2ctrace_start(void);
+    void     i2ctrace_write(uint8_t data, uint8_t ack);
+    void     i2ctrace_read(void);
+    void     i2ctrace_stop(void);
+
+    #define i2ctr_start()                i2ctrace_start()
+    #define i2ctr_write(data, ack)       i2ctrace_write(data, ack)
+    #define i2ctr_read()                 i2ctrace_read()
+    #define i2ctr_stop()                 i2ctrace_stop()
+
+  #else
+
+    #define i2ctr_start()
+    #define i2ctr_write(data, ack)
+    #define i2ctr_read()
+    #define i2ctr_stop()
+
+  #endif
+
+#endif
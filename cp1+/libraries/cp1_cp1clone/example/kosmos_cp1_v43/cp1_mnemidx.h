@@ -0,0 +1,97 @@
+/* ------------------------------------------------------------------
+                            cp1_mnemidx.h
+
+     Index zur Mnemonicliste mnemset (cp1_assemble_line.cpp)
+
+     !!! generiert mit host/cp1_mkidx (make idx), nach jeder
+     Aenderung an mnemset neu erzeugen !!!
+
+     mnemsort : Eintraege von mnemset nach Mnemonic-Muster
+                sortiert (binaere Suche in assemble_line)
+     mnemopc  : Opcode -> Eintrag in mnemset, 0xff = kein
+                Eintrag (disassemble_prgword)
+   ------------------------------------------------------------------ */
+
+const uint8_t mnemsort[mnemanz] PROGMEM =
+{
+   66,       // .org ?
+    9,       // add a,?
+   60,       // adi a,?
+   56,       // and a,?
+   18,       // andb a,?
+   57,       // ani a,?
+   64,       // call ?
+    3,       // cdel ?
+    2,       // cdis
+   50,       // cmp a,?
+   11,       // cpe a,?
+   12,       // cpg a,?
+   49,       // cpi a,?
+   13,       // cpl a,?
+    0,       // db ?
+   27,       // dec a
+   25,       // djnz a,?
+    1,       // hlt
+   20,       // in p1
+   19,       // inb p1,?
+   26,       // inc a
+   63,       // int ?
+   53,       // jc ?
+   14,       // jmp ?
+   16,       // jmp @?
+   52,       // jpg ?
+   51,       // jpl ?
+   15,       // jz ?
+    6,       // mov ?,a
+    8,       // mov @?,a
+    5,       // mov a,?
+    7,       // mov a,@?
+   32,       // mov a,b
+   33,       // mov a,c
+   34,       // mov a,d
+   35,       // mov a,e
+   36,       // mov b,a
+   40,       // mov b,c
+   41,       // mov b,d
+   42,       // mov b,e
+   37,       // mov c,a
+   43,       // mov c,b
+   44,       // mov c,d
+   45,       // mov c,e
+   38,       // mov d,a
+   39,       // mov e,a
+   62,       // mul a,b
+    4,       // mvi a,?
+   28,       // mvi b,?
+   29,       // mvi c,?
+   30,       // mvi d,?
+   31,       // mvi e,?
+   46,       // not a
+   17,       // notb a
+   58,       // or a,?
+   59,       // ori a,?
+   22,       // out p1
+   24,       // out p2
+   21,       // outb p1,?
+   23,       // outb p2,?
+   65,       // ret
+   61,       // sbi a,?
+   54,       // slc a
+   55,       // src a
+   10,       // sub a,?
+   47,       // xor a,?
+   48        // xri a,?
+};
+
+const uint8_t mnemopc[mnemopcanz] PROGMEM =
+{
+     0,    1,    2,    3,    4,    5,    6,    9,     //   0 ..   7
+    10,   14,   11,   15,   12,   13,   17,   18,     //   8 ..  15
+    19,   21,   23,    7,    8,   16, 0xff, 0xff,     //  16 ..  23
+  0xff,   25,   26,   27,   28,   29,   30,   31,     //  24 ..  31
+    32,   33,   34,   35,   36,   37,   38,   39,     //  32 ..  39
+    40,   41,   42,   43,   44,   45,   46,   47,     //  40 ..  47
+    48,   49,   50,   51,   52,   53,   54,   55,     //  48 ..  55
+    56,   57,   58,   59,   60,   61,   62,   63,     //  56 ..  63
+    64,   65,   66                                    //  64 ..  66
+};
@@ -0,0 +1,166 @@
+/* --------------------------------------------------------
+                       cp1_prgstore.cpp
+
+     Speichern / Laden des Programmspeichers auf den
+     Speicherplaetzen, extern nur geaenderte Bloecke
+     und mit CRC je Speicherplatz (siehe cp1_prgstore.h)
+
+     MCU: ATmega328p / Linux-Host
+
+     R. Seelig
+   -------------------------------------------------------- */
+
+#include "kosmos_cp1_v43.h"
+
+// Adresse im internen EEPROM als Zeiger fuer eeprom_read_byte / eeprom_update_byte
+#define ieep(adr)       ((uint8_t *)(uintptr_t)(adr))
+
+uint8_t prg_dirty[prg_blkanz / 8];
+const uint8_t prg_bitmask[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+uint8_t prg_slot= prg_noslot;
+
+/* --------------------------------------------------
+                        prg_crc
+
+     CRC16 (XMODEM) ueber den Programmspeicher in
+     der Byteanordnung des externen EEPROMs
+  -------------------------------------------------- */
+uint16_t prg_crc(kcomp *vcp1)
+{
+  uint16_t crc, i;
+  uint8_t  *p;
+
+  crc= 0;
+  p= (uint8_t *)&vcp1->mem[0];
+  for (i= 0; i< prg_slotsize; i++)
+    crc= _crc_xmodem_update(crc, *p++);
+  return crc;
+}
+
+static uint16_t prg_readcrc(uint8_t slot)
+{
+  uint16_t crc;
+
+  eep_readbuf(prg_crcadr + (slot * 2), (uint8_t *)&crc, 2);
+  return crc;
+}
+
+static void prg_clean(uint8_t slot)
+{
+  memset(prg_dirty, 0, sizeof(prg_dirty));
+  prg_slot= slot;
+}
+
+/* --------------------------------------------------
+                       prg_save
+
+     speichert den Programmspeicher auf Speicher-
+     platz slot. Intern wird nur bei abweichendem
+     Inhalt geschrieben, extern werden benachbarte
+     abweichende Bloecke zusammen geschrieben.
+
+     Rueckgabe: Anzahl geschriebener Bloecke (intern
+                Programmworte)
+  -------------------------------------------------- */
+uint16_t prg_save(kcomp *vcp1, uint8_t slot)
+{
+  uint8_t  buf[prg_blksize];
+  uint8_t  *mem;
+  uint16_t base, crc, w, cnt;
+  uint8_t  blk, first, all;
+
+  cnt= 0;
+  if (slot < 2)
+  {
+    for (w= 0; w< memsize; w++)
+    {
+      base= (w * 2) + (slot * prg_slotsize);
+      if ((eeprom_read_byte(ieep(base)) != (vcp1->mem[w] >> 8)) ||
+          (eeprom_read_byte(ieep(base + 1)) != (vcp1->mem[w] & 0xff)))
+      {
+        eeprom_update_byte(ieep(base), vcp1->mem[w] >> 8);            // Hi-Byte
+        eeprom_update_byte(ieep(base + 1), vcp1->mem[w] & 0xff);    // Lo-Byte
+        cnt++;
+      }
+    }
+    prg_clean(slot);
+    return cnt;
+  }
+
+  base= (slot - 2) * prg_slotsize;
+  mem= (uint8_t *)&vcp1->mem[0];
+  all= (slot != prg_slot);
+  first= 0xff;                                        // Beginn einer Folge abweichender Bloecke
+
+  for (blk= 0; blk<= prg_blkanz; blk++)
+  {
+    if (blk < prg_blkanz)
+    {
+      if (all || (prg_dirty[blk >> 3] & prg_bitmask[blk & 7]))
+      {
+        eep_readbuf(base + (blk * prg_blksize), buf, prg_blksize);
+        if (memcmp(buf, &mem[blk * prg_blksize], prg_blksize))
+        {
+          if (first== 0xff) first= blk;
+          cnt++;
+          continue;
+        }
+      }
+    }
+    if (first != 0xff)
+    {
+      eep_writebuf(base + (first * prg_blksize), &mem[first * prg_blksize], (blk - first) * prg_blksize);
+      first= 0xff;
+    }
+  }
+
+  crc= prg_crc(vcp1);
+  if (prg_readcrc(slot) != crc) eep_writebuf(prg_crcadr + (slot * 2), (uint8_t *)&crc, 2);
+  prg_clean(slot);
+  return cnt;
+}
+
+/* --------------------------------------------------
+                       prg_load
+
+     laedt Speicherplatz slot in den Programmspeicher
+
+     Steht in der Tabelle noch keine CRC (prg_nocrc),
+     wird sie nach dem Laden eingetragen.
+
+     Rueckgabe: 0 = ok
+                1 = CRC stimmt nicht mit der Tabelle
+                    ueberein (nur extern)
+  -------------------------------------------------- */
+uint8_t prg_load(kcomp *vcp1, uint8_t slot)
+{
+  uint16_t w, hib, lob, base, crc, tcrc;
+  uint8_t  e;
+
+  e= 0;
+  if (slot < 2)
+  {
+    for (w= 0; w< memsize; w++)
+    {
+      base= (w * 2) + (slot * prg_slotsize);
+      hib= eeprom_read_byte(ieep(base));          // Hi-Byte lesen
+      lob= eeprom_read_byte(ieep(base + 1));    // Lo-Byte lesen
+      vcp1->mem[w]= (hib << 8) | (lob & 0xff);
+    }
+  }
+  else
+  {
+    eep_readbuf((slot - 2) * prg_slotsize, (uint8_t *)&vcp1->mem[0], prg_slotsize);
+    crc= prg_crc(vcp1);
+    tcrc= prg_readcrc(slot);
+    if (tcrc== prg_nocrc)
+    {
+      if (crc != prg_nocrc) eep_writebuf(prg_crcadr + (slot * 2), (uint8_t *)&crc, 2);
+    }
+    else
+    if (crc != tcrc) e= 1;
+  }
+  cpu_invalidate_all(vcp1);
+  prg_clean(slot);
+  return e;
+}
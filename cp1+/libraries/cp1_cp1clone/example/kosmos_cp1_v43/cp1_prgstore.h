@@ -0,0 +1,65 @@
+/* ------------------------------------------------------------------
+                            cp1_prgstore.h
+
+     Header zum Speichern / Laden des Programmspeichers auf den
+     Speicherplaetzen (CAS / CAL, Terminal [s]ave / [l]oad)
+
+       Speicherplatz 0, 1       : internes EEPROM des ATmega328
+                                  (je 512 Byte, Hi- / Lo-Byte)
+       Speicherplatz 2..prg_max : externes I2C-EEPROM, je 512 Byte
+                                  ab (platz-2) * 512, belegen die
+                                  ersten eep_memsize Bytes
+       ab eep_memsize extern    : CRC16 je Speicherplatz (Tabelle,
+                                  2 * (prg_max+1) Bytes), ausserhalb
+                                  der Speicherplaetze. Benoetigt ein
+                                  EEPROM groesser als eep_memsize
+                                  (eep_size, 24LC256)
+
+     Geaenderte Programmworte werden in Bloecken zu prg_blksize
+     Bytes (kleinste Pagegroesse der 24LCxx) mitgefuehrt. Jeder
+     Schreibzugriff auf kcomp::mem markiert ueber cpu_invalidate /
+     cpu_invalidate_all seinen Block als geaendert.
+
+     Beim Speichern auf den zuletzt geladenen / gespeicherten Platz
+     werden nur geaenderte Bloecke, auf einen anderen Platz alle
+     Bloecke mit dem EEPROM verglichen und nur abweichende Bloecke
+     geschrieben. Beim Laden wird die CRC des gelesenen Programms
+     mit der Tabelle verglichen (kein zweites Lesen noetig).
+     Ein Tabelleneintrag 0xffff (geloeschtes EEPROM, Programm von
+     einer Firmware ohne CRC gespeichert) bedeutet "noch keine CRC":
+     das Programm wird geladen und die CRC nachgetragen.
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_prgstore
+  #define in_cp1_prgstore
+
+  #define  prg_slotsize       (memsize * 2)                  // Bytes je Speicherplatz
+  #define  prg_max            (eep_memsize / prg_slotsize + 1)   // hoechster Speicherplatz
+  #define  prg_crcadr         eep_memsize                    // CRC-Tabelle im I2C-EEPROM
+  #define  prg_nocrc          0xffff                         // Tabelleneintrag ohne CRC
+
+  #if (prg_crcadr + 2 * (prg_max + 1) > eep_size)
+    #error "CRC-Tabelle passt nicht in das I2C-EEPROM (eep_size)"
+  #endif
+  #define  prg_blksize        8                              // Bytes je Block
+  #define  prg_blkanz         (prg_slotsize / prg_blksize)
+  #define  prg_noslot         0xff
+
+  extern uint8_t prg_dirty[prg_blkanz / 8];
+  extern const uint8_t prg_bitmask[8];
+  extern uint8_t prg_slot;                // zuletzt geladener / gespeicherter Platz
+
+  // Programmwort adr wurde veraendert
+  #define prg_touch(adr)        (prg_dirty[(uint8_t)(adr) >> 5] |= prg_bitmask[((uint8_t)(adr) >> 2) & 7])
+  // gesamter Programmspeicher wurde veraendert
+  #define prg_touchall()        memset(prg_dirty, 0xff, sizeof(prg_dirty))
+
+  uint16_t prg_crc(kcomp *vcp1);
+  uint16_t prg_save(kcomp *vcp1, uint8_t slot);
+  uint8_t prg_load(kcomp *vcp1, uint8_t slot);
+
+#endif
@@ -0,0 +1,125 @@
+/* ------------------------------------------------------------------
+                             cp1_prof.cpp
+
+     Ausfuehrungsprofil der virtuellen CPU (cpu_profile == 1)
+
+     Zeiten werden mit hal_millis gemessen. Auf dem AVR ist das
+     millis_t0, das nur waehrend cp1_delay weiterzaehlt: erfasst
+     werden damit die Wartezeiten von cdel und int 1, Interrupts
+     ohne Verzoegerung gehen nur mit ihrer Anzahl ein.
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "kosmos_cp1_v43.h"
+
+#if (cpu_profile == 1)
+
+cpuprof prof;
+
+#if (cpu_sched == 1)
+  static uint32_t *prof_slept= 0;         // Zaehler der laufenden Weckzeit (delay_ms, intr_ms)
+  static uint32_t prof_sleep0;            // Beginn der Weckzeit
+#endif
+
+/* ---------------------------------------------------------
+                          prof_clear
+
+     loescht alle Zaehler des Profils
+   --------------------------------------------------------- */
+void prof_clear(void)
+{
+  memset(&prof, 0, sizeof(prof));
+}
+
+/* ---------------------------------------------------------
+                         prof_rescale
+
+     halbiert alle Zaehler der Programmadressen, die
+     Verhaeltnisse der Adressen untereinander bleiben
+     erhalten
+   --------------------------------------------------------- */
+void prof_rescale(void)
+{
+  uint16_t i;
+
+  for (i= 0; i< memsize; i++)
+    prof.pccnt[i] >>= 1;
+  prof.pcscale++;
+}
+
+/* ---------------------------------------------------------
+                          prof_delay
+
+     hal_delay mit Zeitmessung (cdel)
+   --------------------------------------------------------- */
+uint8_t prof_delay(uint32_t dtime)
+{
+  uint32_t t0;
+  uint8_t  key;
+
+  t0= hal_millis();
+  key= hal_delay(dtime);
+  prof.delay_ms += hal_millis() - t0;
+  prof.delay_cnt++;
+  return key;
+}
+
+/* ---------------------------------------------------------
+                          prof_intr
+
+     hal_intr mit Zeitmessung (int)
+   --------------------------------------------------------- */
+uint8_t prof_intr(kcomp *vcp1, int data)
+{
+  uint32_t t0;
+  uint8_t  key;
+
+  t0= hal_millis();
+  key= hal_intr(vcp1, data);
+  prof.intr_ms += hal_millis() - t0;
+  prof.intr_cnt++;
+  #if (cpu_sched == 1)
+    if (cpu_sliced && (cpu_slicestate== cpu_sleep))     // int 1 in einer Zeitscheibe
+    {
+      prof_slept= &prof.intr_ms;
+      prof_sleep0= t0;
+    }
+  #endif
+  return key;
+}
+
+#if (cpu_sched == 1)
+
+/* ---------------------------------------------------------
+                          prof_sleep_ms
+
+     cpu_sleep_ms mit Zeitmessung (cdel in einer Zeit-
+     scheibe), die Zeit wird bei prof_wake verbucht
+   --------------------------------------------------------- */
+void prof_sleep_ms(uint32_t ms)
+{
+  prof_sleep0= hal_millis();
+  prof_slept= &prof.delay_ms;
+  prof.delay_cnt++;
+  cpu_sleep_ms(ms);
+}
+
+/* ---------------------------------------------------------
+                            prof_wake
+
+     Ende einer Weckzeit (cpu_step_n) oder Abbruch waehrend
+     der Weckzeit (sched_run): verschlafene Zeit verbuchen
+   --------------------------------------------------------- */
+void prof_wake(void)
+{
+  if (!prof_slept) return;
+  *prof_slept += hal_millis() - prof_sleep0;
+  prof_slept= 0;
+}
+
+#endif
+
+#endif
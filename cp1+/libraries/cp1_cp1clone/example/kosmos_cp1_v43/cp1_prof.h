@@ -0,0 +1,68 @@
+/* ------------------------------------------------------------------
+                             cp1_prof.h
+
+     Header zum Ausfuehrungsprofil der virtuellen CPU
+
+     Bei cpu_profile == 1 zaehlt cpu_run (bzw. cpu_run_thr) jeden
+     ausgefuehrten Befehl je Opcode und je Programmadresse und
+     erfasst die in cdel und int verbrachte Zeit. Anzeige und
+     Loeschen im Terminal mit [p]rofile.
+
+     In Zeitscheiben (cpu_sched == 1) wartet cdel bzw. int 1
+     nicht, sondern setzt eine Weckzeit: die Zeit wird dann
+     von prof_sleep_ms (cdel) bzw. prof_intr bis zum Aufwachen
+     in cpu_step_n (prof_wake) gemessen.
+
+     Bei cpu_profile == 0 sind alle prof_xxx Makros leer bzw.
+     verweisen direkt auf die HAL-Funktionen (kein Aufwand).
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_prof
+  #define in_cp1_prof
+
+  #if (cpu_profile == 1)
+
+    typedef struct cpuprof
+    {
+      uint32_t opccnt[opcmax+1];    // Anzahl Ausfuehrungen je Opcode
+      uint16_t pccnt[memsize];      // Anzahl Ausfuehrungen je Programmadresse, wird
+                                    // bei Erreichen von 0xffff insgesamt halbiert
+      uint8_t  pcscale;             // Anzahl der Halbierungen von pccnt
+      uint16_t delay_cnt;           // Anzahl cdel Aufrufe
+      uint32_t delay_ms;            // Zeit in cdel
+      uint16_t intr_cnt;            // Anzahl int Aufrufe
+      uint32_t intr_ms;             // Zeit in int
+    } cpuprof;
+
+    extern cpuprof prof;
+
+    void    prof_clear(void);
+    void    prof_rescale(void);
+    uint8_t prof_delay(uint32_t dtime);
+    uint8_t prof_intr(kcomp *vcp1, int data);
+    #if (cpu_sched == 1)
+      void  prof_sleep_ms(uint32_t ms);
+      void  prof_wake(void);
+    #endif
+
+    #define prof_count(opc, pc)                                \
+    {                                                          \
+      prof.opccnt[opc]++;                                      \
+      if (++prof.pccnt[pc] == 0xffff) prof_rescale();          \
+    }
+
+  #else
+
+    #define prof_count(opc, pc)
+    #define prof_delay(dtime)            hal_delay(dtime)
+    #define prof_intr(vcp1, data)        hal_intr(vcp1, data)
+    #define prof_sleep_ms(ms)            cpu_sleep_ms(ms)
+    #define prof_wake()
+
+  #endif
+
+#endif
@@ -0,0 +1,315 @@
+/* --------------------------------------------------------
+                       cp1_srcasm.cpp
+
+     Quelltextassembler: uebersetzt ein komplettes CP1-
+     Programm mit Labels zeilenweise in den Programm-
+     speicher (siehe cp1_srcasm.h).
+
+     Die Zeilen werden nach dem Ersetzen der Labels durch
+     Zahlenwerte mit assemble_line uebersetzt, Syntax und
+     Fehlercodes entsprechen also dem Zeilenassembler.
+
+     MCU: ATmega328p / Linux-Host
+
+     R. Seelig
+   -------------------------------------------------------- */
+
+#include "kosmos_cp1_v43.h"
+
+static uint8_t sa_isalpha(uint8_t ch)
+{
+  return ((ch >= 'a') && (ch <= 'z')) || (ch == '_');
+}
+
+static uint8_t sa_isalnum(uint8_t ch)
+{
+  return sa_isalpha(ch) || ((ch >= '0') && (ch <= '9'));
+}
+
+static uint8_t sa_isreg(char *name)
+{
+  if ((name[1]== 0) && (name[0] >= 'a') && (name[0] <= 'e')) return 1;     // a..e
+  if (!strcmp(name, "p1") || !strcmp(name, "p2")) return 1;
+  return 0;
+}
+
+static void sa_adderr(srcasm *sa, uint16_t line, uint8_t code, uint8_t sym)
+{
+  if (sa->erranz < sa_maxerr)
+  {
+    sa->err[sa->erranz].line= line;
+    sa->err[sa->erranz].code= code;
+    sa->err[sa->erranz].sym= sym;
+    sa->erranz++;
+  }
+  sa->errcnt++;
+}
+
+/* --------------------------------------------------
+                     srcasm_error
+
+     vermerkt einen Fehler in der aktuellen Zeile
+  -------------------------------------------------- */
+void srcasm_error(srcasm *sa, uint8_t code, uint8_t sym)
+{
+  sa_adderr(sa, sa->line, code, sym);
+}
+
+/* --------------------------------------------------
+                      sa_symbol
+
+     sucht ein Label in der Labeltabelle und legt es
+     an, falls es noch nicht vorhanden ist.
+
+     Rueckgabe: Index des Labels, 0xff wenn die
+                Tabelle voll ist
+  -------------------------------------------------- */
+static uint8_t sa_symbol(srcasm *sa, char *name)
+{
+  uint8_t i;
+
+  for (i= 0; i< sa->symanz; i++)
+    if (!strcmp(sa->sym[i].name, name)) return i;
+
+  if (sa->symanz >= sa_maxsym)
+  {
+    srcasm_error(sa, sa_err_symfull, 0xff);
+    return 0xff;
+  }
+  strcpy(sa->sym[i].name, name);
+  sa->sym[i].addr= 0;
+  sa->sym[i].defined= 0;
+  sa->sym[i].line= sa->line;
+  sa->symanz++;
+  return i;
+}
+
+/* --------------------------------------------------
+                      srcasm_init
+
+     loescht den Programmspeicher und bereitet das
+     Uebersetzen eines Quelltextes ab Adresse 0 vor
+  -------------------------------------------------- */
+void srcasm_init(srcasm *sa, kcomp *vcp1)
+{
+  uint16_t i;
+
+  memset(sa, 0, sizeof(srcasm));
+  sa->vcp1= vcp1;
+  for (i= 0; i< memsize; i++)
+    vcp1->mem[i]= 0;
+  cpu_invalidate_all(vcp1);
+}
+
+/* --------------------------------------------------
+                      srcasm_line
+
+     uebersetzt eine Quelltextzeile und traegt das
+     Programmwort in den Speicher ein. Fehler werden
+     in sa->err mit Zeilennummer vermerkt.
+
+     Hinweis: Der Originalstring wird zerstoert
+  -------------------------------------------------- */
+void srcasm_line(srcasm *sa, uint8_t *src)
+{
+  uint8_t  out[20];
+  char     name[sa_symlen];
+  uint8_t  *p, *q;
+  uint8_t  o, n, sym, fixsym, label, e;
+  uint16_t prgword;
+
+  sa->line++;
+
+  // Kommentar abschneiden und alles nach Kleinbuchstaben konvertieren
+  for (p= src; *p && (*p != ';'); p++)
+  {
+    *p= tolower(*p);
+    if (*p== '\t') *p= ' ';
+  }
+  *p= 0;
+  p= src;
+  while (*p== ' ') p++;
+
+  // Label-Definition "name:"
+  q= (uint8_t *)strchr((char *)p, ':');
+  if (q)
+  {
+    *q= 0;
+    n= 0;
+    while (sa_isalnum(*p) && (n < sa_symlen-1)) name[n++]= *p++;
+    name[n]= 0;
+    while (*p== ' ') p++;
+    if ((!n) || (!sa_isalpha(name[0])) || (*p) || sa_isreg(name))
+    {
+      srcasm_error(sa, sa_err_label, 0xff);
+      return;
+    }
+    sym= sa_symbol(sa, name);
+    if (sym== 0xff) return;
+    if (sa->sym[sym].defined== 1)
+    {
+      srcasm_error(sa, sa_err_dupsym, sym);
+      return;
+    }
+    sa->sym[sym].defined= 1;
+    sa->sym[sym].addr= sa->addr;
+    sa->sym[sym].line= sa->line;
+
+    p= q+1;
+    while (*p== ' ') p++;
+  }
+  if (!*p) return;
+
+  // Mnemonic uebernehmen, in den Operanden Labels durch Zahlen ersetzen
+  o= 0;
+  while (*p && (*p != ' ') && (o < sizeof(out)-1)) out[o++]= *p++;
+  while (*p== ' ') p++;
+  if (*p) out[o++]= ' ';                              // Leerzeichen nur nach dem Mnemonic
+
+  fixsym= 0xff; label= 0;
+  while (*p)
+  {
+    if (o > sizeof(out)-5) { srcasm_error(sa, sa_err_syntax, 0xff); return; }
+
+    if (sa_isalpha(*p))
+    {
+      n= 0;
+      while (sa_isalnum(*p))
+      {
+        if (n < sa_symlen-1) name[n]= *p;
+        n++; p++;
+      }
+      if (n > sa_symlen-1) { srcasm_error(sa, sa_err_label, 0xff); return; }
+      name[n]= 0;
+
+      if (sa_isreg(name))
+      {
+        for (n= 0; name[n]; n++) out[o++]= name[n];
+        continue;
+      }
+      if (label) { srcasm_error(sa, sa_err_syntax, 0xff); return; }   // nur ein Label je Zeile
+      label= 1;
+
+      sym= sa_symbol(sa, name);
+      if (sym== 0xff) return;
+      n= 0;
+      if (sa->sym[sym].defined== 1) n= sa->sym[sym].addr; else fixsym= sym;
+      out[o++]= (n / 100) + '0';
+      out[o++]= ((n / 10) % 10) + '0';
+      out[o++]= (n % 10) + '0';
+      continue;
+    }
+
+    if (*p== ' ') { p++; continue; }
+
+    if ((*p >= '0') && (*p <= '9'))                   // Zahl (auch hexadezimal mit 0x)
+    {
+      while (sa_isalnum(*p) && (o < sizeof(out)-1)) out[o++]= *p++;
+      continue;
+    }
+    out[o++]= *p++;
+  }
+  out[o]= 0;
+
+  // assemble_line zerlegt in Bestandteile zu max. 9 Zeichen
+  n= 0;
+  for (o= 0; out[o]; o++)
+  {
+    if ((out[o]== ' ') || (out[o]== ',')) n= 0; else n++;
+    if (n > 9) { srcasm_error(sa, sa_err_syntax, 0xff); return; }
+  }
+
+  e= assemble_line(&out[0], &prgword, sa->vcp1);
+  if (e== 6) return;                                  // nur Kommentar
+  if (e== 255)                                        // .org
+  {
+    if (fixsym != 0xff) { srcasm_error(sa, sa_err_org, fixsym); return; }
+    sa->addr= prgword & 0xff;
+    return;
+  }
+  if (e) { srcasm_error(sa, e, 0xff); return; }
+
+  if (sa->addr > (memsize-1))
+  {
+    if (sa->addr== memsize) srcasm_error(sa, sa_err_memfull, 0xff);   // nur einmal melden
+    sa->addr= memsize+1;
+    return;
+  }
+  if (fixsym != 0xff)
+  {
+    prgword= (prgword / 1000) * 1000 + fixsym;        // Labelnummer bis srcasm_finish im Datenbyte
+    sa->fixmap[sa->addr >> 3] |= 1 << (sa->addr & 7);
+  }
+  else
+  {
+    sa->fixmap[sa->addr >> 3] &= ~(1 << (sa->addr & 7));   // nach .org ueberschrieben
+  }
+  sa->vcp1->mem[sa->addr]= ((prgword / 1000) << 8) + (prgword % 1000);
+  sa->addr++;
+  sa->words++;
+}
+
+/* --------------------------------------------------
+                     srcasm_finish
+
+     zweiter Durchlauf: traegt die Adressen der
+     Vorwaertsreferenzen nach und meldet nicht
+     definierte Labels (mit der Zeile ihrer ersten
+     Verwendung).
+
+     Rueckgabe: Anzahl Fehler
+  -------------------------------------------------- */
+uint16_t srcasm_finish(srcasm *sa)
+{
+  kcomp    *vcp1;
+  sasym    *s;
+  uint8_t  sym;
+  uint16_t a;
+
+  vcp1= sa->vcp1;
+  for (a= 0; a< memsize; a++)
+  {
+    if (!(sa->fixmap[a >> 3] & (1 << (a & 7)))) continue;
+    sym= vcp1->mem[a] & 0xff;
+    s= &sa->sym[sym];
+    vcp1->mem[a] &= 0xff00;
+    if (s->defined== 1)
+    {
+      vcp1->mem[a] |= s->addr;
+    }
+    else
+    if (s->defined== 0)
+    {
+      sa_adderr(sa, s->line, sa_err_undef, sym);
+      s->defined= 2;                                  // nur einmal melden
+    }
+  }
+  cpu_invalidate_all(vcp1);
+  vcp1->addr= (sa->addr < memsize) ? sa->addr : memsize-1;
+  vcp1->pc= 0;
+  return sa->errcnt;
+}
+
+/* --------------------------------------------------
+                     srcasm_errtext
+
+     Rueckgabe: Zeiger auf Fehlertext im Flash
+  -------------------------------------------------- */
+const char *srcasm_errtext(uint8_t code)
+{
+  switch (code)
+  {
+    case  2               : return PSTR("datavalue too large, max. 255");
+    case  3               : return PSTR("two numeric operands");
+    case  5               : return PSTR("unknown mnemonic");
+    case  sa_err_dupsym   : return PSTR("label already defined");
+    case  sa_err_symfull  : return PSTR("too many labels");
+    case  sa_err_syntax   : return PSTR("line too long / syntax error");
+    case  sa_err_memfull  : return PSTR("program memory full");
+    case  sa_err_undef    : return PSTR("undefined label");
+    case  sa_err_label    : return PSTR("invalid label name");
+    case  sa_err_org      : return PSTR(".org needs a defined address");
+    case  sa_err_overflow : return PSTR("receive buffer overflow");
+    default               : return PSTR("error");
+  }
+}
@@ -0,0 +1,90 @@
+/* ------------------------------------------------------------------
+                            cp1_srcasm.h
+
+     Header zum Quelltextassembler: uebersetzt ein komplettes
+     CP1-Programm zeilenweise direkt in den Programmspeicher
+     (Terminal [b]ulk upload)
+
+     Erweiterungen gegenueber dem Zeilenassembler:
+
+       label:           Sprungmarke / Adresse, auch allein in
+                        einer Zeile
+       jmp label        ein Label kann ueberall dort stehen, wo
+       mov a,@label     ein Datum / eine Adresse erwartet wird,
+       db label         auch vor seiner Definition (Vorwaerts-
+                        referenz)
+       .org adr         .org akzeptiert nur bereits bekannte Labels
+
+     Der Quelltext wird nicht zwischengespeichert: jede Zeile
+     wird sofort uebersetzt. Bei Vorwaertsreferenzen steht im
+     Datenbyte des Programmworts vorerst die Nummer des Labels,
+     die Adresse wird in einer Bitmap (1 Bit je Programmwort)
+     vermerkt. Der zweite Durchlauf (srcasm_finish) traegt ueber
+     diese Bitmap die Adressen nach.
+
+     RAM: sizeof(srcasm) = 316 Bytes (20 Labels zu 12 Bytes,
+     32 Bytes Bitmap, 8 Fehler zu 4 Bytes). Die Struktur liegt
+     waehrend des Uploads auf dem Stack, mit Zeilenpuffer und
+     den Aufrufen srcasm_line / assemble_line belegt der
+     Upload ca. 500 Bytes Stack oberhalb von terminal_mode.
+     Kleinere Werte fuer sa_maxsym / sa_maxerr sparen 12 bzw.
+     4 Bytes je Eintrag.
+
+     MCU  :   ATmega328p / Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_srcasm
+  #define in_cp1_srcasm
+
+  #define  sa_maxsym          20     // max. Anzahl Labels
+  #define  sa_symlen          8      // max. Laenge Labelname inkl. Endekennung
+  #define  sa_maxerr          8      // max. Anzahl gespeicherter Fehlermeldungen
+  #define  sa_linelen         48     // max. Laenge einer Quelltextzeile
+
+  // Fehlercodes, 2, 3 und 5 sind die von assemble_line
+  #define  sa_err_dupsym      20     // Label mehrfach definiert
+  #define  sa_err_symfull     21     // zu viele Labels
+  #define  sa_err_syntax      23     // Zeile zu lang / fehlerhaft
+  #define  sa_err_memfull     24     // Programm groesser als Speicher
+  #define  sa_err_undef       25     // Label nicht definiert
+  #define  sa_err_label       26     // ungueltiger Labelname
+  #define  sa_err_org         27     // .org mit unbekanntem Label
+  #define  sa_err_overflow    28     // Empfangspuffer uebergelaufen
+
+  typedef struct sasym
+  {
+    char     name[sa_symlen];
+    uint8_t  addr;
+    uint8_t  defined;
+    uint16_t line;                   // Zeile der Definition bzw. ersten Verwendung
+  } sasym;
+
+  typedef struct saerr
+  {
+    uint16_t line;
+    uint8_t  code;
+    uint8_t  sym;                    // Label bei sa_err_undef, sonst 0xff
+  } saerr;
+
+  typedef struct srcasm
+  {
+    kcomp    *vcp1;
+    uint16_t line;                   // aktuelle Zeilennummer
+    uint16_t addr;                   // aktuelle Programmadresse
+    uint16_t words;                  // Anzahl uebersetzter Programmworte
+    uint16_t errcnt;                 // Anzahl Fehler (auch nicht gespeicherte)
+    uint8_t  symanz, erranz;
+    sasym    sym[sa_maxsym];
+    uint8_t  fixmap[memsize / 8];    // Bit gesetzt: Datenbyte enthaelt Labelnummer
+    saerr    err[sa_maxerr];
+  } srcasm;
+
+  void srcasm_init(srcasm *sa, kcomp *vcp1);
+  void srcasm_line(srcasm *sa, uint8_t *src);
+  void srcasm_error(srcasm *sa, uint8_t code, uint8_t sym);
+  uint16_t srcasm_finish(srcasm *sa);
+  const char *srcasm_errtext(uint8_t code);
+
+#endif
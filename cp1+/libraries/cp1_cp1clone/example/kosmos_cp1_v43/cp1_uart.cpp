@@ -16,6 +16,7 @@
 
 #include <stdio.h>
 #include <avr/pgmspace.h>
+#include <avr/interrupt.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -346,6 +347,29 @@ void uart_uint16out(uint16_t value, uint8_t dp)
   }
 }
 
+/*  ---------------------------------------------------------
+                         uart_uint32out
+
+      gibt einen 32-Bit Integer dezimal (10-stellig) auf dem
+      UART aus, fuehrende Nullen werden als Leerzeichen
+      ausgegeben
+    --------------------------------------------------------- */
+void uart_uint32out(uint32_t value)
+{
+  uint32_t teiler = 1000000000;
+  uint8_t  i, z, lz;
+
+  lz= 1;
+  for (i= 0; i< 10; i++)
+  {
+    z= value / teiler;
+    if (z || (i== 9)) lz= 0;
+    if (lz) uart_putchar(' '); else uart_putchar(z + '0');
+    value -= z * teiler;
+    teiler /= 10;
+  }
+}
+
 /*  ---------------------------------------------------------
                          uart_uint8out
 
@@ -364,3 +388,82 @@ void uart_uint8out(uint8_t value)
     teiler /= 10;
   }
 }
+
+/*  ---------------------------------------------------------
+        interruptgesteuerter Empfang in einen Ringpuffer
+
+      fuer Uebertragungen ohne Handshake (Quelltextupload),
+      bei denen zwischen zwei Zeichen keine Zeit zum Pollen
+      bleibt. Waehrend des Empfangs sind die Interrupts
+      global freigegeben, uart_rxint_disable sperrt sie
+      wieder.
+    --------------------------------------------------------- */
+
+static volatile uint8_t rxbuf[uart_rxbufsize];
+static volatile uint8_t rxwr, rxrd, rxovl;
+
+ISR (USART_RX_vect)
+{
+  uint8_t ch, n;
+
+  ch= UDR0;
+  n= (rxwr + 1) & (uart_rxbufsize-1);
+  if (n == rxrd)
+  {
+    rxovl= 1;                              // Puffer voll, Zeichen verwerfen
+    return;
+  }
+  rxbuf[rxwr]= ch;
+  rxwr= n;
+}
+
+void uart_rxint_enable(void)
+{
+  while (uart_ischar()) (void)UDR0;
+  rxwr= 0; rxrd= 0; rxovl= 0;
+  UCSR0B |= (1<<RXCIE0);
+  sei();
+}
+
+void uart_rxint_disable(void)
+{
+  UCSR0B &= ~(1<<RXCIE0);
+  cli();
+}
+
+/* --------------------------------------------------
+                     uart_rxavail
+
+     Anzahl Zeichen im Empfangspuffer
+   -------------------------------------------------- */
+uint8_t uart_rxavail(void)
+{
+  return (rxwr - rxrd) & (uart_rxbufsize-1);
+}
+
+/* --------------------------------------------------
+                      uart_rxget
+
+     Zeichen aus dem Empfangspuffer lesen, 0 wenn der
+     Puffer leer ist
+   -------------------------------------------------- */
+uint8_t uart_rxget(void)
+{
+  uint8_t ch;
+
+  if (rxrd == rxwr) return 0;
+  ch= rxbuf[rxrd];
+  rxrd= (rxrd + 1) & (uart_rxbufsize-1);
+  return ch;
+}
+
+/* --------------------------------------------------
+                    uart_rxoverflow
+
+     1 wenn seit uart_rxint_enable Zeichen verloren
+     gegangen sind
+   -------------------------------------------------- */
+uint8_t uart_rxoverflow(void)
+{
+  return rxovl;
+}
@@ -20,6 +20,8 @@
 
   #define  echo_enable           0       // 0 : es wird bei einer Eingabe kein Echo gesendet
                                          // 1 : Echo wird gesendet
+  #define  uart_rxbufsize        32      // Empfangspuffer fuer interruptgesteuerten
+                                         // Empfang, muss Zweierpotenz sein
   #include <stdio.h>
   #include <avr/pgmspace.h>
   #include <stdint.h>
@@ -41,6 +43,13 @@
   uint8_t uart_readu8int(uint8_t *value);
   void uart_uint16out(uint16_t value, uint8_t dp);
   void uart_uint8out(uint8_t value);
+  void uart_uint32out(uint32_t value);
+
+  void uart_rxint_enable(void);
+  void uart_rxint_disable(void);
+  uint8_t uart_rxavail(void);
+  uint8_t uart_rxget(void);
+  uint8_t uart_rxoverflow(void);
   
 
   #define prints(tx)            uart_putromstring(PSTR(tx))         // Benutzung: prints("Hallo Welt\n\r");
@@ -0,0 +1,98 @@
+/* ------------------------------------------------------------------
+                            cp1_asm.cpp
+
+     uebersetzt einen CP1-Quelltext mit Labels mit dem Quelltext-
+     assembler des Terminals (../cp1_srcasm.cpp) und gibt ein
+     Listing und die Fehlermeldungen aus. Die Zeilen werden wie
+     beim Upload ueber den UART einzeln uebergeben.
+
+         ./cp1_asm datei.asm       Listing
+         ./cp1_asm -q datei.asm    nur Zusammenfassung und Fehler
+         make check                uebersetzt cp1_demo.asm
+
+     Rueckgabe 0, wenn der Quelltext fehlerfrei ist.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <sys/time.h>
+#include "../kosmos_cp1_v43.h"
+
+static kcomp  cp1;
+static srcasm sa;
+
+static double usec(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+  return tv.tv_sec * 1e6 + tv.tv_usec;
+}
+
+int main(int argc, char **argv)
+{
+  FILE     *f;
+  char     buf[256];
+  uint8_t  line[sa_linelen], dis[20];
+  int      quiet, i, l;
+  uint16_t a;
+  double   t0, t;
+
+  quiet= (argc > 2) && !strcmp(argv[1], "-q");
+  if (argc < 2 + quiet)
+  {
+    fprintf(stderr, "usage: %s [-q] file.asm\n", argv[0]);
+    return 2;
+  }
+  f= fopen(argv[1 + quiet], "r");
+  if (!f)
+  {
+    perror(argv[1 + quiet]);
+    return 2;
+  }
+
+  t0= usec();
+  srcasm_init(&sa, &cp1);
+  while (fgets(buf, sizeof(buf), f))
+  {
+    l= strlen(buf);
+    while (l && ((buf[l-1] == '\n') || (buf[l-1] == '\r'))) buf[--l]= 0;
+    if (strchr(buf, ';')) { *strchr(buf, ';')= 0; l= strlen(buf); }    // wie beim Upload
+    if (!strncmp(buf, ".end", 4)) break;
+    if (l > sa_linelen-1)
+    {
+      sa.line++;
+      srcasm_error(&sa, sa_err_syntax, 0xff);
+      continue;
+    }
+    strcpy((char *)line, buf);
+    srcasm_line(&sa, line);
+  }
+  fclose(f);
+  srcasm_finish(&sa);
+  t= usec() - t0;
+
+  if (!quiet)
+  {
+    for (a= 0; a< sa.addr && a< memsize; a++)
+    {
+      disassemble_prgword(dis, cp1.mem[a]);
+      printf("  %3d: %-16s %03d.%03d", a, dis, cp1.mem[a] >> 8, cp1.mem[a] & 0xff);
+      for (i= 0; i< sa.symanz; i++)
+        if ((sa.sym[i].defined == 1) && (sa.sym[i].addr == a)) printf("   %s", sa.sym[i].name);
+      printf("\n");
+    }
+  }
+
+  printf("  lines: %u  words: %u  labels: %u  errors: %u  (%.1f us/line)\n",
+         sa.line, sa.words, sa.symanz, sa.errcnt, sa.line ? t / sa.line : 0.0);
+  for (i= 0; i< sa.erranz; i++)
+  {
+    printf("  line %u: %s", sa.err[i].line, srcasm_errtext(sa.err[i].code));
+    if (sa.err[i].sym != 0xff) printf(" \"%s\"", sa.sym[sa.err[i].sym].name);
+    printf("\n");
+  }
+  return sa.errcnt ? 1 : 0;
+}
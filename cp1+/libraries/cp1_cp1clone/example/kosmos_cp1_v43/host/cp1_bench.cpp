@@ -0,0 +1,267 @@
+/* ------------------------------------------------------------------
+                            cp1_bench.cpp
+
+     Benchmark der virtuellen CPU des Kosmos CP1 auf einem
+     Linux-Host.
+
+     Die Referenzprogramme werden mit dem Zeilenassembler des
+     CP1-Clones (assemble_line) uebersetzt und anschliessend so
+     oft mit cpu_run ausgefuehrt, bis die Mindestlaufzeit er-
+     reicht ist. Ausgegeben werden ausgefuehrte virtuelle Befehle
+     pro Sekunde und die Zeit pro Opcode in ns.
+
+     Uebersetzen und starten:
+
+         make
+         ./cp1_bench [Mindestlaufzeit in ms]
+
+     cp1_bench_thr ist dasselbe Programm mit dem Interpreter
+     mit Sprungtabelle (cpu_threaded= 1), cp1_bench_prof
+     zeichnet ein Ausfuehrungsprofil auf (cpu_profile= 1).
+     "make bench" startet alle Varianten zum Vergleich.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <time.h>
+
+#include "../kosmos_cp1_v43.h"
+
+extern uint64_t hal_instrcnt;
+
+typedef struct benchprg
+{
+  const char *name;
+  const char **src;
+} benchprg;
+
+/* ---------------------------------------------------------
+                       Referenzprogramme
+   --------------------------------------------------------- */
+
+// Zaehlschleife: innere Schleife mit djnz, aeussere mit
+// Register B, dec, cpi und jz
+static const char *prg_loop[] =
+{
+  "mvi b,200",            // 00
+  "mvi a,255",            // 01
+  "djnz a,2",             // 02
+  "mov a,b",              // 03
+  "dec a",                // 04
+  "mov b,a",              // 05
+  "cpi a,0",              // 06
+  "jz 9",                 // 07
+  "jmp 1",                // 08
+  "hlt",                  // 09
+  0
+};
+
+// Unterprogrammaufrufe mit call / ret
+static const char *prg_call[] =
+{
+  "mvi b,250",            // 00
+  "call 10",              // 01
+  "mov a,b",              // 02
+  "dec a",                // 03
+  "mov b,a",              // 04
+  "cpi a,0",              // 05
+  "jz 8",                 // 06
+  "jmp 1",                // 07
+  "hlt",                  // 08
+  ".org 10",
+  "mvi a,5",              // 10
+  "adi a,3",              // 11
+  "call 14",              // 12
+  "ret",                  // 13
+  "sbi a,1",              // 14
+  "ret",                  // 15
+  0
+};
+
+// Multiplikation
+static const char *prg_mul[] =
+{
+  "mvi c,250",            // 00
+  "mvi a,3",              // 01
+  "mvi b,7",              // 02
+  "mul a,b",              // 03
+  "mov b,a",              // 04
+  "mvi a,2",              // 05
+  "mul a,b",              // 06
+  "mov a,c",              // 07
+  "dec a",                // 08
+  "mov c,a",              // 09
+  "cpi a,0",              // 10
+  "jz 13",                // 11
+  "jmp 1",                // 12
+  "hlt",                  // 13
+  0
+};
+
+// Speicherzugriffe (lda, abs, add, cmp, indirekt)
+static const char *prg_mem[] =
+{
+  "mvi a,200",            // 00
+  "mov 40,a",             // 01   Zaehler in mem[40]
+  "mov a,41",             // 02
+  "add a,42",             // 03
+  "mov 41,a",             // 04
+  "mov a,@43",            // 05
+  "mov @44,a",            // 06
+  "mov a,40",             // 07
+  "sbi a,1",              // 08
+  "mov 40,a",             // 09
+  "cmp a,42",             // 10
+  "jz 13",                // 11
+  "jmp 2",                // 12
+  "hlt",                  // 13
+  ".org 40",
+  "db 0",                 // 40
+  "db 0",                 // 41
+  "db 0",                 // 42
+  "db 41",                // 43   Zeiger auf mem[41]
+  "db 45",                // 44   Zeiger auf mem[45]
+  0
+};
+
+static const benchprg benchlist[] =
+{
+  { "loop/djnz", prg_loop },
+  { "call/ret",  prg_call },
+  { "mul",       prg_mul  },
+  { "memory",    prg_mem  },
+  { 0, 0 }
+};
+
+kcomp cp1;
+
+/* ---------------------------------------------------------
+                          getnanos
+
+     liefert eine monotone Zeit in Nanosekunden
+   --------------------------------------------------------- */
+static uint64_t getnanos(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ull) + ts.tv_nsec;
+}
+
+/* ---------------------------------------------------------
+                         prg_assemble
+
+     uebersetzt ein Referenzprogramm in den Speicher der
+     virtuellen CPU. Rueckgabe 0 bei Erfolg.
+   --------------------------------------------------------- */
+static uint8_t prg_assemble(kcomp *vcp1, const char **src)
+{
+  uint8_t  line[20];
+  uint16_t prgword;
+  uint8_t  e;
+  int      i;
+
+  cpu_reset(vcp1);
+  for (i= 0; src[i]; i++)
+  {
+    strncpy((char *)line, src[i], sizeof(line)-1);
+    line[sizeof(line)-1]= 0;
+    e= assemble_line(&line[0], &prgword, vcp1);
+    if (e== 255)                                         // .org
+    {
+      vcp1->addr= prgword & 0xff;
+      continue;
+    }
+    if (e)
+    {
+      printf("  assemble error %d in line \"%s\"\n", e, src[i]);
+      return e;
+    }
+    vcp1->mem[vcp1->addr]= ((prgword / 1000) << 8) + (prgword % 1000);
+    vcp1->addr++;
+  }
+  return 0;
+}
+
+/* ---------------------------------------------------------
+                          prg_start
+
+     setzt die Register fuer einen neuen Programmlauf,
+     der Speicherinhalt bleibt erhalten
+   --------------------------------------------------------- */
+static void prg_start(kcomp *vcp1, const uint16_t *image)
+{
+  vcp1->pc= 0;
+  vcp1->a= 0; vcp1->b= 0; vcp1->c= 0; vcp1->d= 0; vcp1->e= 0;
+  vcp1->psw= 0;
+  vcp1->sp= 7;
+  memcpy(vcp1->mem, image, sizeof(vcp1->mem));
+  cpu_invalidate_all(vcp1);
+  err= 0;
+}
+
+int main(int argc, char **argv)
+{
+  uint16_t image[memsize];
+  uint64_t mintime, t0, t1, instr;
+  uint32_t runs;
+  int      i;
+
+  mintime= 500;
+  if (argc > 1) mintime= atoi(argv[1]);
+  mintime *= 1000000ull;
+
+  printf("\n CP1 virtual CPU benchmark (cpu_threaded= %d, cpu_profile= %d)\n\n",
+         cpu_threaded, cpu_profile);
+  printf("  program       runs     instructions     instr/s        ns/opcode\n");
+  printf("  ------------------------------------------------------------------\n");
+
+  for (i= 0; benchlist[i].name; i++)
+  {
+    if (prg_assemble(&cp1, benchlist[i].src)) return 1;
+    memcpy(image, cp1.mem, sizeof(image));
+
+    // Leerlauf, prueft dass das Programm regulaer mit hlt endet
+    prg_start(&cp1, image);
+    cpu_run(&cp1, 0);
+    if (err)
+    {
+      printf("  %-12s  stopped with error %d at pc %d\n", benchlist[i].name, err, cp1.pc);
+      return 1;
+    }
+
+    #if (cpu_profile == 1)
+      prof_clear();
+    #endif
+    runs= 0; hal_instrcnt= 0;
+    t0= getnanos();
+    do
+    {
+      prg_start(&cp1, image);
+      cpu_run(&cp1, 0);
+      runs++;
+      t1= getnanos();
+    } while ((t1 - t0) < mintime);
+
+    instr= hal_instrcnt + runs;                          // hlt fragt die Tastatur nicht ab
+    printf("  %-12s %6u  %15llu  %12.0f  %12.2f\n", benchlist[i].name, runs,
+           (unsigned long long)instr,
+           (double)instr * 1e9 / (double)(t1 - t0),
+           (double)(t1 - t0) / (double)instr);
+
+    #if (cpu_profile == 1)
+    {
+      uint64_t pcnt= 0;
+      int      opc;
+
+      // Gegenprobe: jeder ausgefuehrte Befehl muss im Profil stehen
+      for (opc= 1; opc<= opcmax; opc++) pcnt += prof.opccnt[opc];
+      if (pcnt != instr) printf("  profile counted %llu instructions\n", (unsigned long long)pcnt);
+    }
+    #endif
+  }
+  printf("\n");
+  return 0;
+}
@@ -0,0 +1,40 @@
+; ------------------------------------------------------------
+;   cp1_demo.asm
+;
+;   Lauflicht auf P1 mit Unterprogramm und Tabelle, Testquelltext
+;   fuer den Quelltextassembler (Terminal [b]ulk upload,
+;   host/cp1_asm)
+; ------------------------------------------------------------
+
+        jmp   start             ; Vorwaertsreferenz
+
+; Tabelle der Bitmuster, mit 0 abgeschlossen
+muster: db    0x01
+        db    0x02
+        db    4
+        db    8
+        db    0
+ptr:    db    muster            ; Zeiger in die Tabelle
+
+start:  mvi   a,muster
+        mov   ptr,a
+loop:   mov   a,@ptr            ; Bitmuster ueber den Zeiger lesen
+        cpi   a,0
+        jz    start
+        out   p1
+        call  pause
+        mov   a,ptr
+        inc   a
+        mov   ptr,a
+        jmp   loop
+
+pause:  mvi   b,5
+p_l:    cdel  20
+        mov   a,b
+        dec   a
+        mov   b,a
+        cpi   a,0
+        jz    p_ende
+        jmp   p_l
+p_ende: ret
+.end
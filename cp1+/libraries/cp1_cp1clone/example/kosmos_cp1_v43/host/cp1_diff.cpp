@@ -0,0 +1,529 @@
+/* ------------------------------------------------------------------
+                            cp1_diff.cpp
+
+     Differenzpruefung der beiden Interpreter der virtuellen CPU:
+     cpu_run (switch, cp1_cpu_v43.cpp) und cpu_run_thr (Sprung-
+     tabelle, cp1_cpu_thr.cpp).
+
+     Beide Interpreter arbeiten im Gleichschritt (Einzelschritt-
+     modus) je eine eigene Kopie desselben Programms ab. Nach
+     jedem Schritt muessen Register, psw, sp, Stack, Speicher,
+     Fehlercode (err) und die nachgebildeten Ports / Anzeige
+     uebereinstimmen.
+
+     Geprueft werden ein kurzes Referenzprogramm sowie
+     Zufallsprogramme, die alle Opcodes (auch nicht belegte),
+     ungueltige Klemmennummern, Datenworte > 255, selbstmodi-
+     fizierenden Code und Stackueber- / unterlaeufe enthalten.
+
+     Bei cpu_sched == 1 wird cpu_step_n mit verschiedenen Zeit-
+     scheiben gegen cpu_run im Einzelschritt verglichen (bei
+     Zeitscheiben zu einem Befehl nach jedem Schritt, sonst
+     nach hlt / Fehler), ebenso die Zeitscheiben mit der
+     Sprungtabelle (cpu_step_thr, wie cpu_step_n bei
+     cpu_threaded == 1). Weckzeiten werden dabei sofort als
+     abgelaufen behandelt. Bei cpu_profile == 1 wird geprueft,
+     dass die in einer Zeitscheibe verschlafene Zeit von cdel
+     im Profil erscheint.
+
+     Bei cpu_debug == 1 wird zusaetzlich die Variante von cpu_run
+     mit Pruefungen (nie erfuellte Haltebedingung) gegen cpu_run_thr
+     verglichen und das Anhalten an Haltepunkt, Watchpoint und
+     Bedingung am Referenzprogramm geprueft.
+
+         make check
+         ./cp1_diff [Anzahl Zufallsprogramme] [Startwert]
+
+     Rueckgabe 0, wenn keine Abweichung gefunden wurde.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "../kosmos_cp1_v43.h"
+
+#if (cpu_threaded == 1)
+  #error "cp1_diff benoetigt beide Interpreter, ohne cpu_threaded uebersetzen"
+#endif
+
+extern uint8_t  hal_p1, hal_p2;
+extern uint32_t hal_display;
+
+#define maxsteps      3000
+
+// von beiden Interpretern beeinflusster Zustand ausserhalb von kcomp
+typedef struct halstate
+{
+  uint8_t  err;
+  uint8_t  p1, p2;
+  uint32_t display;
+} halstate;
+
+kcomp cpa, cpb, cpref;
+uint32_t rndval;
+
+/* ---------------------------------------------------------
+                             rnd
+
+     Pseudozufallszahl (xorshift32)
+   --------------------------------------------------------- */
+static uint32_t rnd(void)
+{
+  rndval ^= rndval << 13;
+  rndval ^= rndval >> 17;
+  rndval ^= rndval << 5;
+  return rndval;
+}
+
+static void hal_save(halstate *hs)
+{
+  hs->err= err;
+  hs->p1= hal_p1;
+  hs->p2= hal_p2;
+  hs->display= hal_display;
+}
+
+static void hal_restore(halstate *hs)
+{
+  err= hs->err;
+  hal_p1= hs->p1;
+  hal_p2= hs->p2;
+  hal_display= hs->display;
+}
+
+/* ---------------------------------------------------------
+                          cpu_compare
+
+     vergleicht den architektonischen Zustand zweier
+     virtueller CPUs, Rueckgabe 0 bei Gleichheit
+   --------------------------------------------------------- */
+static uint8_t cpu_compare(kcomp *x, kcomp *y)
+{
+  if ((x->pc != y->pc) || (x->a != y->a) || (x->sp != y->sp) || (x->psw != y->psw)) return 1;
+  if ((x->b != y->b) || (x->c != y->c) || (x->d != y->d) || (x->e != y->e)) return 1;
+  if (memcmp(x->stack, y->stack, sizeof(x->stack))) return 1;
+  if (memcmp(x->mem, y->mem, sizeof(x->mem))) return 1;
+  return 0;
+}
+
+static uint8_t hal_compare(halstate *x, halstate *y)
+{
+  return (x->err != y->err) || (x->p1 != y->p1) || (x->p2 != y->p2) || (x->display != y->display);
+}
+
+static void cpu_print(const char *name, kcomp *vcp1, halstate *hs)
+{
+  printf("    %-6s pc=%3d a=%3d b=%3d c=%3d d=%3d e=%3d psw=%02x sp=%d err=%d p1=%02x p2=%02x\n",
+         name, vcp1->pc, vcp1->a, vcp1->b, vcp1->c, vcp1->d, vcp1->e, vcp1->psw, vcp1->sp,
+         hs->err, hs->p1, hs->p2);
+}
+
+/* ---------------------------------------------------------
+                           prg_random
+
+     erzeugt ein Zufallsprogramm im Speicher von vcp1
+   --------------------------------------------------------- */
+static void prg_random(kcomp *vcp1)
+{
+  uint16_t i, opc, data;
+
+  cpu_reset(vcp1);
+  for (i= 0; i< memsize; i++)
+  {
+    switch (rnd() % 8)
+    {
+      case 0 :                                           // Datum, kein Code
+        vcp1->mem[i]= rnd() & 0xff;
+        break;
+      case 1 :                                           // beliebiges Wort (auch opc > opcmax)
+        vcp1->mem[i]= rnd() & 0xffff;
+        break;
+      default :
+        opc= (rnd() % opcmax) + 1;
+        if (opc== 1) opc= 4;                             // nicht zu viele hlt
+        data= rnd() & 0xff;
+        if ((opc >= 16) && (opc <= 18)) data= rnd() % 10; // Klemmennummern (9 ist ungueltig)
+        vcp1->mem[i]= (opc << 8) | data;
+        break;
+    }
+  }
+  vcp1->a= rnd(); vcp1->b= rnd(); vcp1->c= rnd(); vcp1->d= rnd(); vcp1->e= rnd();
+}
+
+/* ---------------------------------------------------------
+                          run_lockstep
+
+     fuehrt das Programm in cpa mit beiden Interpretern
+     schrittweise aus, bis ein Fehler auftritt oder
+     maxsteps erreicht ist.
+
+     Rueckgabe: 0 = kein Unterschied
+   --------------------------------------------------------- */
+static uint8_t run_lockstep(const char *name, uint32_t *steps)
+{
+  halstate hs0, hsa, hsb;
+  uint32_t n;
+
+  memcpy(&cpb, &cpa, sizeof(kcomp));
+  cpu_invalidate_all(&cpa);
+  cpu_invalidate_all(&cpb);
+  err= 0; hal_p1= 0; hal_p2= 0; hal_display= 0;
+
+  for (n= 0; n< maxsteps; n++)
+  {
+    hal_save(&hs0);
+    cpu_run(&cpa, 1);
+    hal_save(&hsa);
+    hal_restore(&hs0);
+    cpu_run_thr(&cpb, 1);
+    hal_save(&hsb);
+    (*steps)++;
+
+    if (cpu_compare(&cpa, &cpb) || hal_compare(&hsa, &hsb))
+    {
+      printf("  %s: difference after step %u\n", name, n+1);
+      cpu_print("switch", &cpa, &hsa);
+      cpu_print("thr", &cpb, &hsb);
+      return 1;
+    }
+    if (err) break;
+  }
+  return 0;
+}
+
+#if (cpu_sched == 1)
+
+/* ---------------------------------------------------------
+                          step_n_thr
+
+     wie cpu_step_n, die Befehle fuehrt cpu_step_thr aus
+     (cpu_step_n bei cpu_threaded == 1)
+   --------------------------------------------------------- */
+static uint8_t step_n_thr(kcomp *vcp1, uint16_t budget)
+{
+  if (cpu_slicestate== cpu_sleep)
+  {
+    if ((int32_t)(hal_millis() - cpu_wake) < 0) return cpu_sleep;
+    prof_wake();
+    cpu_slicestate= cpu_busy;
+  }
+  cpu_sliced= 1;
+  cpu_step_thr(vcp1, budget);
+  cpu_sliced= 0;
+  if (err) cpu_slicestate= cpu_halt;
+  return cpu_slicestate;
+}
+
+/* ---------------------------------------------------------
+                          run_sliced
+
+     fuehrt das Programm in cpa mit cpu_run schrittweise
+     und in cpb mit step (cpu_step_n oder step_n_thr) in
+     Zeitscheiben zu budget Befehlen aus, bis hlt oder ein
+     Fehler auftritt.
+     Programme, die nach maxsteps nicht beendet sind,
+     werden bei budget > 1 nicht verglichen.
+
+     Rueckgabe: 0 = kein Unterschied
+   --------------------------------------------------------- */
+static uint8_t run_sliced(const char *name, uint8_t (*step)(kcomp *, uint16_t), uint16_t budget,
+                          uint32_t *steps)
+{
+  halstate hs0, hsa, hsb;
+  uint32_t n;
+  uint8_t  state, hlt;
+
+  memcpy(&cpb, &cpa, sizeof(kcomp));
+  cpu_invalidate_all(&cpa);
+  cpu_invalidate_all(&cpb);
+  err= 0; hal_p1= 0; hal_p2= 0; hal_display= 0;
+  hal_save(&hs0);
+  cpu_slicestate= cpu_halt;
+  cpu_dispreq= 0;
+
+  for (n= 0; n< maxsteps; n++)
+  {
+    hlt= ((cpa.mem[cpa.pc] >> 8) == 1);
+    cpu_run(&cpa, 1);
+    (*steps)++;
+    if (budget != 1) { if (err || hlt) break; else continue; }
+
+    hal_save(&hsa);
+    hal_restore(&hs0);
+    state= step(&cpb, 1);
+    if (cpu_dispreq) { hal_showacc(cpu_dispval); cpu_dispreq= 0; }
+    if (state== cpu_sleep) cpu_wake= hal_millis();
+    hal_save(&hsb);
+    hal_save(&hs0);
+
+    if (cpu_compare(&cpa, &cpb) || hal_compare(&hsa, &hsb) || ((state== cpu_halt) != (err || hlt)))
+    {
+      printf("  %s: difference after step %u (slice 1, state %d)\n", name, n+1, state);
+      cpu_print("run", &cpa, &hsa);
+      cpu_print("step_n", &cpb, &hsb);
+      return 1;
+    }
+    if (state== cpu_halt) return 0;
+  }
+  if ((budget== 1) || (n== maxsteps)) return 0;
+
+  hal_save(&hsa);
+  hal_restore(&hs0);
+  for (n= 0; n< maxsteps; n++)
+  {
+    state= step(&cpb, budget);
+    if (cpu_dispreq) { hal_showacc(cpu_dispval); cpu_dispreq= 0; }
+    if (state== cpu_halt) break;
+    if (state== cpu_sleep) cpu_wake= hal_millis();
+  }
+  hal_save(&hsb);
+
+  if (cpu_compare(&cpa, &cpb) || hal_compare(&hsa, &hsb))
+  {
+    printf("  %s: different final state (slice %u)\n", name, budget);
+    cpu_print("run", &cpa, &hsa);
+    cpu_print("step_n", &cpb, &hsb);
+    return 1;
+  }
+  return 0;
+}
+
+#if (cpu_profile == 1)
+
+/* ---------------------------------------------------------
+                         prof_sleepcheck
+
+     cdel 30 in Zeitscheiben (mit echter Weckzeit): die
+     verschlafene Zeit muss im Profil unter cdel erscheinen
+   --------------------------------------------------------- */
+static uint8_t prof_sleepcheck(uint8_t (*step)(kcomp *, uint16_t))
+{
+  uint8_t i;
+
+  cpu_reset(&cpa);
+  cpa.mem[0]= (3 << 8) | 30;                   // cdel 30
+  cpa.mem[1]= (1 << 8);                        // hlt
+  cpu_invalidate_all(&cpa);
+  prof_clear();
+  err= 0;
+  cpu_slicestate= cpu_halt;
+  for (i= 0; i< 200; i++)
+  {
+    if (step(&cpa, 64) == cpu_halt) break;
+    usleep(1000);
+  }
+  if ((err != 0) || (prof.delay_cnt != 1) || (prof.delay_ms < 30) || (prof.delay_ms > 200))
+  {
+    printf("  profile, cdel in time slice: err=%d delay_cnt=%u delay_ms=%u\n",
+           err, prof.delay_cnt, (unsigned)prof.delay_ms);
+    return 1;
+  }
+  return 0;
+}
+
+#endif
+
+#endif
+
+#if (cpu_debug == 1)
+
+/* ---------------------------------------------------------
+                          dbg_stopat
+
+     startet das Programm in cpa ab pc und erwartet einen
+     Halt mit Grund hit am Befehl hitpc
+   --------------------------------------------------------- */
+static uint8_t dbg_stopat(const char *name, uint8_t pc, uint8_t hit, uint8_t hitpc)
+{
+  cpa.pc= pc;
+  err= 0;
+  dbg.hit= 0;
+  cpu_run(&cpa, 0);
+  if ((err != dbg_errstop) || (dbg.hit != hit) || (dbg.hitpc != hitpc))
+  {
+    printf("  debugger, %s: err=%d hit=%d hitpc=%d, expected hit=%d hitpc=%d\n",
+           name, err, dbg.hit, dbg.hitpc, hit, hitpc);
+    return 1;
+  }
+  return 0;
+}
+
+/* ---------------------------------------------------------
+                          dbg_check
+
+     Haltepunkt, Watchpoint und Haltebedingung am Referenz-
+     programm
+   --------------------------------------------------------- */
+static uint8_t dbg_check(void)
+{
+  uint8_t e, i;
+
+  e= 0;
+  memcpy(&cpa, &cpref, sizeof(kcomp));
+  cpu_invalidate_all(&cpa);
+
+  // Haltepunkt auf "mov a,b" (2), wird je Schleifendurchlauf einmal erreicht
+  dbg_clear();
+  dbg_togglebp(2);
+  e |= dbg_stopat("breakpoint", 0, dbg_hitbp, 2);
+  e |= (cpa.pc != 2) || (cpa.b != 3);
+  e |= dbg_stopat("continue", cpa.pc, dbg_hitbp, 2);
+  e |= (cpa.b != 2);
+  dbg_togglebp(2);
+  e |= dbg.active;
+
+  // Watchpoint auf Adresse 40 (mov 40,a an Adresse 15)
+  memcpy(&cpa, &cpref, sizeof(kcomp));
+  cpu_invalidate_all(&cpa);
+  dbg_togglewp(40);
+  e |= dbg_stopat("watchpoint", 0, dbg_hitwp, 15);
+  e |= (cpa.pc != 16) || (dbg.hitadr != 40) || (cpa.mem[40] != cpa.a);
+
+  // Bedingung a == 3 (nach adi a,9 an Adresse 11)
+  dbg_clear();
+  memcpy(&cpa, &cpref, sizeof(kcomp));
+  cpu_invalidate_all(&cpa);
+  dbg_addcond('a', 0, '=', 3);
+  e |= dbg_stopat("condition", 0, dbg_hitcond, 11);
+  e |= (cpa.a != 3);
+
+  // Bedingung auf Speicherwort: @40 > 0
+  dbg_clear();
+  memcpy(&cpa, &cpref, sizeof(kcomp));
+  cpu_invalidate_all(&cpa);
+  dbg_addcond(dbg_srcmem, 40, '>', 0);
+  e |= dbg_stopat("memory condition", 0, dbg_hitcond, 15);
+
+  #if (cpu_sched == 1)
+    // Haltepunkt an einer Zeitscheibengrenze (nicht am Startbefehl)
+    dbg_clear();
+    memcpy(&cpa, &cpref, sizeof(kcomp));
+    cpu_invalidate_all(&cpa);
+    dbg_togglebp(2);
+    err= 0;
+    cpu_slicestate= cpu_halt;
+    for (i= 0; (i< 100) && (cpu_step_n(&cpa, 1) != cpu_halt); i++);
+    if ((err != dbg_errstop) || (dbg.hit != dbg_hitbp) || (dbg.hitpc != 2))
+    {
+      printf("  debugger, breakpoint at slice boundary: err=%d hit=%d hitpc=%d\n", err, dbg.hit, dbg.hitpc);
+      e= 1;
+    }
+    // Fortsetzen vom Haltepunkt aus haelt dort nicht sofort erneut
+    err= 0;
+    e |= (cpu_step_n(&cpa, 1) != cpu_busy) || (cpa.pc != 3);
+  #endif
+
+  dbg_clear();
+  err= 0;
+  if (e) printf("  debugger FAILED\n");
+  return e;
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+  uint8_t  line[20];
+  uint16_t prgword;
+  uint32_t prgcnt, steps, i;
+  uint32_t errcnt[256];
+  char     name[32];
+  const char **src;
+
+  // Referenzprogramm: Unterprogramm, Arithmetik, indirekter Zugriff
+  static const char *prg_ref[] =
+  {
+    "mvi b,3", "call 10", "mov a,b", "dec a", "mov b,a", "cpi a,0", "jz 8", "jmp 1",
+    "hlt", "hlt", "mvi a,250", "adi a,9", "mul a,b", "slc a", "src a", "mov 40,a",
+    "mov a,@41", "mov @42,a", "xor a,40", "cmp a,40", "ret",
+    ".org 41", "db 40", "db 43", 0
+  };
+
+  prgcnt= 20000;
+  rndval= 0x12345678;
+  if (argc > 1) prgcnt= atol(argv[1]);
+  if (argc > 2) rndval= strtoul(argv[2], 0, 0) | 1;
+
+  printf("\n CP1 lockstep check switch / threaded\n\n");
+
+  steps= 0;
+  memset(errcnt, 0, sizeof(errcnt));
+
+  // Referenzprogramm uebersetzen
+  cpu_reset(&cpa);
+  for (src= prg_ref; *src; src++)
+  {
+    strncpy((char *)line, *src, sizeof(line)-1);
+    line[sizeof(line)-1]= 0;
+    i= assemble_line(&line[0], &prgword, &cpa);
+    if (i== 255) { cpa.addr= prgword & 0xff; continue; }
+    if (i) { printf("  assemble error %u in line \"%s\"\n", i, *src); return 1; }
+    cpa.mem[cpa.addr++]= ((prgword / 1000) << 8) + (prgword % 1000);
+  }
+  memcpy(&cpref, &cpa, sizeof(kcomp));
+  if (run_lockstep("reference", &steps)) return 1;
+
+  for (i= 0; i< prgcnt; i++)
+  {
+    prg_random(&cpa);
+    sprintf(name, "random #%u", i);
+    if (run_lockstep(name, &steps)) return 1;
+    errcnt[err]++;
+  }
+
+  printf("  %u programs, %u steps, no differences\n", prgcnt + 1, steps);
+  printf("  stop reasons:");
+  for (i= 0; i< 256; i++)
+    if (errcnt[i]) printf("  err %u: %u", i, errcnt[i]);
+  printf("\n");
+
+  #if (cpu_sched == 1)
+    // cpu_step_n mit verschiedenen Zeitscheiben gegen cpu_run
+    {
+      static const uint16_t budgets[] = { 1, 3, 64, 1000 };
+      uint8_t b;
+
+      steps= 0;
+      for (b= 0; b< sizeof(budgets) / sizeof(budgets[0]); b++)
+      {
+        memcpy(&cpa, &cpref, sizeof(kcomp));
+        sprintf(name, "reference");
+        if (run_sliced(name, cpu_step_n, budgets[b], &steps)) return 1;
+        if (run_sliced(name, step_n_thr, budgets[b], &steps)) return 1;
+        for (i= 0; i< prgcnt / 4; i++)
+        {
+          prg_random(&cpa);
+          sprintf(name, "sliced #%u", i);
+          if (run_sliced(name, cpu_step_n, budgets[b], &steps)) return 1;
+          sprintf(name, "sliced thr #%u", i);
+          if (run_sliced(name, step_n_thr, budgets[b], &steps)) return 1;
+        }
+      }
+      printf("  %u programs, %u steps with cpu_step_n / cpu_step_thr (slice 1, 3, 64, 1000),"
+             " no differences\n", (prgcnt / 4 + 1) * 4, steps);
+    }
+    #if (cpu_profile == 1)
+      if (prof_sleepcheck(cpu_step_n) || prof_sleepcheck(step_n_thr)) return 1;
+      printf("  profile: cdel in time slices counted\n");
+    #endif
+  #endif
+
+  #if (cpu_debug == 1)
+    // cpu_run mit Pruefungen, Bedingung ist nie erfuellt
+    steps= 0;
+    dbg_clear();
+    dbg_addcond('a', 0, '>', 255);
+    for (i= 0; i< prgcnt / 4; i++)
+    {
+      prg_random(&cpa);
+      sprintf(name, "debug #%u", i);
+      if (run_lockstep(name, &steps)) return 1;
+    }
+    printf("  %u programs, %u steps with debug checks, no differences\n", prgcnt / 4, steps);
+    if (dbg_check()) return 1;
+    printf("  breakpoint, watchpoint, conditions ok\n");
+  #endif
+  printf("\n");
+  return 0;
+}
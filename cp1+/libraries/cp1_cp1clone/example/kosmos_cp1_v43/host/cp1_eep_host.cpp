@@ -0,0 +1,56 @@
+/* ------------------------------------------------------------------
+                           cp1_eep_host.cpp
+
+     Nachbildung des internen EEPROMs (1 kByte) und des I2C-
+     EEPROMs (eep_size) fuer einen Build auf einem Linux-Host.
+
+     Geschrieben wird wie beim 24LCxx in Pages zu eep_host_pagesize
+     Bytes: eep_writebuf beginnt an jeder Pagegrenze einen neuen
+     Schreibzyklus. Die Schreibzyklen werden gezaehlt
+     (eep_host_pagewrites), ebenso die Schreibzugriffe auf das
+     interne EEPROM (eep_host_intwrites).
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "../kosmos_cp1_v43.h"
+
+#define  eep_host_pagesize    8                  // 24LC32
+
+uint8_t  eep_host_mem[eep_size];                // I2C-EEPROM
+uint8_t  eep_host_int[1024];                    // internes EEPROM
+uint32_t eep_host_pagewrites = 0;
+uint32_t eep_host_bytewrites = 0;
+uint32_t eep_host_intwrites  = 0;
+
+uint8_t eeprom_read_byte(const uint8_t *adr)
+{
+  return eep_host_int[(uintptr_t)adr & 0x3ff];
+}
+
+void eeprom_update_byte(uint8_t *adr, uint8_t value)
+{
+  if (eep_host_int[(uintptr_t)adr & 0x3ff] == value) return;
+  eep_host_int[(uintptr_t)adr & 0x3ff]= value;
+  eep_host_intwrites++;
+}
+
+void eep_writebuf(uint16_t adr, uint8_t *buf, uint16_t len)
+{
+  if (!len) return;
+  eep_host_pagewrites++;
+  while (len--)
+  {
+    eep_host_mem[adr % eep_size]= *buf++;
+    eep_host_bytewrites++;
+    adr++;
+    if (len && !(adr % eep_host_pagesize)) eep_host_pagewrites++;   // neuer Schreibzyklus
+  }
+}
+
+void eep_readbuf(uint16_t adr, uint8_t *buf, uint16_t len)
+{
+  while (len--) *buf++= eep_host_mem[adr++ % eep_size];
+}
@@ -0,0 +1,95 @@
+/* ------------------------------------------------------------------
+                           cp1_hal_host.cpp
+
+     Implementierung der Hardwareabstraktion (cp1_hal.h) fuer
+     einen Build der virtuellen CPU auf einem Linux-Host.
+
+     Ports werden durch Variable nachgebildet, Anzeige und
+     Zeitverzoegerungen sind wirkungslos. Die Tastaturabfrage
+     liefert immer "keine Taste" (0xff).
+
+     Da cpu_run im kontinuierlichen Betrieb nach jedem ausge-
+     fuehrten Befehl genau einmal die Tastatur abfragt, zaehlt
+     hal_readkey die ausgefuehrten Befehle mit (hal_instrcnt).
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <sys/time.h>
+
+#include "../kosmos_cp1_v43.h"
+
+uint8_t   err= 0;                 // Fehlercode (auf dem AVR in kosmos_cp1_v43.ino)
+
+uint8_t   hal_p1 = 0;             // nachgebildeter Port 1
+uint8_t   hal_p2 = 0;             // nachgebildeter Port 2
+uint32_t  hal_display = 0;        // zuletzt mit cdis angezeigter Wert
+uint64_t  hal_instrcnt = 0;       // Anzahl Tastaturabfragen == ausgefuehrte Befehle
+
+void hal_showmask(uint8_t mask)
+{
+  (void)mask;
+}
+
+void hal_showacc(uint32_t value)
+{
+  hal_display= value;
+}
+
+uint8_t hal_readkey(void)
+{
+  hal_instrcnt++;
+  return 0xff;
+}
+
+uint8_t hal_delay(uint32_t dtime)
+{
+  (void)dtime;
+  return 0;
+}
+
+uint8_t hal_intr(kcomp *vcp1, int data)
+{
+  (void)vcp1; (void)data;
+  return 0;
+}
+
+uint32_t hal_millis(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+  return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+}
+
+uint8_t hal_p1_bitread(uint8_t bitnr)
+{
+  return (hal_p1 >> bitnr) & 0x01;
+}
+
+uint8_t hal_p1_byteread(void)
+{
+  return hal_p1;
+}
+
+void hal_p1_bitwrite(uint8_t bitnr, uint8_t value)
+{
+  if (value) hal_p1 |= (1 << bitnr); else hal_p1 &= ~(1 << bitnr);
+}
+
+void hal_p1_bytewrite(uint8_t value)
+{
+  hal_p1= value;
+}
+
+void hal_p2_bitwrite(uint8_t bitnr, uint8_t value)
+{
+  if (value) hal_p2 |= (1 << bitnr); else hal_p2 &= ~(1 << bitnr);
+}
+
+void hal_p2_bytewrite(uint8_t value)
+{
+  hal_p2= value;
+}
@@ -0,0 +1,74 @@
+/* ------------------------------------------------------------------
+                             cp1_host.h
+
+     Ersatz fuer die AVR-spezifischen Header, damit die virtuelle
+     CPU (cp1_cpu_v43.cpp) und der Zeilenassembler
+     (cp1_assemble_line.cpp) auf einem Linux-Host uebersetzt
+     werden koennen.
+
+     Wird nur von kosmos_cp1_v43.h eingebunden, wenn nicht fuer
+     einen AVR uebersetzt wird.
+
+     MCU  :   Linux-Host (gcc / g++)
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#ifndef in_cp1_host
+  #define in_cp1_host
+
+  #include <stdio.h>
+  #include <stdlib.h>
+  #include <stdint.h>
+  #include <string.h>
+  #include <ctype.h>
+  #include <unistd.h>
+
+  // auf dem Host liegen "Flash"-Daten im normalen RAM
+  #define PROGMEM
+  #define PSTR(s)                 (s)
+  #define pgm_read_byte(addr)     (*(const uint8_t *)(addr))
+  #define pgm_read_word(addr)     (*(const uint16_t *)(addr))
+  #define strcmp_P(s1, s2)        strcmp((const char *)(s1), (const char *)(s2))
+
+  // Die avr-libc kennt fuer strstr nur eine Funktion, -fpermissive erlaubt
+  // dann uint8_t-Zeiger als Argument. Die glibc besitzt fuer C++ jedoch
+  // 2 Ueberladungen, zwischen denen nicht gewaehlt werden kann.
+  #define _delay_us(us)           usleep(us)
+
+  // wie _crc_xmodem_update aus <util/crc16.h>
+  static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data)
+  {
+    int i;
+
+    crc= crc ^ ((uint16_t)data << 8);
+    for (i= 0; i< 8; i++)
+    {
+      if (crc & 0x8000) crc= (crc << 1) ^ 0x1021; else crc <<= 1;
+    }
+    return crc;
+  }
+
+  // internes EEPROM und I2C-EEPROM, Implementierung in cp1_eep_host.cpp
+  #define eep_size                0x8000          // 24LC256 wie cp1_eeprom_i2c.h
+  uint8_t eeprom_read_byte(const uint8_t *adr);
+  void    eeprom_update_byte(uint8_t *adr, uint8_t value);
+  void    eep_writebuf(uint16_t adr, uint8_t *buf, uint16_t len);
+  void    eep_readbuf(uint16_t adr, uint8_t *buf, uint16_t len);
+
+  // UART, Implementierung in cp1_uart_host.cpp (Dateideskriptor uart_host_fd)
+  void    uart_putchar(uint8_t ch);
+  uint8_t uart_getchar(void);
+  uint8_t uart_ischar(void);
+
+  static inline char *strstr(uint8_t *s1, uint8_t *s2)
+  {
+    return strstr((char *)s1, (const char *)s2);
+  }
+
+  static inline char *strstr(uint8_t *s1, const char *s2)
+  {
+    return strstr((char *)s1, s2);
+  }
+
+#endif
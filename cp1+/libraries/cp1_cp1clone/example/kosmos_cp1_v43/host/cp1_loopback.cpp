@@ -0,0 +1,137 @@
+/* ------------------------------------------------------------------
+                           cp1_loopback.cpp
+
+     Test des Blockprotokolls (../cp1_blkload.cpp) ohne Hardware:
+     ein Kindprozess spielt an der Master-Seite eines Pseudo-
+     terminals den CP1 (blk_receive mit dem UART aus
+     cp1_uart_host.cpp), an der Slave-Seite laeuft das unveraenderte
+     cp1_upload.
+
+     Geprueft werden
+       - vollstaendiges Laden, 64 Worte je Block
+       - vollstaendiges Laden, 32 Worte je Block, jedes n-te vom
+         CP1 empfangene Zeichen verfaelscht (Blockwiederholung)
+       - Laden nur der geaenderten Bereiche (-d)
+
+         make check
+
+     Rueckgabe 0, wenn der Programmspeicher nach jedem Test dem
+     gesendeten Programm entspricht.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <fcntl.h>
+#include <sys/wait.h>
+
+#include "../kosmos_cp1_v43.h"
+
+extern int      uart_host_fd;
+extern uint32_t uart_host_noise;
+
+static kcomp cp1;
+
+static void image_save(const char *fname, uint16_t *img)
+{
+  FILE    *f;
+  uint8_t  raw[memsize * 2];
+  int      i;
+
+  for (i= 0; i< memsize; i++)
+  {
+    raw[i*2]= img[i] & 0xff;
+    raw[i*2+1]= img[i] >> 8;
+  }
+  f= fopen(fname, "wb");
+  fwrite(raw, 1, sizeof(raw), f);
+  fclose(f);
+}
+
+/* ---------------------------------------------------------
+                          loopback
+
+     devimg : Programmspeicher des CP1 vor dem Laden
+     img    : zu ladendes Programm (Datei fname)
+     args   : zusaetzliche Optionen fuer cp1_upload
+   --------------------------------------------------------- */
+static int loopback(const char *name, uint16_t *devimg, uint16_t *img, const char *fname,
+                    const char *args, uint32_t noise)
+{
+  uint16_t mem[memsize];
+  char     cmd[256];
+  int      master, slave, pfd[2];
+  int      status, ok;
+  pid_t    pid;
+  uint8_t  ch, r;
+
+  master= posix_openpt(O_RDWR | O_NOCTTY);
+  if ((master < 0) || grantpt(master) || unlockpt(master)) { perror("pty"); return 1; }
+  // Slave offen halten, sonst liefert der Master bis zum Oeffnen durch cp1_upload EIO
+  slave= open(ptsname(master), O_RDWR | O_NOCTTY);
+  if ((slave < 0) || pipe(pfd)) { perror("pty"); return 1; }
+
+  pid= fork();
+  if (pid == 0)
+  {
+    // CP1: Festprogramm 5
+    close(pfd[0]);
+    uart_host_fd= master;
+    uart_host_noise= noise;
+    memcpy(cp1.mem, devimg, sizeof(cp1.mem));
+    do ch= uart_getchar(); while (ch != 'B');
+    uart_putchar('b');
+    r= blk_receive(&cp1);
+    if ((write(pfd[1], &r, 1) != 1) || (write(pfd[1], cp1.mem, sizeof(cp1.mem)) != sizeof(cp1.mem))) exit(1);
+    exit(0);
+  }
+  close(pfd[1]);
+
+  snprintf(cmd, sizeof(cmd), "./cp1_upload %s %s %s", args, ptsname(master), fname);
+  printf("  %-34s ", name);
+  fflush(stdout);
+  status= system(cmd);
+
+  ok= (status == 0) && (read(pfd[0], &r, 1) == 1) && (r == 0) &&
+      (read(pfd[0], mem, sizeof(mem)) == sizeof(mem)) && !memcmp(mem, img, sizeof(mem));
+  if (!ok) kill(pid, SIGKILL);
+  waitpid(pid, 0, 0);
+  close(pfd[0]); close(slave); close(master);
+
+  if (!ok) printf("  %s FAILED\n", name);
+  return ok ? 0 : 1;
+}
+
+int main(void)
+{
+  uint16_t zero[memsize], a[memsize], b[memsize];
+  int      i, errors;
+
+  srand(4711);
+  memset(zero, 0, sizeof(zero));
+  for (i= 0; i< memsize; i++) a[i]= rand() & 0xffff;
+  // einzelne Blockbegrenzer im Datenstrom
+  a[10]= (blk_stx << 8) | blk_eot;
+  a[11]= (blk_can << 8) | blk_stx;
+
+  // b: zwei geaenderte Bereiche und ein einzelnes Wort
+  memcpy(b, a, sizeof(b));
+  for (i= 20; i< 27; i++) b[i]^= 0x0101;
+  for (i= 130; i< 200; i++) b[i]= i;
+  b[255]= 0;
+
+  image_save("lb_a.bin", a);
+  image_save("lb_b.bin", b);
+
+  errors= 0;
+  errors+= loopback("full, 64 words/block", zero, a, "lb_a.bin", "", 0);
+  errors+= loopback("full, 32 words/block, noise", zero, a, "lb_a.bin", "-w 32", 150);
+  errors+= loopback("changed ranges only", a, b, "lb_b.bin", "-d lb_a.bin", 0);
+  errors+= loopback("nothing changed", b, b, "lb_b.bin", "-d lb_b.bin", 0);
+
+  remove("lb_a.bin");
+  remove("lb_b.bin");
+  printf("  loopback %s\n", errors ? "FAILED" : "ok");
+  return errors ? 1 : 0;
+}
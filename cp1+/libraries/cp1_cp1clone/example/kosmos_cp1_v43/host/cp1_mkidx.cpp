@@ -0,0 +1,189 @@
+/* ------------------------------------------------------------------
+                            cp1_mkidx.cpp
+
+     erzeugt den Index zur Mnemonicliste mnemset des Assemblers
+     (../cp1_mnemidx.h):
+
+       mnemsort : Eintraege von mnemset sortiert nach dem
+                  Mnemonic-Muster (binaere Suche in assemble_line)
+       mnemopc  : Opcode -> erster Eintrag in mnemset mit diesem
+                  Opcode (disassemble_prgword)
+
+         make idx            : ../cp1_mnemidx.h neu erzeugen
+         ./cp1_mkidx -c      : prueft, ob der eingebundene Index zu
+                               mnemset passt und ob jede Mnemonic
+                               assembliert und disassembliert
+                               werden kann (make check)
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "../kosmos_cp1_v43.h"
+
+static uint8_t sorttab[mnemanz];
+static uint8_t opctab[256];
+static int     opcanz;
+
+// Mnemonic-Muster eines Eintrags (ohne vorangestelltes Opcodebyte)
+static const char *pattern(uint8_t i)
+{
+  return (const char *)&mnemset[i][1];
+}
+
+// Opcode eines Eintrags, "db" steht fuer ein Datum (Opcode 0)
+static uint8_t entry_opc(uint8_t i)
+{
+  return (mnemset[i][0] == 0xff) ? 0 : mnemset[i][0];
+}
+
+static int cmp_entry(const void *a, const void *b)
+{
+  return strcmp(pattern(*(const uint8_t *)a), pattern(*(const uint8_t *)b));
+}
+
+/* ---------------------------------------------------------
+                          idx_build
+
+     berechnet beide Tabellen aus mnemset, Rueckgabe 0
+     bei Erfolg
+   --------------------------------------------------------- */
+static int idx_build(void)
+{
+  int i, opc;
+
+  for (i= 0; i< mnemanz; i++) sorttab[i]= i;
+  qsort(sorttab, mnemanz, 1, cmp_entry);
+  for (i= 1; i< mnemanz; i++)
+  {
+    if (!strcmp(pattern(sorttab[i-1]), pattern(sorttab[i])))
+    {
+      fprintf(stderr, "duplicate mnemonic \"%s\"\n", pattern(sorttab[i]));
+      return 1;
+    }
+  }
+
+  memset(opctab, 0xff, sizeof(opctab));
+  opcanz= 0;
+  for (i= 0; i< mnemanz; i++)
+  {
+    opc= entry_opc(i);
+    if (opctab[opc] == 0xff) opctab[opc]= i;
+    if (opc + 1 > opcanz) opcanz= opc + 1;
+  }
+  if (opcanz != mnemopcanz)
+  {
+    fprintf(stderr, "highest opcode in mnemset is %d, set mnemopcanz to %d\n", opcanz-1, opcanz);
+    return 1;
+  }
+  return 0;
+}
+
+static void idx_print(void)
+{
+  int i;
+
+  printf("/* ------------------------------------------------------------------\n");
+  printf("                            cp1_mnemidx.h\n\n");
+  printf("     Index zur Mnemonicliste mnemset (cp1_assemble_line.cpp)\n\n");
+  printf("     !!! generiert mit host/cp1_mkidx (make idx), nach jeder\n");
+  printf("     Aenderung an mnemset neu erzeugen !!!\n\n");
+  printf("     mnemsort : Eintraege von mnemset nach Mnemonic-Muster\n");
+  printf("                sortiert (binaere Suche in assemble_line)\n");
+  printf("     mnemopc  : Opcode -> Eintrag in mnemset, 0xff = kein\n");
+  printf("                Eintrag (disassemble_prgword)\n");
+  printf("   ------------------------------------------------------------------ */\n\n");
+
+  printf("const uint8_t mnemsort[mnemanz] PROGMEM =\n{\n");
+  for (i= 0; i< mnemanz; i++)
+    printf("  %3d%c       // %s\n", sorttab[i], (i < mnemanz-1) ? ',' : ' ', pattern(sorttab[i]));
+  printf("};\n\n");
+
+  printf("const uint8_t mnemopc[mnemopcanz] PROGMEM =\n{\n");
+  for (i= 0; i< opcanz; i++)
+  {
+    if (!(i % 8)) printf("  ");
+    if (opctab[i] == 0xff) printf("0xff"); else printf("%4d", opctab[i]);
+    if (i < opcanz-1) printf(",");
+    if (((i % 8) == 7) || (i == opcanz-1))
+      printf("%*s// %3d .. %3d\n", (i == opcanz-1) ? 6 + (7 - (i % 8)) * 6 : 5, "", i - (i % 8), i);
+    else
+      printf(" ");
+  }
+  printf("};\n");
+}
+
+/* ---------------------------------------------------------
+                          idx_check
+
+     vergleicht den uebersetzten Index mit mnemset und
+     assembliert / disassembliert jede Mnemonic
+   --------------------------------------------------------- */
+static int idx_check(void)
+{
+  uint8_t  line[20], dis[20];
+  uint16_t prgword, word;
+  uint8_t  e, opc;
+  int      i, errors;
+  char     *p;
+
+  errors= 0;
+  if (memcmp(sorttab, mnemsort, mnemanz) || memcmp(opctab, mnemopc, mnemopcanz))
+  {
+    printf("  cp1_mnemidx.h does not match mnemset, run \"make idx\"\n");
+    return 1;
+  }
+
+  for (i= 0; i< mnemanz; i++)
+  {
+    // Muster mit eingesetztem Datum assemblieren
+    strcpy((char *)line, pattern(i));
+    p= strchr((char *)line, '?');
+    if (p) { memmove(p+2, p+1, strlen(p+1)+1); p[0]= '1'; p[1]= '7'; }
+    strcpy((char *)dis, (char *)line);
+
+    e= assemble_line(line, &prgword, 0);
+    opc= entry_opc(i);
+    if (opc == 0x42)
+    {
+      if ((e != 255) || (prgword != (p ? 17 : 0))) { printf("  %s: error %d\n", dis, e); errors++; }
+      continue;
+    }
+    if (e || (prgword != (opc * 1000) + (p ? 17 : 0)))
+    {
+      printf("  %s: assembled to %u, error %d\n", dis, prgword, e);
+      errors++;
+      continue;
+    }
+
+    // und zurueck disassemblieren
+    word= ((prgword / 1000) << 8) + (prgword % 1000);
+    disassemble_prgword(line, word);
+    if (p) { p= strstr((char *)dis, "17"); memmove(p+3, p+2, strlen(p+2)+1); memcpy(p, "017", 3); }
+    if (strcmp((char *)line, (char *)dis) && ((opc < 16) || (opc > 18)))
+    {
+      printf("  %s: disassembled to \"%s\"\n", dis, line);
+      errors++;
+    }
+  }
+
+  // Opcodes ohne Eintrag liefern einen leeren String (0xff wird wie db angezeigt)
+  for (i= 0; i< 256; i++)
+  {
+    disassemble_prgword(line, i << 8);
+    if (((i < opcanz) && (opctab[i] != 0xff)) || (i == 0xff)) continue;
+    if (line[0]) { printf("  opcode %d: disassembled to \"%s\"\n", i, line); errors++; }
+  }
+
+  printf("  %d mnemonics, index %s\n", mnemanz, errors ? "FAILED" : "ok");
+  return errors ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (idx_build()) return 1;
+  if ((argc > 1) && !strcmp(argv[1], "-c")) return idx_check();
+  idx_print();
+  return 0;
+}
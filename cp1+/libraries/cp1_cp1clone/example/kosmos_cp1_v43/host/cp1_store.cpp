@@ -0,0 +1,156 @@
+/* ------------------------------------------------------------------
+                            cp1_store.cpp
+
+     prueft das Speichern / Laden der Speicherplaetze
+     (cp1_prgstore.cpp) mit dem nachgebildeten EEPROM
+     (cp1_eep_host.cpp):
+
+       - Speichern auf einen neuen Platz und Zuruecklesen
+       - nur geaenderte Bloecke werden geschrieben, auch nach
+         Aenderungen durch ein laufendes Programm (mov mem,a)
+       - unveraendertes Programm erzeugt keinen Schreibzugriff
+       - Speicherplaetze ueberlappen nicht
+       - verfaelschtes EEPROM wird beim Laden erkannt
+       - Platz ohne CRC (Tabelleneintrag 0xffff) wird geladen
+         und die CRC nachgetragen
+       - internes EEPROM (Platz 0 / 1)
+
+         make check
+         ./cp1_store
+
+     Rueckgabe 0, wenn alle Pruefungen bestanden sind.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "../kosmos_cp1_v43.h"
+
+extern uint8_t  eep_host_mem[];
+extern uint32_t eep_host_pagewrites, eep_host_bytewrites, eep_host_intwrites;
+
+kcomp cpa, cpb;
+int   errors= 0;
+
+static void check(const char *name, int ok)
+{
+  printf("  %-44s %s\n", name, ok ? "ok" : "FAILED");
+  if (!ok) errors++;
+}
+
+static void prg_fill(kcomp *vcp1, uint32_t seed)
+{
+  uint16_t i;
+
+  cpu_reset(vcp1);
+  for (i= 0; i< memsize; i++)
+  {
+    seed= seed * 1103515245 + 12345;
+    vcp1->mem[i]= (((seed >> 16) % opcmax) + 1) << 8 | ((seed >> 8) & 0xff);
+  }
+  cpu_invalidate_all(vcp1);
+}
+
+static uint16_t save(kcomp *vcp1, uint8_t slot, uint32_t *pages)
+{
+  uint16_t blk;
+
+  eep_host_pagewrites= 0;
+  blk= prg_save(vcp1, slot);
+  *pages= eep_host_pagewrites;
+  return blk;
+}
+
+int main(void)
+{
+  uint32_t pages, t;
+  uint8_t  line[20];
+  uint16_t prgword, blk;
+  char     txt[64];
+
+  printf("\n CP1 program store check (%d slots, %d byte blocks)\n\n", prg_max + 1, prg_blksize);
+
+  memset(eep_host_mem, 0xff, eep_size);
+
+  // vollstaendiges Programm auf einen leeren Platz
+  prg_fill(&cpa, 1);
+  blk= save(&cpa, 2, &pages);
+  sprintf(txt, "new slot: %d blocks, %u page writes", blk, pages);
+  check(txt, blk== prg_blkanz);
+  check("load slot 2, crc", (prg_load(&cpb, 2)== 0) && !memcmp(cpa.mem, cpb.mem, sizeof(cpa.mem)));
+
+  // unveraendert erneut speichern
+  blk= save(&cpb, 2, &pages);
+  sprintf(txt, "unchanged: %d blocks, %u page writes", blk, pages);
+  check(txt, (blk== 0) && (pages== 0));
+
+  // 3 Worte aendern, 2 davon im selben Block
+  cpb.mem[10]= 0x0401; cpu_invalidate(&cpb, 10);
+  cpb.mem[11]= 0x0402; cpu_invalidate(&cpb, 11);
+  cpb.mem[200]= 0x0403; cpu_invalidate(&cpb, 200);
+  blk= save(&cpb, 2, &pages);
+  sprintf(txt, "3 words changed: %d blocks, %u page writes", blk, pages);
+  check(txt, (blk== 2) && (pages== 3));
+
+  // gleicher Wert geschrieben: Block markiert, aber kein Unterschied
+  cpb.mem[50]= cpb.mem[50]; cpu_invalidate(&cpb, 50);
+  blk= save(&cpb, 2, &pages);
+  check("same value rewritten: nothing written", (blk== 0) && (pages== 0));
+
+  // Programm schreibt in den Speicher
+  cpu_reset(&cpb);
+  prg_load(&cpb, 2);
+  strcpy((char *)line, "mvi a,77"); assemble_line(line, &prgword, &cpb);
+  cpb.mem[0]= ((prgword / 1000) << 8) + (prgword % 1000);
+  strcpy((char *)line, "mov 100,a"); assemble_line(line, &prgword, &cpb);
+  cpb.mem[1]= ((prgword / 1000) << 8) + (prgword % 1000);
+  cpb.mem[2]= 1 << 8;                                 // hlt
+  cpu_invalidate(&cpb, 0); cpu_invalidate(&cpb, 1); cpu_invalidate(&cpb, 2);
+  prg_save(&cpb, 2);
+  cpb.pc= 0; err= 0;
+  cpu_run(&cpb, 0);
+  blk= save(&cpb, 2, &pages);
+  check("mov 100,a by running program: 1 block", (err== 0) && (blk== 1) && (pages== 2));
+  check("reload after run", (prg_load(&cpa, 2)== 0) && (cpa.mem[100]== 77));
+
+  // anderer Platz: alle Bloecke werden verglichen, Platz 2 bleibt erhalten
+  memcpy(&cpa, &cpb, sizeof(kcomp));
+  blk= save(&cpa, 3, &pages);
+  check("slot 3 written completely", blk== prg_blkanz);
+  check("slot 2 unchanged", (prg_load(&cpa, 2)== 0) && !memcmp(cpa.mem, cpb.mem, sizeof(cpa.mem)));
+  blk= save(&cpa, prg_max, &pages);
+  check("highest slot 33, crc table outside",     (prg_max== 33) && (prg_crcadr >= (prg_max - 1) * prg_slotsize));
+  check("highest slot does not hit the crc table", (prg_load(&cpa, 2)== 0) && (prg_load(&cpa, 3)== 0) &&
+                                                   (prg_load(&cpa, prg_max)== 0));
+
+  // verfaelschtes Byte
+  eep_host_mem[512 + 77] ^= 0x10;
+  check("corrupted slot detected", prg_load(&cpa, 3)== 1);
+  check("other slot still ok", prg_load(&cpa, 2)== 0);
+
+  // Platz ohne CRC: wird geladen, CRC wird nachgetragen
+  eep_host_mem[prg_crcadr + 3 * 2]= 0xff;
+  eep_host_mem[prg_crcadr + 3 * 2 + 1]= 0xff;
+  eep_host_pagewrites= 0;
+  check("no crc yet: slot loads", prg_load(&cpa, 3)== 0);
+  check("no crc yet: crc written", (eep_host_pagewrites== 1) &&
+                                   (eep_host_mem[prg_crcadr + 3 * 2] | (eep_host_mem[prg_crcadr + 3 * 2 + 1] << 8))== prg_crc(&cpa));
+  eep_host_mem[512 + 77] ^= 0x10;
+  check("corruption detected after crc was added", prg_load(&cpa, 3)== 1);
+
+  // internes EEPROM
+  prg_fill(&cpa, 7);
+  eep_host_intwrites= 0;
+  prg_save(&cpa, 1);
+  t= eep_host_intwrites;
+  prg_load(&cpb, 1);
+  check("internal slot 1 roundtrip", !memcmp(cpa.mem, cpb.mem, sizeof(cpa.mem)) && (t <= memsize * 2));
+  cpb.mem[5] ^= 1; cpu_invalidate(&cpb, 5);
+  eep_host_intwrites= 0;
+  blk= prg_save(&cpb, 1);
+  check("internal slot: 1 word, 1 byte written", (blk== 1) && (eep_host_intwrites== 1));
+
+  printf("\n  program store %s\n\n", errors ? "FAILED" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+/* ------------------------------------------------------------------
+                          cp1_uart_host.cpp
+
+     UART des CP1 auf einem Linux-Host: liest und schreibt auf
+     einen Dateideskriptor (z.B. die Master-Seite eines Pseudo-
+     terminals, siehe cp1_loopback.cpp).
+
+     uart_host_noise > 0 verfaelscht jedes n-te empfangene
+     Zeichen (Test der Blockwiederholung).
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <poll.h>
+
+#include "../kosmos_cp1_v43.h"
+
+int       uart_host_fd = -1;
+uint32_t  uart_host_noise = 0;
+static uint32_t rxcnt = 0;
+
+void uart_putchar(uint8_t ch)
+{
+  if (write(uart_host_fd, &ch, 1) != 1) exit(3);
+}
+
+uint8_t uart_ischar(void)
+{
+  struct pollfd pfd;
+
+  pfd.fd= uart_host_fd;
+  pfd.events= POLLIN;
+  return (poll(&pfd, 1, 0) > 0) && (pfd.revents & POLLIN);
+}
+
+uint8_t uart_getchar(void)
+{
+  uint8_t ch;
+
+  if (read(uart_host_fd, &ch, 1) != 1) exit(3);
+  rxcnt++;
+  if (uart_host_noise && !(rxcnt % uart_host_noise)) ch ^= 0x5a;
+  return ch;
+}
@@ -0,0 +1,285 @@
+/* ------------------------------------------------------------------
+                            cp1_upload.cpp
+
+     Laedt ein Programm ueber eine serielle Schnittstelle in den
+     CP1 (Festprogramm 5, Blockprotokoll siehe ../cp1_blkload.h)
+
+         ./cp1_upload [Optionen] /dev/ttyUSB0 programm.bin
+         ./cp1_upload [Optionen] /dev/ttyUSB0 programm.asm
+
+           programm.bin : 512 Byte, je Programmwort Low- und
+                          High-Byte (wie beim alten Protokoll)
+           programm.asm : Quelltext mit Labels, wird mit dem
+                          Quelltextassembler (../cp1_srcasm.cpp)
+                          uebersetzt
+
+     Optionen:
+           -b baud      : Baudrate (Vorgabe 38400)
+           -w worte     : Programmworte je Block, 1..64 (Vorgabe 64)
+           -d alt.bin   : nur die gegenueber alt.bin geaenderten
+                          Bereiche senden
+           -q           : keine Ausgabe ausser Fehlern
+
+     Rueckgabe 0, wenn alle Bloecke quittiert wurden.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/time.h>
+
+#include "../kosmos_cp1_v43.h"
+
+#define  retries_max     8           // Wiederholungen je Block
+#define  reply_ms        2000        // Wartezeit auf Quittung
+
+static kcomp  cp1;
+static srcasm sa;
+
+static int    fd;
+static int    quiet;
+
+static double msec(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+  return tv.tv_sec * 1e3 + tv.tv_usec / 1e3;
+}
+
+static speed_t baudconst(int baud)
+{
+  switch (baud)
+  {
+    case   9600 : return B9600;
+    case  19200 : return B19200;
+    case  38400 : return B38400;
+    case  57600 : return B57600;
+    case 115200 : return B115200;
+    default     : return 0;
+  }
+}
+
+static int port_open(const char *dev, int baud)
+{
+  struct termios tio;
+
+  fd= open(dev, O_RDWR | O_NOCTTY);
+  if (fd < 0) { perror(dev); return 1; }
+  if (tcgetattr(fd, &tio)) { perror(dev); return 1; }
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cc[VMIN]= 0;
+  tio.c_cc[VTIME]= 0;
+  cfsetispeed(&tio, baudconst(baud));
+  cfsetospeed(&tio, baudconst(baud));
+  if (tcsetattr(fd, TCSANOW, &tio)) { perror(dev); return 1; }
+  tcflush(fd, TCIOFLUSH);
+  return 0;
+}
+
+// Zeichen mit Timeout lesen, -1 bei Timeout
+static int port_getc(int ms)
+{
+  struct pollfd pfd;
+  uint8_t ch;
+
+  pfd.fd= fd;
+  pfd.events= POLLIN;
+  if (poll(&pfd, 1, ms) <= 0) return -1;
+  if (read(fd, &ch, 1) != 1) return -1;
+  return ch;
+}
+
+static void port_write(const uint8_t *buf, int len)
+{
+  if (write(fd, buf, len) != len) { perror("write"); exit(2); }
+  tcdrain(fd);
+}
+
+/* ---------------------------------------------------------
+                         image_load
+
+     liest ein Binaerabbild (512 Byte) oder uebersetzt einen
+     Quelltext nach img, Rueckgabe 0 bei Erfolg
+   --------------------------------------------------------- */
+static int image_load(const char *fname, uint16_t *img)
+{
+  FILE    *f;
+  uint8_t  raw[memsize * 2];
+  char     buf[256];
+  uint8_t  line[sa_linelen];
+  int      i, l;
+  const char *ext;
+
+  memset(img, 0, memsize * sizeof(uint16_t));
+  f= fopen(fname, "rb");
+  if (!f) { perror(fname); return 1; }
+
+  ext= strrchr(fname, '.');
+  if (ext && !strcmp(ext, ".asm"))
+  {
+    srcasm_init(&sa, &cp1);
+    while (fgets(buf, sizeof(buf), f))
+    {
+      l= strlen(buf);
+      while (l && ((buf[l-1] == '\n') || (buf[l-1] == '\r'))) buf[--l]= 0;
+      if (strchr(buf, ';')) { *strchr(buf, ';')= 0; l= strlen(buf); }
+      if (!strncmp(buf, ".end", 4)) break;
+      if (l > sa_linelen-1) { sa.line++; srcasm_error(&sa, sa_err_syntax, 0xff); continue; }
+      strcpy((char *)line, buf);
+      srcasm_line(&sa, line);
+    }
+    fclose(f);
+    if (srcasm_finish(&sa))
+    {
+      for (i= 0; i< sa.erranz; i++)
+        fprintf(stderr, "%s:%u: %s\n", fname, sa.err[i].line, srcasm_errtext(sa.err[i].code));
+      return 1;
+    }
+    memcpy(img, cp1.mem, memsize * sizeof(uint16_t));
+    return 0;
+  }
+
+  memset(raw, 0, sizeof(raw));
+  l= fread(raw, 1, sizeof(raw), f);
+  fclose(f);
+  if (l <= 0) { fprintf(stderr, "%s: empty file\n", fname); return 1; }
+  for (i= 0; i< memsize; i++)
+    img[i]= raw[i*2] | (raw[i*2+1] << 8);
+  return 0;
+}
+
+/* ---------------------------------------------------------
+                         send_block
+
+     sendet einen Block bis zur Quittung, Rueckgabe Anzahl
+     Wiederholungen, -1 wenn der CP1 nicht antwortet
+   --------------------------------------------------------- */
+static int send_block(uint16_t *img, int adr, int n)
+{
+  uint8_t  frame[4 + blk_maxwords * 2 + 2];
+  uint16_t crc;
+  int      i, len, r, tries;
+
+  len= 0;
+  frame[len++]= blk_stx;
+  frame[len++]= adr;
+  frame[len++]= n;
+  for (i= 0; i< n; i++)
+  {
+    frame[len++]= img[adr + i] & 0xff;
+    frame[len++]= img[adr + i] >> 8;
+  }
+  crc= 0;
+  for (i= 1; i< len; i++) crc= _crc_xmodem_update(crc, frame[i]);
+  frame[len++]= crc & 0xff;
+  frame[len++]= crc >> 8;
+
+  for (tries= 0; tries <= retries_max; tries++)
+  {
+    port_write(frame, len);
+    do
+    {
+      r= port_getc(reply_ms);
+    } while ((r >= 0) && (r != blk_ack) && (r != blk_nak));
+    if (r == blk_ack) return tries;
+    if (!quiet) fprintf(stderr, "  block %3d..%3d: %s, retry\n", adr, adr + n - 1, (r < 0) ? "timeout" : "NAK");
+    tcflush(fd, TCIFLUSH);
+  }
+  return -1;
+}
+
+int main(int argc, char **argv)
+{
+  uint16_t img[memsize], old[memsize];
+  uint8_t  send[memsize];
+  int      baud, words, useold, opt;
+  int      adr, end, n, r, i;
+  int      blocks, sent, retries;
+  uint8_t  ch;
+  double   t0;
+
+  baud= 38400; words= blk_maxwords; useold= 0; quiet= 0;
+  while ((opt= getopt(argc, argv, "b:w:d:q")) != -1)
+  {
+    switch (opt)
+    {
+      case 'b' : baud= atoi(optarg); break;
+      case 'w' : words= atoi(optarg); break;
+      case 'd' : if (image_load(optarg, old)) return 2; useold= 1; break;
+      case 'q' : quiet= 1; break;
+      default  : optind= argc + 1; break;
+    }
+  }
+  if ((optind + 2 != argc) || !baudconst(baud) || (words < 1) || (words > blk_maxwords))
+  {
+    fprintf(stderr, "usage: %s [-b baud] [-w words] [-d old.bin] [-q] device file.bin|file.asm\n", argv[0]);
+    return 2;
+  }
+  if (image_load(argv[optind + 1], img)) return 2;
+  if (port_open(argv[optind], baud)) return 2;
+
+  // zu sendende Worte, kleine Luecken werden mitgesendet (billiger als ein neuer Blockkopf)
+  for (i= 0; i< memsize; i++) send[i]= !useold || (img[i] != old[i]);
+  for (i= 1; i< memsize - 2; i++)
+    if (!send[i] && send[i-1] && (send[i+1] || send[i+2])) send[i]= 1;
+
+  t0= msec();
+
+  // Anmeldung
+  for (i= 0; i< 5; i++)
+  {
+    ch= 'B';
+    port_write(&ch, 1);
+    do r= port_getc(1000); while ((r >= 0) && (r != 'b'));
+    if (r == 'b') break;
+  }
+  if (r != 'b')
+  {
+    fprintf(stderr, "no answer, is the CP1 in program 5 (LOAd) ?\n");
+    return 1;
+  }
+
+  blocks= 0; sent= 0; retries= 0;
+  adr= 0;
+  while (adr < memsize)
+  {
+    if (!send[adr]) { adr++; continue; }
+    end= adr;
+    while ((end < memsize) && send[end] && (end - adr < words)) end++;
+    n= end - adr;
+    r= send_block(img, adr, n);
+    if (r < 0)
+    {
+      ch= blk_can;
+      port_write(&ch, 1);
+      fprintf(stderr, "block %d..%d failed\n", adr, end - 1);
+      return 1;
+    }
+    blocks++; sent+= n; retries+= r;
+    adr= end;
+  }
+
+  for (i= 0; i< retries_max; i++)
+  {
+    ch= blk_eot;
+    port_write(&ch, 1);
+    r= port_getc(reply_ms);
+    if (r == blk_ack) break;
+  }
+  if (r != blk_ack)
+  {
+    fprintf(stderr, "no acknowledge for end of transfer\n");
+    return 1;
+  }
+
+  if (!quiet)
+    printf("  %d words in %d blocks, %d retries, %.0f ms\n", sent, blocks, retries, msec() - t0);
+  close(fd);
+  return 0;
+}
@@ -15,17 +15,31 @@
   #include <string.h>
   #include <stdint.h>
   #include <ctype.h>
-  #include <avr/io.h>
-  #include <avr/interrupt.h>
-  #include <util/delay.h>
-
-  #include "avr_gpio.h"
-  #include "cp1_uart.h"
-  #include "cp1_tm1637.h"
-  #include "cp1_adc.h"
-  #include "cp1_eeprom_i2c.h"
-  #include "cp1_vports.h"
-  #include "cp1_pwm.h"
+
+  #if defined(__AVR__)
+
+    #include <avr/io.h>
+    #include <avr/interrupt.h>
+    #include <avr/eeprom.h>
+    #include <util/delay.h>
+    #include <util/crc16.h>
+    #include <util/atomic.h>
+    #include <avr/sleep.h>
+
+    #include "avr_gpio.h"
+    #include "cp1_uart.h"
+    #include "cp1_tm1637.h"
+    #include "cp1_adc.h"
+    #include "cp1_eeprom_i2c.h"
+    #include "cp1_vports.h"
+    #include "cp1_pwm.h"
+
+  #else
+
+    // Build der virtuellen CPU auf einem Linux-Host (siehe ./host)
+    #include "host/cp1_host.h"
+
+  #endif
   
   #define  baudrate            38400
 
@@ -36,11 +50,56 @@
   
   // Mnemonics in der Assemblerliste
   #define  mnemanz             67  
+  // Opcodes in der Assemblerliste (0 = db .. 0x42 = .org)
+  #define  mnemopcanz          67
 
   #define  memsize             256        // in Words
   
   #define  eep_memsize         16384       // in Bytes
 
+  // cpu_profile 1 : Ausfuehrungsprofil je Opcode und Programmadresse
+  //                 (cp1_prof.cpp), belegt ca. 800 Byte RAM
+  //             0 : kein Profil
+  #ifndef cpu_profile
+    #define  cpu_profile       0
+  #endif
+
+  // cpu_threaded 1 : cpu_run wird durch den Interpreter mit Sprungtabelle
+  //                  ersetzt (cpu_run_thr in cp1_cpu_thr.cpp)
+  //              0 : cpu_run mit switch-Anweisung (cp1_cpu_v43.cpp)
+  #ifndef cpu_threaded
+    #define  cpu_threaded      0
+  #endif
+
+  // cpu_debug 1 : Haltepunkte, Watchpoints und Haltebedingungen (cp1_debug.cpp),
+  //               cpu_run wird dazu zusaetzlich mit Pruefungen uebersetzt
+  //               (bei cpu_threaded == 1 der switch-Interpreter)
+  //           0 : kein Debugger (Voreinstellung). cpu_run ist mit 1 zweimal im
+  //               Flash, Flash- und RAM-Bedarf auf dem ATmega328 vor dem
+  //               Einschalten mit avr-size pruefen
+  #ifndef cpu_debug
+    #define  cpu_debug         0
+  #endif
+
+  // cpu_sched 1 : Programme laufen in Zeitscheiben (cpu_step_n), zwischen den
+  //               Zeitscheiben bedient sched_run (kosmos_cp1_v43.ino) Anzeige,
+  //               Tastatur und serielle Schnittstelle. cdel und int 1 werden
+  //               zu Weckzeiten statt Warteschleifen
+  //           0 : cpu_run belegt den Controller bis hlt oder STP (Voreinstellung,
+  //               Verhalten wie im Original)
+  #ifndef cpu_sched
+    #define  cpu_sched         0
+  #endif
+
+  // cpu_i2ctrace 1 : Mitschnitt der Transaktionen auf dem EEProm-Bus mit
+  //                  Zeitstempel (cp1_i2ctrace.cpp), Anzeige im Terminal
+  //                  mit [i]2c trace. Belegt Timer1 (kollidiert mit PWM)
+  //                  und ca. 160 Byte RAM
+  //              0 : kein Mitschnitt
+  #ifndef cpu_i2ctrace
+    #define  cpu_i2ctrace      0
+  #endif
+
   typedef struct kcomp
   {
     uint8_t pc;
@@ -54,10 +113,26 @@
     uint16_t stack[8];
     uint16_t mem[memsize];    
   } kcomp;
+
+  // nach jedem Schreiben in kcomp::mem wird das Wort (bzw. nach dem Laden /
+  // Verschieben eines ganzen Programms der gesamte Speicher) fuer das
+  // Speichern als geaendert markiert (cp1_prgstore.h)
+  #define cpu_invalidate(vcp1, adr)      prg_touch(adr)
+  #define cpu_invalidate_all(vcp1)       prg_touchall()
   
   extern uint8_t   err;
+
+  #include "cp1_hal.h"
+  #include "cp1_prof.h"
+  #include "cp1_i2ctrace.h"
+  #include "cp1_debug.h"
+  #include "cp1_srcasm.h"
+  #include "cp1_blkload.h"
+  #include "cp1_prgstore.h"
   
   extern const uint8_t mnemset[mnemanz][13] PROGMEM;
+  extern const uint8_t mnemsort[mnemanz] PROGMEM;     // Index, generiert in cp1_mnemidx.h
+  extern const uint8_t mnemopc[mnemopcanz] PROGMEM;
   
   /*  ---------------------------------------------------------
                              Prototypen
@@ -65,10 +140,33 @@
   // in cp1_cpu.c      
   void cpu_reset(kcomp *vcp1);
   void cpu_run(kcomp *vcp1, uint8_t stepmode);
+
+  // in cp1_cpu_thr.cpp
+  void cpu_run_thr(kcomp *vcp1, uint8_t stepmode);
+  #if (cpu_threaded == 1) && (cpu_debug == 0)
+    #define cpu_run(vcp1, stepmode)        cpu_run_thr(vcp1, stepmode)
+  #endif
+
+  #if (cpu_sched == 1)
+    // Zustand nach cpu_step_n
+    #define  cpu_halt            0          // hlt, Fehler oder Haltepunkt (err)
+    #define  cpu_busy            1          // Zeitscheibe aufgebraucht
+    #define  cpu_sleep           2          // wartet bis cpu_wake (cdel, int 1)
+
+    extern uint8_t  cpu_slicestate;
+    extern uint8_t  cpu_sliced;
+    extern uint32_t cpu_wake;
+    extern uint8_t  cpu_dispval, cpu_dispreq;
+
+    uint8_t cpu_step_n(kcomp *vcp1, uint16_t budget);
+    void cpu_step_thr(kcomp *vcp1, uint16_t budget);
+    void cpu_sleep_ms(uint32_t ms);
+  #endif
   
   // in assemble_line.c
   uint8_t assemble_line(uint8_t *src, uint16_t *prgword, kcomp *vcp1);
   void disassemble_prgword(uint8_t *dest, uint16_t prgword);
+  uint8_t u8_atoi(uint8_t *src, uint8_t *atch, uint8_t *err);
   
   void str_locase(uint8_t *str);
   void str_delch(uint8_t *str, uint8_t pos);
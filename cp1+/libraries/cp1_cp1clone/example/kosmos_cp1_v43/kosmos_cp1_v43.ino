@@ -331,6 +331,98 @@ uint8_t cp1_delay(uint32_t dtime)
   return 0;
 }
 
+#if (cpu_sched == 1)
+
+#define sched_budget    64      // Befehle je Zeitscheibe
+#define sched_keyms     20      // Tastaturabfrage alle 20 ms
+#define sched_dispms    20      // zurueckgestellte Anzeige spaetestens nach 20 ms
+
+/*  ---------------------------------------------------------
+                           sched_showacc
+
+      gibt einen von cdis zurueckgestellten Akkuwert aus
+    --------------------------------------------------------- */
+void sched_showacc(void)
+{
+  if (!cpu_dispreq) return;
+  cpu_dispreq= 0;
+  setdez(cpu_dispval, 0);
+}
+
+/*  ---------------------------------------------------------
+                            sched_run
+
+      laesst das Programm in vcp1 in Zeitscheiben zu
+      sched_budget Befehlen laufen (cpu_step_n). Zwischen
+      den Zeitscheiben werden die Anzeige aktualisiert, die
+      Tastatur (STP) und bei term == 1 die serielle Schnitt-
+      stelle abgefragt:
+
+        ESC : Programm anhalten (wie STP)
+        s   : Programmzaehler und Akku ausgeben
+
+      Waehrend cdel / int 1 (cpu_sleep) schlaeft der
+      Controller bis zum naechsten Timerinterrupt.
+
+      Timer0 (millis_t0) laeuft waehrend des gesamten
+      Programms, danach sind die Interrupts wieder gesperrt.
+
+      Rueckgabe in err wie bei cpu_run, 255 = mit STP / ESC
+      angehalten
+    --------------------------------------------------------- */
+void sched_run(kcomp *vcp1, uint8_t term)
+{
+  uint8_t  state, ch;
+  uint32_t now, tkey, tdisp;
+
+  cpu_slicestate= cpu_halt;
+  cpu_dispreq= 0;
+  TCNT0= 0;
+  sei();
+  tkey= hal_millis();
+  tdisp= tkey;
+  set_sleep_mode(SLEEP_MODE_IDLE);
+
+  do
+  {
+    state= cpu_step_n(vcp1, sched_budget);
+    sei();                                     // cp1_delay in Softwareinterrupts sperrt
+    now= hal_millis();                         // die Interrupts wieder
+
+    // Anzeige nicht bei jedem cdis, sondern hoechstens alle sched_dispms
+    if ((state != cpu_busy) || (now - tdisp >= sched_dispms))
+    {
+      sched_showacc();
+      tdisp= now;
+    }
+
+    if (now - tkey >= sched_keyms)
+    {
+      tkey= now;
+      if (readshiftkeys()== 0x82) { err= 255; break; }
+      if (term && uart_ischar())
+      {
+        ch= uart_getchar();
+        if (ch== 0x1b) { err= 255; break; }
+        if (ch== 's')
+        {
+          puts("\n\r pc: "); uart_uint8out(vcp1->pc);
+          puts("  a: "); uart_uint8out(vcp1->a);
+        }
+      }
+    }
+
+    if (state== cpu_sleep) sleep_mode();       // bis zum naechsten Timerinterrupt
+  } while (state != cpu_halt);
+
+  if (state== cpu_sleep) prof_wake();          // mit STP / ESC waehrend cdel, int 1
+  cpu_slicestate= cpu_halt;
+  sched_showacc();
+  cli();
+}
+
+#endif
+
 /*  ---------------------------------------------------------
                              mem2opc
 
@@ -513,6 +605,321 @@ void registers_show(kcomp *vcp1)
   puts("\n\n\r");
 }
 
+#if (cpu_profile == 1)
+
+/*  ---------------------------------------------------------
+                          prof_show
+
+       zeigt das Ausfuehrungsprofil auf dem UART an:
+       Befehle je Opcode, Ausfuehrungen je Programmadresse
+       und die in cdel / int verbrachte Zeit. Anschliessend
+       koennen die Zaehler geloescht werden.
+    --------------------------------------------------------- */
+void prof_show(kcomp *vcp1)
+{
+  uint8_t  strsrc[20];
+  uint32_t total;
+  uint16_t i;
+  uint8_t  m, b, scan;
+
+  total= 0;
+  for (i= 1; i<= opcmax; i++) total += prof.opccnt[i];
+
+  puts("\n\r ---- Profile ----\n\r");
+  puts("\n\r instructions: ");
+  uart_uint32out(total);
+
+  puts("\n\n\r opc       count   mnemonic");
+  puts("\n\r ----------------------------------");
+  for (i= 1; i<= opcmax; i++)
+  {
+    if (!prof.opccnt[i]) continue;
+    puts("\n\r ");
+    uart_uint8out(i);
+    puts(" ");
+    uart_uint32out(prof.opccnt[i]);
+    puts("   ");
+    // Mnemonic aus der Liste des Assemblers
+    m= pgm_read_byte(&mnemopc[i]);
+    if (m != 0xff)
+      for (scan= 1; (b= pgm_read_byte(&mnemset[m][scan])); scan++) uart_putchar(b);
+  }
+
+  total= 0;
+  for (i= 0; i< memsize; i++) total += prof.pccnt[i];
+
+  puts("\n\n\r addr      count    %   mnemonic");
+  puts("\n\r ----------------------------------");
+  for (i= 0; i< memsize; i++)
+  {
+    if (!prof.pccnt[i]) continue;
+    puts("\n\r ");
+    uart_uint8out(i);
+    puts(" ");
+    uart_uint32out(prof.pccnt[i]);
+    puts("  ");
+    uart_uint8out((prof.pccnt[i] * 100ul) / total);
+    puts("   ");
+    disassemble_prgword(&strsrc[0], vcp1->mem[i]);
+    puts_ram(&strsrc[0]);
+  }
+  if (prof.pcscale)
+  {
+    puts("\n\r address counts divided by 2^");
+    uart_uint8out(prof.pcscale);
+  }
+
+  puts("\n\n\r cdel calls: ");
+  uart_uint16out(prof.delay_cnt, 0);
+  puts("   time [ms]: ");
+  uart_uint32out(prof.delay_ms);
+  puts("\n\r int  calls: ");
+  uart_uint16out(prof.intr_cnt, 0);
+  puts("   time [ms]: ");
+  uart_uint32out(prof.intr_ms);
+
+  puts("\n\n\r clear profile data ? [y/n]");
+  if (uart_getchar()== 'y')
+  {
+    prof_clear();
+    puts(" ... cleared");
+  }
+  puts("\n\n\r");
+}
+
+#endif
+
+#if (cpu_i2ctrace == 1)
+
+/*  ---------------------------------------------------------
+                          i2ctr_show
+
+       gibt den Mitschnitt des EEProm-Busses als CSV auf
+       dem UART aus (aeltester Eintrag zuerst):
+
+         addr,dir,bytes,ack,rs,start_us,dur_us
+
+       addr: 7-Bit Adresse (dezimal, 80 = 24LCxx);
+       ack: A = ok, NA = Nack auf Adresse, ND = Nack auf
+       Daten; rs: 1 = mit wiederholtem Start begonnen.
+       Anschliessend kann der Mitschnitt geloescht werden.
+    --------------------------------------------------------- */
+void i2ctr_show(void)
+{
+  i2ctr_rec r;
+  uint8_t   i;
+
+  puts("\n\r addr,dir,bytes,ack,rs,start_us,dur_us");
+  for (i= 0; i2ctrace_get(i, &r); i++)
+  {
+    puts("\n\r ");
+    uart_uint8out(r.addr);
+    if (r.flags & i2ctr_fread) puts(",r,"); else puts(",w,");
+    uart_uint8out(r.cnt);
+    if (r.flags & i2ctr_fnackadr) puts(",NA,");
+    else if (r.flags & i2ctr_fnackdat) puts(",ND,");
+    else puts(",A,");
+    uart_putchar((r.flags & i2ctr_frstart) ? '1' : '0');
+    uart_putchar(',');
+    uart_uint32out(i2ctrace_us(r.start));
+    uart_putchar(',');
+    uart_uint32out(i2ctrace_us(r.dur));
+  }
+  if (i2ctr_lost)
+  {
+    puts("\n\r lost: ");
+    uart_uint16out(i2ctr_lost, 0);
+  }
+
+  puts("\n\n\r clear i2c trace ? [y/n]");
+  if (uart_getchar()== 'y')
+  {
+    i2ctrace_clear();
+    puts(" ... cleared");
+  }
+  puts("\n\n\r");
+}
+
+#endif
+
+#if (cpu_debug == 1)
+
+/*  ---------------------------------------------------------
+                         dbg_showhit
+
+       zeigt an, an welchem Haltepunkt / Watchpoint bzw.
+       wegen welcher Bedingung das Programm angehalten hat
+    --------------------------------------------------------- */
+void dbg_showhit(kcomp *vcp1)
+{
+  uint8_t strsrc[20];
+
+  if (!dbg.hit) return;
+  switch (dbg.hit)
+  {
+    case dbg_hitbp : puts(" breakpoint at "); break;
+    case dbg_hitwp :
+    {
+      puts(" watchpoint ");
+      uart_uint8out(dbg.hitadr);
+      puts(" written at ");
+      break;
+    }
+    default        : puts(" condition true after "); break;
+  }
+  uart_uint8out(dbg.hitpc);
+  puts(":  ");
+  disassemble_prgword(&strsrc[0], vcp1->mem[dbg.hitpc]);
+  puts_ram(&strsrc[0]);
+  puts("\n\n\r");
+  dbg.hit= 0;
+}
+
+/*  ---------------------------------------------------------
+                          dbg_list
+
+       listet Haltepunkte, Watchpoints und Bedingungen auf
+    --------------------------------------------------------- */
+static void dbg_list(void)
+{
+  uint8_t i;
+
+  puts("\n\r breakpoints :");
+  for (i= 0; i< dbg.bpanz; i++) { uart_putchar(' '); uart_uint8out(dbg.bp[i]); }
+  puts("\n\r watchpoints :");
+  for (i= 0; i< dbg.wpanz; i++) { uart_putchar(' '); uart_uint8out(dbg.wp[i]); }
+  puts("\n\r conditions  :");
+  for (i= 0; i< dbg.condanz; i++)
+  {
+    uart_putchar(' ');
+    if (dbg.cond[i].src == dbg_srcmem)
+    {
+      uart_putchar('@');
+      uart_uint8out(dbg.cond[i].adr);
+    }
+    else
+    {
+      uart_putchar(dbg.cond[i].src);
+    }
+    switch (dbg.cond[i].op)
+    {
+      case '=' : puts(" == "); break;
+      case '!' : puts(" != "); break;
+      case '<' : puts(" < "); break;
+      default  : puts(" > "); break;
+    }
+    uart_uint8out(dbg.cond[i].value);
+    if (i < dbg.condanz-1) uart_putchar(',');
+  }
+}
+
+/*  ---------------------------------------------------------
+                        terminal_debug
+
+       Haltepunkte, Watchpoints und Haltebedingungen
+       setzen und loeschen, Eingabe zeilenweise:
+
+         b adr        Haltepunkt setzen / loeschen
+         w adr        Watchpoint setzen / loeschen
+         c r op val   Bedingung, r = a..e oder @adr,
+                      op = == != < >
+         c            alle Bedingungen loeschen
+         x            alles loeschen
+
+       Rueckgabe:
+         0x00 : beendet mit ESC oder leerer Zeile
+         0xfe : STP wurde aktiviert
+    --------------------------------------------------------- */
+uint8_t terminal_debug(kcomp *vcp1)
+{
+  uint8_t strsrc[20];
+  uint8_t *tok[4];
+  uint8_t *p;
+  uint8_t ch, n, adr, val, atch, e, r, src, op;
+
+  puts("\n\r ---- Breakpoints ----");
+  puts("\n\r b adr      : set / delete breakpoint");
+  puts("\n\r w adr      : set / delete watchpoint (memory write)");
+  puts("\n\r c r op val : stop condition, r = a..e or @adr, op = == != < >");
+  puts("\n\r c          : delete conditions");
+  puts("\n\r x          : delete all");
+  puts("\n\r [esc] quits\n\r");
+  do
+  {
+    dbg_list();
+    puts("\n\n\r dbg> ");
+    ch= uart_readstr(&strsrc[0], 16);
+    if (ch== 0xfe) return 0xfe;
+    if (ch != 0x0d) break;
+
+    // in max. 4 durch Leerzeichen getrennte Teile zerlegen
+    str_locase(&strsrc[0]);
+    n= 0;
+    p= &strsrc[0];
+    while (*p && (n < 4))
+    {
+      while (*p== ' ') *p++= 0;
+      if (!*p) break;
+      tok[n++]= p;
+      while (*p && (*p != ' ')) p++;
+    }
+    if (!n) break;
+
+    e= 0; r= 0;
+    switch (tok[0][0])
+    {
+      case 'b' :
+      case 'w' :
+      {
+        if (n != 2) { e= 1; break; }
+        adr= u8_atoi(tok[1], &atch, &e);
+        if (e || atch) { e= 1; break; }
+        if (tok[0][0]== 'b') r= dbg_togglebp(adr); else r= dbg_togglewp(adr);
+        break;
+      }
+      case 'c' :
+      {
+        if (n== 1) { dbg_clearcond(); break; }
+        if (n != 4) { e= 1; break; }
+        adr= 0;
+        src= tok[1][0];
+        if (src== '@')
+        {
+          adr= u8_atoi(tok[1], &atch, &e);
+          src= dbg_srcmem;
+        }
+        else
+        {
+          if ((tok[1][1] != 0) || (src < 'a') || (src > 'e')) e= 1;
+        }
+        if (e) { e= 1; break; }
+
+        op= 0;
+        if (!strcmp((char *)tok[2], "==") || !strcmp((char *)tok[2], "=")) op= '=';
+        if (!strcmp((char *)tok[2], "!=")) op= '!';
+        if (!strcmp((char *)tok[2], "<")) op= '<';
+        if (!strcmp((char *)tok[2], ">")) op= '>';
+        val= u8_atoi(tok[3], &atch, &e);
+        if ((!op) || e || atch) { e= 1; break; }
+        r= dbg_addcond(src, adr, op, val);
+        break;
+      }
+      case 'x' :
+      {
+        dbg_clear();
+        break;
+      }
+      default  : e= 1; break;
+    }
+    if (e) puts("\n\r syntax error");
+    if (r== 0xff) puts("\n\r no free entry");
+  } while (1);
+  puts("\n\r");
+  return 0;
+}
+
+#endif
+
 /*  ---------------------------------------------------------
                           prg_moveto
 
@@ -575,8 +982,145 @@ void prg_moveto(kcomp *vcp1, uint8_t movadr, uint8_t startadr, uint8_t stopadr)
         }
       }
     }
+    cpu_invalidate_all(vcp1);
+  }
+
+}
+
+/*  ---------------------------------------------------------
+                       srcupload_line
+
+      uebergibt eine empfangene Zeile an den Quelltext-
+      assembler. Rueckgabe 1 bei ".end"
+    --------------------------------------------------------- */
+static uint8_t srcupload_line(srcasm *sa, uint8_t *line, uint8_t l, uint8_t toolong)
+{
+  uint8_t *p;
+
+  line[l]= 0;
+  p= line;
+  while ((*p== ' ') || (*p== '\t')) p++;
+  if (!strncmp((char *)p, ".end", 4)) return 1;
+
+  if (toolong)
+  {
+    sa->line++;
+    srcasm_error(sa, sa_err_syntax, 0xff);
+  }
+  else
+  {
+    srcasm_line(sa, line);
+  }
+  return 0;
+}
+
+/*  ---------------------------------------------------------
+                     terminal_srcupload
+
+      empfaengt einen kompletten CP1-Quelltext mit Labels
+      und uebersetzt ihn waehrend der Uebertragung Zeile
+      fuer Zeile in den Programmspeicher (cp1_srcasm.cpp).
+
+      Der Empfang laeuft interruptgesteuert ueber einen
+      Ringpuffer, der Quelltext kann also ohne Zeilen-
+      verzoegerung mit voller Baudrate gesendet werden.
+      Ende der Uebertragung: Zeile ".end", ESC, Ctrl-Z oder
+      2 Sekunden ohne Zeichen.
+      Kommentare werden schon beim Empfang verworfen und
+      zaehlen nicht zur max. Zeilenlaenge.
+
+      Stack: srcasm (316 Bytes) und Zeilenpuffer (48 Bytes)
+      liegen nur waehrend des Uploads auf dem Stack, mit
+      srcasm_line / assemble_line zusammen ca. 500 Bytes
+      (siehe cp1_srcasm.h).
+
+      Rueckgabe:
+        0x00 : Upload beendet
+        0xfe : STP wurde aktiviert
+    --------------------------------------------------------- */
+uint8_t terminal_srcupload(kcomp *vcp1)
+{
+  srcasm   sa;
+  uint8_t  line[sa_linelen];
+  uint8_t  ch, lastch, l, toolong, comment, started, ende;
+  uint8_t  i, *p;
+  uint32_t t0, now;
+
+  puts("\n\r ---- Bulk source upload ----");
+  puts("\n\r send source now, end with .end, [esc] or ^Z\n\r");
+
+  srcasm_init(&sa, vcp1);
+  l= 0; toolong= 0; comment= 0; lastch= 0; started= 0; ende= 0; t0= 0;
+
+  uart_rxint_enable();
+  do
+  {
+    if (!uart_rxavail())
+    {
+      if (readshiftkeys() == 0x82) ende= 0xfe;
+      if (started)
+      {
+        cli(); now= millis_t0; sei();
+        if (now - t0 > 2000) ende= 1;               // Timeout
+      }
+      continue;
+    }
+
+    ch= uart_rxget();
+    cli(); t0= millis_t0; sei();
+    started= 1;
+
+    if ((ch== 0x1b) || (ch== 0x1a))
+    {
+      ende= 1;
+    }
+    else
+    if ((ch== 0x0d) || (ch== 0x0a))
+    {
+      if ((ch== 0x0d) || (lastch != 0x0d))          // CR, LF oder CR-LF
+      {
+        ende= srcupload_line(&sa, line, l, toolong);
+        l= 0; toolong= 0; comment= 0;
+      }
+    }
+    else
+    if (!comment)
+    {
+      if (ch== ';') comment= 1;
+      else
+      if (l < sa_linelen-1) line[l++]= ch; else toolong= 1;
+    }
+    lastch= ch;
+  } while (!ende);
+
+  if ((ende != 0xfe) && l) srcupload_line(&sa, line, l, toolong);   // letzte Zeile ohne Zeilenende
+  uart_rxint_disable();
+  if (uart_rxoverflow()) srcasm_error(&sa, sa_err_overflow, 0xff);
+  srcasm_finish(&sa);
+
+  puts("\n\r lines: "); uart_uint16out(sa.line, 0);
+  puts("   words: "); uart_uint16out(sa.words, 0);
+  puts("   labels: "); uart_uint8out(sa.symanz);
+  puts("   errors: "); uart_uint16out(sa.errcnt, 0);
+  puts("\n\r");
+
+  for (i= 0; i< sa.erranz; i++)
+  {
+    puts("\n\r line "); uart_uint16out(sa.err[i].line, 0);
+    puts(": ");
+    uart_putromstring((const uint8_t *)srcasm_errtext(sa.err[i].code));
+    if (sa.err[i].sym != 0xff)
+    {
+      puts(" \"");
+      for (p= (uint8_t *)sa.sym[sa.err[i].sym].name; *p; p++) uart_putchar(*p);
+      uart_putchar('"');
+    }
   }
+  if (sa.errcnt > sa.erranz) puts("\n\r ...");
+  puts("\n\n\r");
 
+  if (ende== 0xfe) return 0xfe;
+  return 0;
 }
 
 /*  ---------------------------------------------------------
@@ -595,7 +1139,16 @@ void terminal_showhelp(void)
   puts("\n\r press a key to enter function\n\r");
   puts("\n\r [a]ssemble       [d]isassemble    [m]emory adress set   single s[t]ep");
   puts("\n\r [l]oad program   [s]tore program  [r]un program         [c]lear and reset");
-  puts("\n\r m[o]ve memory    d[u]mp memory");
+  puts("\n\r m[o]ve memory    d[u]mp memory    [b]ulk source upload");
+  #if (cpu_profile == 1)
+    puts("    [p]rofile");
+  #endif
+  #if (cpu_i2ctrace == 1)
+    puts("    [i]2c trace");
+  #endif
+  #if (cpu_debug == 1)
+    puts("\n\r brea[k]points");
+  #endif
 
   puts("\n\n\r [h]elp           [q]uit terminal mode\n\n\r");
 }
@@ -632,6 +1185,9 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
 
   if (showhelp) terminal_showhelp();
   if (showregs) registers_show(vcp1);
+  #if (cpu_debug == 1)
+    if (showregs) dbg_showhit(vcp1);
+  #endif
 
   do
   {
@@ -831,6 +1387,7 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
                   puts("\n\r");
 
                   vcp1->mem[vcp1->addr]= ((prgword / 1000) << 8) + (prgword % 1000);
+                  cpu_invalidate(vcp1, vcp1->addr);
                   vcp1->addr++;
                 }
                 else
@@ -858,10 +1415,20 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
         break;
       }
 
+      // Quelltext mit Labels am Stueck hochladen
+      case 'b' :
+      {
+        if (terminal_srcupload(vcp1) == 0xfe) mch= 'q';
+        break;
+      }
+
       // Programm starten
       case 'r' :
       {
         puts("n\r program is running...\n\r");
+        #if (cpu_sched == 1)
+          puts(" [esc] stop, [s] show pc / accu\n\r");
+        #endif
 //        vcp1->pc= 0;
         vcp1->sp= 7;
         err= 0;
@@ -881,6 +1448,9 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
         err= 0;
         cpu_run(vcp1, 1);
         registers_show(vcp1);
+        #if (cpu_debug == 1)
+          dbg_showhit(vcp1);
+        #endif
         do
         {
           i2= readshiftkeys();
@@ -897,11 +1467,11 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
       case 'l' :
       {
         puts("\n\r numbers of storage places: ");
-        uart_uint8out((eep_memsize / 512) + 1);
+        uart_uint8out(prg_max);
         puts("\n\r enter program number to load: ");
         uart_readu8int(&prgnr);
         puts("\n\r");
-        if (prgnr> ((eep_memsize / 512) + 1))
+        if (prgnr> prg_max)
         {
           puts("\n\r there is no storage place with this number");
           puts("\n\r no program is loaded\n\n\r");
@@ -910,24 +1480,10 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
         else
         {
           puts("\n\r loading program... ");
-          if (prgnr < 2)
-          {
-            for (w= 0; w != (memsize-1); w++)
-            {
-              uint16_t hib, lob;
-
-              hib= eeprom_read_byte((w * 2) + (prgnr*memsize*2));        // Hi-Byte lesen
-              lob= eeprom_read_byte((w * 2) + 1 + (prgnr*memsize*2));    // Lo-Byte lesen
-
-              vcp1->mem[w]= (hib << 8) | (lob & 0xff);
-            }
-          }
+          if (prg_load(vcp1, prgnr))
+            puts("checksum error !\n\r");
           else
-          {
-            ptr = (uint8_t *)&vcp1->mem[0];
-            eep_readbuf((prgnr-2) * memsize, ptr, memsize * 2);
-          }
-          puts("done !\n\r");
+            puts("done !\n\r");
         }
 
         break;
@@ -937,11 +1493,11 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
       case 's' :
       {
         puts("\n\r numbers of storage places: ");
-        uart_uint8out((eep_memsize / 512) + 1);
+        uart_uint8out(prg_max);
         puts("\n\r enter program number to store: ");
         uart_readu8int(&prgnr);
         puts("\n\r");
-        if (prgnr> ((eep_memsize / 512) + 1))
+        if (prgnr> prg_max)
         {
           puts("\n\r there is no storage place with this number");
           puts("\n\r no program is stored\n\n\r");
@@ -950,20 +1506,10 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
         else
         {
           puts("\n\r saving program... ");
-          if (prgnr < 2)
-          {
-            for (w= 0; w != (memsize-1); w++)
-            {
-              eeprom_write_byte((w * 2) + (prgnr*memsize*2), vcp1->mem[w] >> 8);          // Hi-Byte schreiben
-              eeprom_write_byte(((w * 2)+1) + (prgnr*memsize*2), vcp1->mem[w] & 0xff);
-            }
-          }
-          else
-          {
-            ptr = (uint8_t *)&vcp1->mem[0];
-            eep_writebuf((prgnr-2) * memsize, ptr, memsize * 2);
-          }
-          puts("done !\n\r");
+          i= prg_save(vcp1, prgnr);
+          puts("done ! (");
+          uart_uint16out(i, 0);
+          if (prgnr < 2) puts(" words written)\n\r"); else puts(" blocks written)\n\r");
         }
         break;
       }
@@ -987,6 +1533,33 @@ uint8_t terminal_mode(kcomp *vcp1, uint8_t showhelp, uint8_t showregs)
         break;
       }
 
+      #if (cpu_debug == 1)
+      // Haltepunkte, Watchpoints, Bedingungen
+      case 'k' :
+      {
+        if (terminal_debug(vcp1) == 0xfe) mch= 'q';
+        break;
+      }
+      #endif
+
+      #if (cpu_profile == 1)
+      // Ausfuehrungsprofil anzeigen
+      case 'p' :
+      {
+        prof_show(vcp1);
+        break;
+      }
+      #endif
+
+      #if (cpu_i2ctrace == 1)
+      // Mitschnitt I2C-Bus anzeigen
+      case 'i' :
+      {
+        i2ctr_show();
+        break;
+      }
+      #endif
+
       // Show help
       case 'h' :
       {
@@ -1171,6 +1744,14 @@ uint8_t softw_intr(kcomp *vcp1, int data)
         break;
       }
       
+      #if (cpu_sched == 1)
+        if (cpu_sliced)                // Weckzeit statt Warteschleife (sched_run)
+        {
+          cpu_sleep_ms((uint32_t)cnt * vcp1->a);
+          break;
+        }
+      #endif
+
       wu2= wait_shiftunpress;
       wait_shiftunpress= 0;
       for (i= 0; i< cnt; i++)
@@ -1652,6 +2233,16 @@ uint8_t softw_intr(kcomp *vcp1, int data)
   return lastkey;
 }  // softw_intr
 
+/*  ---------------------------------------------------------
+                      program_download
+
+      Festprogramm 5: Programm ueber den UART empfangen
+
+        'U' : altes Protokoll, 256 Worte mit Quittung 'o'
+              je Wort
+        'B' : blockweise mit CRC16 und Quittung je Block,
+              auch nur einzelne Bereiche (cp1_blkload.cpp)
+    --------------------------------------------------------- */
 void program_download(kcomp *vcp1)
 {
   uint8_t hby, lby, ch;
@@ -1675,7 +2266,7 @@ void program_download(kcomp *vcp1)
       ch= uart_getchar();
     }  
     if (readshiftkeys() == 0x82) ch= 'E';    
-  } while ((ch != 'U') && (ch != 'E'));
+  } while ((ch != 'U') && (ch != 'B') && (ch != 'E'));
   if (ch == 'U')
   {
     delay(200);
@@ -1691,11 +2282,26 @@ void program_download(kcomp *vcp1)
       setdez(i,0);
       uart_putchar('o');
     }
+    cpu_invalidate_all(vcp1);
     load_showok();
     delay(1000);
     vcp1->sp= 7;
     vcp1->pc= 0;
   }
+  if (ch == 'B')
+  {
+    uart_putchar('b');
+    showmask= 0x27;
+    lastcmdchar= a_load;
+    setdp(3,1);
+    if (blk_receive(vcp1) == 0)
+    {
+      load_showok();
+      delay(1000);
+    }
+    vcp1->sp= 7;
+    vcp1->pc= 0;
+  }
   showmask= 0x27;
   lastcmdchar= a_pc;
   setdp(3,1);
@@ -1716,7 +2322,6 @@ int main(void)
   uint16_t  w;
   uint8_t   outset= 0;
   uint8_t   ack;
-  uint8_t   *ptr;
   uint8_t   lastkey;
 
   uint8_t   startadr, stopadr, movadr;
@@ -1730,6 +2335,9 @@ int main(void)
   p2_bytewrite(0);
 
   timer0_init();
+  #if (cpu_i2ctrace == 1)
+    i2ctrace_begin();
+  #endif
   tm16_init();
   tm16_setbright(seg7_bright);
 
@@ -1799,7 +2407,11 @@ int main(void)
                 setdez(0,0);
                 showmask= 0x07;                              // waehrend Programmlauf nur
                                                              // Zahlen anzeigen
-                cpu_run(&cp1, 0);
+                #if (cpu_sched == 1)
+                  sched_run(&cp1, 1);
+                #else
+                  cpu_run(&cp1, 0);
+                #endif
                 delay(80);
 
                 if (err== 255)                               // wurde Programm mit STP angehalten ?
@@ -1879,7 +2491,11 @@ int main(void)
         setdez(0,0);
         showmask= 0x07;                              // waehrend Programmlauf nur
                                                      // Zahlen anzeigen
-        cpu_run(&cp1, 0);
+        #if (cpu_sched == 1)
+          sched_run(&cp1, 0);
+        #else
+          cpu_run(&cp1, 0);
+        #endif
         delay(80);
 
         if (err== 255)                               // wurde Programm mit STP angehalten ?
@@ -2012,6 +2628,7 @@ int main(void)
         if (!err)
         {
           cp1.mem[cp1.addr]= (opc << 8) | data;     // Adresse mit Opcode und Datum beschreiben
+          cpu_invalidate(&cp1, cp1.addr);
 
           lastcmdchar= a_inp;                       // E fuer Input okay
           showmask= 0x3f;                           // alles anzeigen
@@ -2034,29 +2651,18 @@ int main(void)
       //     ( insgesamt 1 kByte). Alle anderen Speichernummern beschreiben das
       //     externe EEProm. Die hoechstmoegliche Angabe in Data richtet sich somit
       //     nach der Groesse des EEPROMS. Bsp.: Speichergroesse EEPROM = 8192 sind
-      //     16 x 512 Byte. Somit sind insgesamt 18 Speicherplaetze vorhanden und die
-      //     hoechste Angabe fuer Data ist 17.
+      //     16 x 512 Byte, davon enthalten die letzten 512 Byte die Pruefsummen
+      //     (cp1_prgstore.h). Somit sind insgesamt 17 Speicherplaetze vorhanden und
+      //     die hoechste Angabe fuer Data ist 16.
       case 0x89 :
       {
         if (kanz != 3) { err= 1; break; }
-        if (data> (eep_memsize / 512) + 1) { err= 7; break; }
+        if (data> prg_max) { err= 7; break; }
         if (opc> 0) { err= 7; break; }
 
         store_showrunning();
 
-        if (data < 2)
-        {
-          for (w= 0; w< memsize; w++)
-          {
-            eeprom_write_byte((w * 2) + (data*memsize*2), cp1.mem[w] >> 8);        // Hi-Byte schreiben
-            eeprom_write_byte(((w * 2)+1) + (data*memsize*2), cp1.mem[w] & 0xff);
-          }
-        }
-        else
-        {
-          ptr = (uint8_t *)&cp1.mem[0];
-          eep_writebuf((data-2) * memsize, ptr, memsize * 2);
-        }
+        prg_save(&cp1, data);
 
         store_showok();
         delay(1000);
@@ -2072,29 +2678,13 @@ int main(void)
       case 0x80 :
       {
         if (kanz != 3) { err= 1; break; }
-        if (data> (eep_memsize / 512) + 1) { err= 7; break; }
+        if (data> prg_max) { err= 7; break; }
         if (opc> 0) { err= 7; break; }
 
         load_showrunning();
         delay(500);                  // einfach nur um die Anzeige kurz zu sehen
 
-        if (data < 2)
-        {
-          for (w= 0; w< memsize; w++)
-          {
-            uint16_t hib, lob;
-
-            hib= eeprom_read_byte((w * 2) + (data*memsize*2));        // Hi-Byte lesen
-            lob= eeprom_read_byte((w * 2) + 1 + (data*memsize*2));    // Lo-Byte lesen
-
-            cp1.mem[w]= (hib << 8) | (lob & 0xff);
-          }
-        }
-        else
-        {
-          ptr = (uint8_t *)&cp1.mem[0];
-          eep_readbuf((data-2) * memsize, ptr, memsize * 2);
-        }
+        if (prg_load(&cp1, data)) err= 12;          // Pruefsumme stimmt nicht
 
         cp1.pc= 0;
         showmask= 0x27;
@@ -0,0 +1,312 @@
+/* ---------------------------------------------------------------------------
+                                cp1_eeplog.cpp
+
+     Ringspeicher fuer Datensaetze auf dem externen EEProm des CP1+ Boards
+     (siehe cp1_eeplog.h)
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <util/crc16.h>
+#include "cp1_eeplog.h"
+
+/* -------------------------------------------------------
+                        eeplog::eeplog
+
+    dev     : EEProm, auf dem gespeichert wird
+    base    : Anfangsadresse des Bereichs im EEProm
+    size    : Groesse des Bereichs in Bytes
+    datalen : Anzahl Datenbytes je Datensatz
+   ------------------------------------------------------- */
+eeplog::eeplog(eepr *dev, uint16_t base, uint16_t size, uint8_t datalen)
+{
+  uint16_t pgsize, blk;
+
+  eep= dev;
+  this->base= base;
+  this->datalen= datalen;
+  reclen= datalen + elog_overhead;
+
+  // Block: so viele ganze Pages, wie ein Datensatz braucht
+  pgsize= dev->get_pagesize();
+  if (pgsize > elog_bufsize) pgsize= elog_bufsize;
+  blk= ((reclen + pgsize - 1) / pgsize) * pgsize;
+
+  blksize= 0; rpb= 0; blocks= 0; slots= 0;
+  if ((reclen > elog_overhead) && (blk <= elog_bufsize))
+  {
+    blksize= blk;
+    rpb= blksize / reclen;                         // Datensaetze je Block
+    blocks= size / blksize;
+    slots= blocks * rpb;
+    if (slots > elog_seqmask) slots= (elog_seqmask / rpb) * rpb;
+  }
+
+  wr= 0; cnt= 0; seq= 0; bufcnt= 0;
+}
+
+/* -------------------------------------------------------
+                        eeplog::valid
+
+    Rueckgabe: 1 = Ringspeicher benutzbar
+               0 = Datensatz passt nicht in den Puffer
+                   (elog_bufsize), datalen 0 oder Bereich
+                   kleiner als ein Block
+   ------------------------------------------------------- */
+uint8_t eeplog::valid(void)
+{
+  return (slots != 0);
+}
+
+/* -------------------------------------------------------
+                        eeplog::slotadr
+
+    Rueckgabe: Adresse von Datensatz slot im EEProm
+   ------------------------------------------------------- */
+uint16_t eeplog::slotadr(uint16_t slot)
+{
+  return base + (slot / rpb) * blksize + (slot % rpb) * reclen;
+}
+
+/* -------------------------------------------------------
+                        eeplog::reccrc
+
+    CRC16 (XMODEM) ueber Sequenznummer und Daten
+   ------------------------------------------------------- */
+uint16_t eeplog::reccrc(uint8_t *rec)
+{
+  uint16_t crc;
+  uint8_t  i;
+
+  crc= 0;
+  for (i= 0; i< reclen - 2; i++)
+    crc= _crc_xmodem_update(crc, rec[i]);
+  return crc;
+}
+
+/* -------------------------------------------------------
+                        eeplog::readslot
+
+    liest Datensatz slot (aus dem Puffer, falls er noch
+    nicht geschrieben ist)
+
+    data : Ziel fuer die Datenbytes, 0 = nicht kopieren
+    sq   : Sequenznummer des Datensatzes, elog_empty fuer
+           einen leeren Datensatz, elog_bad bei CRC-Fehler
+
+    Rueckgabe: 1 = Datensatz gueltig
+               0 = leer oder CRC-Fehler
+   ------------------------------------------------------- */
+uint8_t eeplog::readslot(uint16_t slot, uint8_t *data, uint16_t *sq)
+{
+  uint8_t  rec[elog_bufsize];
+  uint8_t  *p;
+  uint16_t crc;
+
+  if (bufcnt && (slot >= bufslot) && (slot < bufslot + bufcnt))
+  {
+    p= &buf[(slot - bufslot) * reclen];
+  }
+  else
+  {
+    eep->readbuf(slotadr(slot), rec, reclen);
+    p= rec;
+  }
+
+  *sq= p[0] | (p[1] << 8);
+  if (*sq== elog_empty) return 0;                  // geloeschtes EEProm
+  crc= p[reclen-2] | (p[reclen-1] << 8);
+  if ((*sq & ~elog_seqmask) || (crc != reccrc(p)))
+  {
+    *sq= elog_bad;
+    return 0;
+  }
+  if (data) memcpy(data, &p[2], datalen);
+  return 1;
+}
+
+/* -------------------------------------------------------
+                        eeplog::inrun
+
+    Rueckgabe: 1 = Datensatz slot gehoert zur Folge, die
+                   mit Sequenznummer s0 bei Datensatz 0
+                   beginnt
+               0 = leer oder aelter
+
+    Bei einem CRC-Fehler entscheidet der naechste davor
+    liegende gueltige oder leere Datensatz.
+   ------------------------------------------------------- */
+uint8_t eeplog::inrun(uint16_t slot, uint16_t s0)
+{
+  uint16_t s;
+
+  for (;;)
+  {
+    if (readslot(slot, 0, &s)) return (((s - s0) & elog_seqmask) == slot);
+    if (s != elog_bad) return 0;                   // leer
+    if (!slot) return 1;
+    slot--;
+  }
+}
+
+/* -------------------------------------------------------
+                        eeplog::begin
+
+    sucht den zuletzt geschriebenen Datensatz. Ab Daten-
+    satz 0 steigen die Sequenznummern bis zum zuletzt
+    geschriebenen Datensatz lueckenlos an, danach folgen
+    leere oder aeltere Datensaetze. Die Grenze wird per
+    binaerer Suche bestimmt.
+
+    Datensaetze mit CRC-Fehler am Anfang werden ueber-
+    sprungen, die Sequenznummer von Datensatz 0 ergibt
+    sich aus dem ersten gueltigen Datensatz. Im Bereich
+    dahinter ordnet inrun beschaedigte Datensaetze ihrem
+    Vorgaenger zu.
+
+    Rueckgabe: 1 = Datensaetze vorhanden, 0 = leer
+   ------------------------------------------------------- */
+uint8_t eeplog::begin(void)
+{
+  uint16_t s0, s, lo, hi, mid;
+
+  wr= 0; cnt= 0; seq= 0; bufcnt= 0;
+  if (!slots) return 0;
+
+  // erster gueltiger Datensatz
+  for (lo= 0; lo< slots; lo++)
+  {
+    if (readslot(lo, 0, &s)) break;
+    if (s != elog_bad) return 0;                   // leer
+  }
+  if (lo== slots) return 0;                        // kein gueltiger Datensatz
+  s0= (s - lo) & elog_seqmask;
+
+  hi= slots - 1;                                   // Datensatz lo gehoert sicher dazu
+  while (lo < hi)
+  {
+    mid= lo + ((hi - lo + 1) >> 1);
+    if (inrun(mid, s0))
+      lo= mid;
+    else
+      hi= mid - 1;
+  }
+
+  seq= (s0 + lo + 1) & elog_seqmask;
+  wr= lo + 1;
+  if (wr== slots) wr= 0;
+  readslot(wr, 0, &s);
+  if (s != elog_empty) cnt= slots;                 // Ring bereits einmal umgelaufen
+                  else cnt= lo + 1;
+  return 1;
+}
+
+/* -------------------------------------------------------
+                        eeplog::append
+
+    haengt einen Datensatz mit datalen Bytes an. Ist der
+    Bereich voll, wird der aelteste Datensatz ueber-
+    schrieben. Geschrieben wird, sobald ein Block voll
+    ist (siehe flush).
+   ------------------------------------------------------- */
+void eeplog::append(uint8_t *data)
+{
+  uint8_t  *p;
+  uint16_t crc;
+
+  if (!slots) return;
+  if (!bufcnt) bufslot= wr;
+
+  p= &buf[bufcnt * reclen];
+  p[0]= seq & 0xff;
+  p[1]= seq >> 8;
+  memcpy(&p[2], data, datalen);
+  crc= reccrc(p);
+  p[reclen-2]= crc & 0xff;
+  p[reclen-1]= crc >> 8;
+  bufcnt++;
+
+  seq= (seq + 1) & elog_seqmask;
+  if (cnt < slots) cnt++;
+  wr++;
+  if (wr== slots) wr= 0;
+  if (!(wr % rpb)) flush();                        // Block voll
+}
+
+/* -------------------------------------------------------
+                        eeplog::flush
+
+    schreibt die im Puffer gesammelten Datensaetze (ein
+    Schreibzyklus je Page des Blocks)
+   ------------------------------------------------------- */
+void eeplog::flush(void)
+{
+  if (!bufcnt) return;
+  eep->writebuf(slotadr(bufslot), buf, bufcnt * reclen);
+  bufcnt= 0;
+}
+
+/* -------------------------------------------------------
+                        eeplog::clear
+
+    loescht den gesamten Bereich, bereits geloeschte
+    Bloecke werden nicht geschrieben
+   ------------------------------------------------------- */
+void eeplog::clear(void)
+{
+  uint16_t bl, adr;
+  uint8_t  i;
+
+  bufcnt= 0;
+  for (bl= 0; bl< blocks; bl++)
+  {
+    adr= base + (bl * blksize);
+    eep->readbuf(adr, buf, blksize);
+    for (i= 0; (i< blksize) && (buf[i]== 0xff); i++);
+    if (i< blksize)
+    {
+      memset(buf, 0xff, blksize);
+      eep->writebuf(adr, buf, blksize);
+    }
+  }
+  wr= 0; cnt= 0; seq= 0;
+}
+
+/* -------------------------------------------------------
+                        eeplog::count
+
+    Rueckgabe: Anzahl gespeicherter Datensaetze
+   ------------------------------------------------------- */
+uint16_t eeplog::count(void)
+{
+  return cnt;
+}
+
+/* -------------------------------------------------------
+                        eeplog::capacity
+
+    Rueckgabe: max. Anzahl Datensaetze im Bereich
+   ------------------------------------------------------- */
+uint16_t eeplog::capacity(void)
+{
+  return slots;
+}
+
+/* -------------------------------------------------------
+                        eeplog::read
+
+    liest Datensatz idx (0 = aeltester Datensatz)
+
+    Rueckgabe: 1 = ok
+               0 = idx nicht vorhanden oder CRC-Fehler
+   ------------------------------------------------------- */
+uint8_t eeplog::read(uint16_t idx, uint8_t *data)
+{
+  uint16_t slot, s;
+
+  if (idx >= cnt) return 0;
+  slot= wr + idx + (slots - cnt);
+  if (slot >= slots) slot -= slots;
+  return readslot(slot, data, &s);
+}
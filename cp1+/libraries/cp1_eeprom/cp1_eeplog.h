@@ -0,0 +1,93 @@
+/* ---------------------------------------------------------------------------
+                                cp1_eeplog.h
+
+     Ringspeicher fuer Datensaetze (z.B. Messwerte mit Zeitstempel) auf dem
+     externen EEProm des CP1+ Boards (Zugriff ueber eepr).
+
+     Datensaetze werden nur angehaengt, nie an fester Adresse ueberschrieben.
+     Ist der Bereich voll, werden die aeltesten Datensaetze ueberschrieben,
+     alle Pages werden so gleichmaessig abgenutzt.
+
+     Aufbau eines Datensatzes (reclen = datalen + 4 Bytes):
+
+         Sequenznummer (2 Bytes, 15 Bit) | Daten (datalen) | CRC16 (2 Bytes)
+
+     Geschrieben wird in Bloecken aus ganzen Pages: ein Block ist eine
+     Page, bei Datensaetzen laenger als eine Page so viele Pages, wie
+     fuer einen Datensatz noetig sind (z.B. eepr eep; mit 8 Byte Pages
+     und 6 Datenbytes: Block 16 Bytes). Ein Block enthaelt blocksize /
+     reclen Datensaetze, Datensaetze liegen nie auf einer Blockgrenze.
+     Angehaengte Datensaetze werden im RAM gesammelt und erst geschrieben,
+     wenn der Block voll ist (ein Schreibzyklus je Page) oder flush
+     aufgerufen wird.
+
+     Ein Block muss in den RAM-Puffer (elog_bufsize) und der Bereich muss
+     mindestens einen Block aufnehmen koennen, sonst liefert valid() 0 und
+     append / read sind ohne Wirkung.
+
+     begin sucht den zuletzt geschriebenen Datensatz per binaerer Suche
+     ueber die Sequenznummern (log2(Anzahl Datensaetze) Lesezugriffe).
+     Ein Datensatz mit CRC-Fehler (z.B. Stromausfall beim Schreiben)
+     beendet die Suche nicht: er gehoert zu derselben Folge wie der
+     naechste davor liegende gueltige Datensatz, dafuer wird rueckwaerts
+     gelesen. Ein beschaedigter letzter Datensatz wird so uebersprungen
+     statt ueberschrieben, read liefert fuer ihn 0.
+
+     Der Bereich (base, size) sollte auf einer Pagegrenze beginnen und vor
+     der ersten Benutzung mit clear geloescht werden.
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_eeplog
+#define in_cp1_eeplog
+
+#include "cp1_eeprom.h"
+
+  #ifndef elog_bufsize
+    #define elog_bufsize    64          // RAM-Puffer, max. Blockgroesse
+  #endif
+
+  #define  elog_seqmask    0x7fff       // Sequenznummer 15 Bit
+  #define  elog_empty      0xffff       // Sequenznummer eines leeren Datensatzes
+  #define  elog_bad        0x8000       // readslot: CRC-Fehler
+  #define  elog_overhead   4            // Sequenznummer + CRC
+
+class eeplog
+{
+  public:
+
+    eeplog(eepr *dev, uint16_t base, uint16_t size, uint8_t datalen);
+    uint8_t valid(void);
+    uint8_t begin(void);
+    void append(uint8_t *data);
+    void flush(void);
+    void clear(void);
+    uint16_t count(void);
+    uint16_t capacity(void);
+    uint8_t read(uint16_t idx, uint8_t *data);
+
+  protected:
+
+  private:
+
+    eepr     *eep;
+    uint16_t base;
+    uint16_t slots;                     // Anzahl Datensaetze im Bereich
+    uint16_t blocks;                    // Anzahl Bloecke im Bereich
+    uint16_t wr;                        // naechster zu schreibender Datensatz
+    uint16_t cnt;                       // Anzahl gueltiger Datensaetze
+    uint16_t seq;                       // naechste Sequenznummer
+    uint16_t bufslot;                   // erster Datensatz im Puffer
+    uint8_t  datalen, reclen;
+    uint8_t  blksize, rpb;              // Bytes und Datensaetze je Block
+    uint8_t  bufcnt;                    // Anzahl Datensaetze im Puffer
+    uint8_t  buf[elog_bufsize];
+
+    uint16_t slotadr(uint16_t slot);
+    uint16_t reccrc(uint8_t *rec);
+    uint8_t readslot(uint16_t slot, uint8_t *data, uint16_t *sq);
+    uint8_t inrun(uint16_t slot, uint16_t s0);
+};
+
+#endif
@@ -8,104 +8,36 @@
      PB6 und PB7 sind beim Betrieb eines ATmegas mit externem Quarz die 
      Quarzanschluesse.
      
-     Weil PB6 und PB7 innerhalb des Arduino Frameworks nicht deklariert sind
-     muss hier der Umweg ueber direkte Zuweisung an Register DDR, PIN und
-     PORT erfolgen.
+     Der Bus wird mit swi2c_fast betrieben, der Takt folgt i2c_freq aus
+     cp1_i2cbus.h (eep_bus, siehe cp1_eeprom.h).
      
      27.01.2021    R. Seelig                      
    --------------------------------------------------------------------------- */
    
 #include "cp1_eeprom.h"
 
-/* #################################################################
-     Funktionen fuer I2C - Bus (Softwareimplementierung)
-   ################################################################# */
-
 /* -------------------------------------------------------
                            eepr::eepr
 
-    setzt die Pins die fuer den I2C Bus verwendet werden
-    auf High
-   ------------------------------------------------------- */
-eepr::eepr(void)
-{
-  i2c_sda_hi();
-  i2c_scl_hi();
-}
-
-/* ---------------------------------------------------------
-                        eepr::i2c_delay
+    pgsize : Pagegroesse des EEProms (siehe Tabelle in
+             cp1_eeprom.h)
 
-       an die "Reaktionszeiten" des ATmega mit 8MHz ange-
-       passte Warteschleife
-   --------------------------------------------------------- */
-void eepr::i2c_delay(uint16_t anz)
-{
-  volatile uint16_t count;
-
-  for (count= 0; count< anz; count++)
-  {
-    _delay_us(1);
-  }
-}
-
-/* -------------------------------------------------------
-                    eepr::i2c_sendstart
-
-    erzeugt die Startbedingung auf dem I2C Bus
+    Die Buspins setzt der Konstruktor von eep_bus auf
+    High.
    ------------------------------------------------------- */
-void eepr::i2c_sendstart()
+eepr::eepr(uint8_t pgsize)
 {
-  i2c_scl_hi();
-  long_del();
-
-  i2c_sda_lo();
-  long_del();
-}
+  #if (eep_cachepages > 0)
+    uint8_t i;
 
-/* -------------------------------------------------------
-                     eepr::i2c_start
-
-    erzeugt die Startbedingung und sendet anschliessend
-    die Deviceadresse
-   ------------------------------------------------------- */
-uint8_t eepr::i2c_start(uint8_t addr)
-{
-  uint8_t ack;
-
-  i2c_sendstart();
-  ack= i2c_write(addr);
-  return ack;
-}
-
-/* -------------------------------------------------------
-                   eepr::i2c_startaddr
-
-   startet den I2C-Bus und sendet Bauteileadresse.
-   rwflag bestimmt, ob das Device beschrieben oder
-   gelesen werden soll
-  -------------------------------------------------- */
-void eepr::i2c_startaddr(uint8_t addr, uint8_t rwflag)
-{
-  addr = (addr << 1) | rwflag;
-
-  i2c_sendstart();
-  i2c_write(addr);
-}
-
-/* -------------------------------------------------------
-                    eepr:i2c_stop
-
-    erzeugt die Stopbedingung auf dem I2C Bus
-   ------------------------------------------------------- */
-void eepr::i2c_stop(void)
-{
-   i2c_sda_lo();
-   long_del();
-   i2c_scl_hi();
-   short_del();
-   i2c_sda_hi();
-   long_del();
+    for (i= 0; i< eep_cachepages; i++)
+    {
+      cache[i].flags= 0;
+      cache[i].age= i;
+    }
+  #endif
+  pagesize= pgsize;
+  clear_stats();
 }
 
 /* -------------------------------------------------------
@@ -126,198 +58,287 @@ uint8_t eepr::check_eeprom(void)
   return ack;
 }
 
-/* -------------------------------------------------------
-                  eepr::i2c_write_nack
+/* #################################################################
+     Funktionen 24LCxx EEProm
+   ################################################################# */
 
-   schreibt einen Wert auf dem I2C Bus OHNE ein Ack-
-   nowledge einzulesen
-  ------------------------------------------------------- */
-void eepr::i2c_write_nack(uint8_t data)
-{
-  uint8_t i;
+/* --------------------------------------------------
+                   eepr::ack_poll
 
-  for(i=0;i<8;i++)
-  {
-    i2c_scl_lo();
-    short_del();
+     wartet, bis das EEProm einen internen Schreib-
+     zyklus beendet hat. Waehrend des Schreibens
+     quittiert das EEProm seine Adresse nicht, die
+     Adresse wird deshalb so lange gesendet, bis ein
+     Acknowledge kommt.
 
-    if(data & 0x80) i2c_sda_hi();
-               else i2c_sda_lo();
+     Rueckgabe:
+         1 : EEProm bereit
+         0 : keine Antwort nach eep_polls Versuchen
+   -------------------------------------------------- */
+uint8_t eepr::ack_poll(void)
+{
+  uint16_t i;
 
-    short_del();
+  for (i= 0; i< eep_polls; i++)
+  {
+    if (i2c_start(eep_addr))
+    {
+      i2c_stop();
+      return 1;
+    }
+    i2c_stop();
+    _delay_us(eep_polldelay);
+  }
+  return 0;
+}
 
-    i2c_scl_hi();
-    short_del();
-    wait_del();
+/* --------------------------------------------------
+                   eepr::isblank
 
-    data= data<<1;
-  }
-  i2c_scl_lo();
-  short_del();
+     testet, ob len Bytes ab adr geloescht (0xff)
+     sind
+   -------------------------------------------------- */
+uint8_t eepr::isblank(uint16_t adr, uint8_t len)
+{
+  uint8_t blank;
 
+  blank= 1;
+  i2c_start(eep_addr);
+  i2c_write16(adr);
+  i2c_start(eep_addr+1);
+  while (--len)
+    if (i2c_read_ack() != 0xff) blank= 0;
+  if (i2c_read_nack() != 0xff) blank= 0;
+  i2c_stop();
+  return blank;
 }
 
+/* --------------------------------------------------
+                    eepr::erase
 
-/* -------------------------------------------------------
-                 eepr::i2c_write
-
-   schreibt einen Wert auf dem I2C Bus.
+     loescht den gesamten Inhalt des EEPROMS
+     (eep_size Bytes) pageweise
 
-   Rueckgabe:
-               > 0 wenn Slave ein Acknowledge gegeben hat
-               == 0 wenn kein Acknowledge vom Slave
-   ------------------------------------------------------- */
-uint8_t eepr::i2c_write(uint8_t data)
+     fast == 1 : Pages, die bereits vollstaendig
+                 geloescht sind, werden nicht
+                 geschrieben
+   -------------------------------------------------- */
+void eepr::erase(uint8_t fast)
 {
-   uint8_t ack;
-
-   i2c_write_nack(data);
+  uint16_t adr;
+  uint8_t  i;
 
-  //  9. Taktimpuls (Ack)
+  #if (eep_cachepages > 0)
+    for (i= 0; i< eep_cachepages; i++) cache[i].flags= 0;   // Inhalt wird ohnehin geloescht
+  #endif
 
-  i2c_sda_hi();
-  long_del();
+  adr= 0;
+  do
+  {
+    if (!fast || !isblank(adr, pagesize))
+    {
+      i2c_start(eep_addr);
+      i2c_write16(adr);
+      for (i= 0; i< pagesize; i++) i2c_write(0xff);
+      i2c_stop();
+      page_writes++;
+      ack_poll();                                  // warten bis Page geschrieben ist
+    }
+    adr += pagesize;
+  } while (adr < eep_size);
+}
 
-  i2c_scl_hi();
-  long_del();
+/* --------------------------------------------------
+                  eepr::rawwrite
 
-  i2c_sda_hi();
-  long_del();
+     schreibt mehrere Datenbytes ohne Beruecksich-
+     tigung des Caches in das EEProm. An jeder Page-
+     grenze wird die Page geschrieben und per
+     ack_poll auf das Ende des Schreibzyklus
+     gewartet.
+   -------------------------------------------------- */
+void eepr::rawwrite(uint16_t adr, uint8_t *buf, uint16_t len)
+{
+  uint16_t cnt;
 
-  if (i2c_is_sda()) ack= 0; else ack= 1;
+  if (!len) return;
+  i2c_start(eep_addr);
+  i2c_write16(adr);
 
-  i2c_scl_lo();
-  long_del();
+  cnt= 0;
+  do
+  {
+    i2c_write(*buf);
+    buf++;
+    cnt++;
+    adr++;
 
-  return ack;
+    if ((adr % pagesize == 0) && (cnt < len))      // Pagegrenze des EEProms
+    {
+      i2c_stop();
+      page_writes++;
+      ack_poll();                                  // warten bis Page geschrieben ist
+      i2c_start(eep_addr);                         // neue Page oeffnen
+      i2c_write16(adr);
+    }
+  } while (cnt< len);
+  i2c_stop();
+  page_writes++;
+  ack_poll();
 }
 
-/* -------------------------------------------------------
-                  eepr::i2c_write16
-
-   schreibt einen 16-Bit Wert auf dem I2C Bus.
+/* --------------------------------------------------
+                  eepr::rawread
 
-   Rueckgabe:
-               > 0 wenn Slave ein Acknowledge gegeben hat
-               == 0 wenn kein Acknowledge vom Slave
-   ------------------------------------------------------- */
-uint8_t eepr::i2c_write16(uint16_t data)
+     liest mehrere Bytes ohne Beruecksichtigung des
+     Caches aus dem EEProm
+   -------------------------------------------------- */
+void eepr::rawread(uint16_t adr, uint8_t *buf, uint16_t len)
 {
-  uint8_t ack;
-  ack= i2c_write(data >> 8);
-  if (!(ack)) return 0;
-  ack= i2c_write(data & 0xff);
+  if (!len) return;
+  ack_poll();                                      // I2C Bus und EEProm garantiert frei
 
-  return ack;
-}
+  i2c_start(eep_addr);
+  i2c_write16(adr);
+  i2c_start(eep_addr+1);
 
-/* -------------------------------------------------------
-                 eepr::i2c_read
+  while (--len)
+  {
+    *buf= i2c_read_ack();
+    buf++;
+  }
+  *buf= i2c_read_nack();                           // letztes Byte ohne ack lesen
+  i2c_stop();                                      // und somit Adresszaehler EEPROM freigeben
+}
 
-   liest ein Byte vom I2c Bus.
+#if (eep_cachepages > 0)
 
-   Uebergabe:
-               1 : nach dem Lesen wird dem Slave ein
-                   Acknowledge gesendet
-               0 : es wird kein Acknowledge gesendet
+/* --------------------------------------------------
+                  eepr::cache_get
 
-   Rueckgabe:
-               gelesenes Byte
-   ------------------------------------------------------- */
-uint8_t eepr::i2c_read(uint8_t ack)
+     liefert die Cachezeile, die adr enthaelt. Ist
+     sie nicht im Cache, wird die am laengsten nicht
+     benutzte Zeile (ggf. nach dem Zurueckschreiben)
+     ersetzt.
+   -------------------------------------------------- */
+eep_line *eepr::cache_get(uint16_t adr)
 {
-  uint8_t data= 0x00;
-  uint8_t i;
+  eep_line *l;
+  uint8_t  i, n;
 
-  i2c_sda_hi();
-
-  for(i=0;i<8;i++)
+  adr &= ~(uint16_t)(eep_cachelen-1);
+  n= 0xff;
+  for (i= 0; i< eep_cachepages; i++)
   {
-    i2c_scl_lo();
-    short_del();
-    i2c_scl_hi();
-
-    short_del();
-    wait_del();
+    if ((cache[i].flags & eep_cvalid) && (cache[i].adr== adr)) { n= i; break; }
+  }
 
-    if(i2c_is_sda()) data|= (0x80>>i);
+  if (n== 0xff)
+  {
+    cache_misses++;
+    for (i= 0; i< eep_cachepages; i++)             // aelteste Zeile ersetzen
+      if (cache[i].age== eep_cachepages-1) n= i;
+    l= &cache[n];
+    if (l->flags & eep_cdirty) rawwrite(l->adr, l->data, eep_cachelen);
+    rawread(adr, l->data, eep_cachelen);
+    l->adr= adr;
+    l->flags= eep_cvalid;
+  }
+  else
+  {
+    cache_hits++;
   }
 
-  i2c_scl_lo();
+  for (i= 0; i< eep_cachepages; i++)               // LRU: n wird juengste Zeile
+    if (cache[i].age < cache[n].age) cache[i].age++;
+  cache[n].age= 0;
+  return &cache[n];
+}
 
-  i2c_sda_hi();
+/* --------------------------------------------------
+                  eepr::cache_sync
 
-  long_del();
+     schreibt geaenderte Cachezeilen, die sich mit
+     adr .. adr+len-1 ueberschneiden, in das EEProm.
+     drop == 1 verwirft diese Zeilen anschliessend.
+   -------------------------------------------------- */
+void eepr::cache_sync(uint16_t adr, uint16_t len, uint8_t drop)
+{
+  eep_line *l;
+  uint8_t  i;
 
-  if (ack)
+  for (i= 0; i< eep_cachepages; i++)
   {
-    i2c_sda_lo();
-    long_del();
+    l= &cache[i];
+    if (!(l->flags & eep_cvalid)) continue;
+    if ((uint32_t)l->adr + eep_cachelen <= adr) continue;
+    if ((uint32_t)adr + len <= l->adr) continue;
+
+    if (l->flags & eep_cdirty) rawwrite(l->adr, l->data, eep_cachelen);
+    l->flags &= ~eep_cdirty;
+    if (drop) l->flags= 0;
   }
+}
 
-  i2c_scl_hi();
-  long_del();
-
-  i2c_scl_lo();
-  long_del();
+#endif
 
-  i2c_sda_hi();
+/* --------------------------------------------------
+                     eepr::flush
 
-  return data;
+     schreibt alle geaenderten Cachezeilen in das
+     EEProm
+   -------------------------------------------------- */
+void eepr::flush(void)
+{
+  #if (eep_cachepages > 0)
+    cache_sync(0, 0xffff, 0);
+  #endif
 }
 
-
-/* #################################################################
-     Funktionen 24LCxx EEProm
-   ################################################################# */
-
 /* --------------------------------------------------
-                   eepr::write
+                   eepr::clear_stats
 
-     schreibt einen 8-Bit Wert value an die
-     Adresse adr
+     setzt die Zaehler cache_hits, cache_misses und
+     page_writes auf 0
    -------------------------------------------------- */
-void eepr::write(uint16_t adr, uint8_t value)
+void eepr::clear_stats(void)
 {
-  i2c_start(eep_addr);
-  i2c_write16(adr);
-  i2c_write(value);
-  i2c_stop();
-  delay(4);
+  cache_hits= 0;
+  cache_misses= 0;
+  page_writes= 0;
 }
 
 /* --------------------------------------------------
-                    eepr::erase
+                  eepr::get_pagesize
 
-     loescht den gesamten Inhalt des EEPROMS
+     Rueckgabe: Pagegroesse, mit der geschrieben wird
    -------------------------------------------------- */
-void eepr::erase(void)
+uint8_t eepr::get_pagesize(void)
 {
-  uint16_t cnt;
-  uint16_t adr, len;
-
-  adr= 0; len= 0x7fff;
+  return pagesize;
+}
 
-  i2c_start(eep_addr);
-  i2c_write16(adr);
+/* --------------------------------------------------
+                   eepr::write
 
-  cnt= 0;
-  do
-  {
-    i2c_write(0xff);
-    cnt++;
-    adr++;
+     schreibt einen 8-Bit Wert value an die
+     Adresse adr (in den Cache, siehe flush)
+   -------------------------------------------------- */
+void eepr::write(uint16_t adr, uint8_t value)
+{
+  #if (eep_cachepages > 0)
+    eep_line *l;
 
-    if ((adr % eep_pagesize == 0))                 // Pagegrenze des EEProms
+    l= cache_get(adr);
+    adr &= (eep_cachelen-1);
+    if (l->data[adr] != value)
     {
-      i2c_stop();
-      delay(4);                                    // Wartezeit bis Page geschrieben ist
-      i2c_start(eep_addr);                         // neue Page oeffnen
-      i2c_write16(adr);
+      l->data[adr]= value;
+      l->flags |= eep_cdirty;
     }
-  } while (cnt< len);
-  i2c_stop();
-  delay(4);
+  #else
+    rawwrite(adr, &value, 1);
+  #endif
 }
 
 /* --------------------------------------------------
@@ -334,29 +355,10 @@ void eepr::erase(void)
    -------------------------------------------------- */
 void eepr::writebuf(uint16_t adr, uint8_t *buf, uint16_t len)
 {
-  uint16_t cnt;
-
-  i2c_start(eep_addr);
-  i2c_write16(adr);
-
-  cnt= 0;
-  do
-  {
-    i2c_write(*buf);
-    buf++;
-    cnt++;
-    adr++;
-
-    if ((adr % eep_pagesize == 0))                 // Pagegrenze des EEProms
-    {
-      i2c_stop();
-      delay(4);                                    // Wartezeit bis Page geschrieben ist
-      i2c_start(eep_addr);                         // neue Page oeffnen
-      i2c_write16(adr);
-    }
-  } while (cnt< len);
-  i2c_stop();
-  delay(4);
+  #if (eep_cachepages > 0)
+    cache_sync(adr, len, 1);
+  #endif
+  rawwrite(adr, buf, len);
 }
 
 /* --------------------------------------------------
@@ -367,21 +369,14 @@ void eepr::writebuf(uint16_t adr, uint8_t *buf, uint16_t len)
    -------------------------------------------------- */
 uint8_t eepr::read(uint16_t adr)
 {
-  uint8_t value;
-
-  delay(1);
-  i2c_start(eep_addr);                             // sicherheitshalber
-  i2c_stop();                                      // I2C Bus garantiert frei
-
-  i2c_start(eep_addr);
-  i2c_write16(adr);
-  delay(5);
-
-  i2c_start(eep_addr+1);
-
-  value= i2c_read_nack();
-  i2c_stop();
-  return value;
+  #if (eep_cachepages > 0)
+    return cache_get(adr)->data[adr & (eep_cachelen-1)];
+  #else
+    uint8_t value;
+
+    rawread(adr, &value, 1);
+    return value;
+  #endif
 }
 
 /* --------------------------------------------------
@@ -400,30 +395,8 @@ uint8_t eepr::read(uint16_t adr)
    -------------------------------------------------- */
 void eepr::readbuf(uint16_t adr, uint8_t *buf, uint16_t len)
 {
-  uint16_t cnt;
-
-  i2c_start(eep_addr);                             // sicherheitshalber
-  i2c_stop();                                      // I2C Bus garantiert frei
-
-  i2c_start(eep_addr);
-  i2c_write16(adr);
-  i2c_start(eep_addr+1);
-
-  cnt= 0;
-  do
-  {
-    if (len== 1)
-    {
-      *buf= i2c_read_nack();
-      i2c_stop();
-      return;
-    }
-    *buf= i2c_read_ack();
-    buf++;
-    cnt++;
-    adr++;
-  } while (cnt < len-1);
-  i2c_read_nack();                                  // noch einmal lesen um kein ack zu schicken
-  i2c_stop();                                       // und somit Adresszaehler EEPROM freigeben
-  _delay_ms(1);
+  #if (eep_cachepages > 0)
+    cache_sync(adr, len, 0);
+  #endif
+  rawread(adr, buf, len);
 }
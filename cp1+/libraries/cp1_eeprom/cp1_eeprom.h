@@ -8,9 +8,8 @@
      PB6 und PB7 sind beim Betrieb eines ATmegas mit externem Quarz die 
      Quarzanschluesse.
      
-     Weil PB6 und PB7 innerhalb des Arduino Frameworks nicht deklariert sind
-     muss hier der Umweg ueber direkte Zuweisung an Register DDR, PIN und
-     PORT erfolgen.
+     Der Bus wird mit swi2c_fast betrieben, der Takt folgt i2c_freq aus
+     cp1_i2cbus.h (eep_bus, siehe unten).
      
      27.01.2021    R. Seelig                      
    --------------------------------------------------------------------------- */
@@ -21,18 +20,30 @@
 #include "Arduino.h"
 #include <avr/io.h>
 #include <util/delay.h>
+#include "cp1_i2cbus.h"
 
-// I2C:   SCL = PB6, SDA = PB7
+/*
+  I2C:   SCL = PB6, SDA = PB7
 
-#define mask6          ( 1 << 6 )
-#define mask7          ( 1 << 7 )
+  Der Bus wird mit swi2c_fast betrieben (PB6 / PB7 haben keine
+  Arduino Pinnummer, swi2c scheidet damit aus, das Hardware-TWI liegt
+  an anderen Pins). Der Takt folgt i2c_freq aus cp1_i2cbus.h, bei
+  i2c_backend == i2c_bk_soft gilt eep_softfreq (entspricht dem
+  frueheren eigenen Bustreiber von eepr).
+*/
 
-#define i2c_scl_hi()   ( DDRB &= ~mask6 )
-#define i2c_scl_lo()   { DDRB |= mask6; PORTB &= ~mask6; }
+#define eep_sda          fi2c_pb(7)
+#define eep_scl          fi2c_pb(6)
 
-#define i2c_sda_hi()   ( DDRB &= ~mask7 )
-#define i2c_sda_lo()   { DDRB |= mask7; PORTB &= ~mask7; }
-#define i2c_is_sda()   ( PINB & mask7 )
+#ifndef eep_softfreq
+  #define eep_softfreq   200000
+#endif
+
+#if (i2c_backend == i2c_bk_soft)
+  typedef swi2c_fast<eep_sda, eep_scl, eep_softfreq, i2ctr_eepr> eep_bus;
+#else
+  typedef swi2c_fast<eep_sda, eep_scl, i2c_freq, i2ctr_eepr> eep_bus;
+#endif
 
   /*
     Pagesizes EEPROM
@@ -49,19 +60,55 @@
     24LC1025 |    128
 
 
+    Die Pagegroesse wird dem Konstruktor uebergeben, z.B.
+    eepr eep(64) fuer ein 24LC256. Ohne Angabe wird mit
+    eep_pagesize (passt fuer alle 24LCxx) geschrieben.
   */
 
   #define  eep_pagesize    8
   #define  eep_addr        0xa0
+  #define  eep_size        0x8000       // Groesse fuer erase (24LC256)
+  #define  eep_polls       250          // max. Anzahl Adressierungen in ack_poll (> 10 ms)
+  #define  eep_polldelay   40           // us Pause nach jeder erfolglosen Adressierung, damit
+                                        // eep_polls auch bei schnellem Bus fuer tWR reicht
+
+  /*
+    Cache fuer read / write
+
+    Ohne Cache (eep_cachepages 0, Voreinstellung) schreibt
+    write jedes Byte sofort (ein Schreibzyklus je Byte), read
+    liest jedes Byte vom EEProm.
+
+    Mit eep_cachepages > 0 arbeiten read und write auf einem
+    kleinen Cache im RAM (eep_cachepages Zeilen zu eep_cachelen
+    Bytes, LRU). Eine geaenderte Zeile wird erst geschrieben,
+    wenn sie verdraengt wird oder flush aufgerufen wird: ohne
+    flush vor dem Abschalten bzw. Reset gehen Daten verloren !
+    Die Bibliothek wird getrennt vom Sketch uebersetzt, der
+    Cache wird deshalb hier eingeschaltet.
+
+    readbuf / writebuf / erase arbeiten direkt mit dem EEProm
+    und gleichen den Cache vorher ab.
+  */
+
+  #ifndef eep_cachepages
+    #define eep_cachepages  0           // Anzahl Cachezeilen, 0..4
+  #endif
+  #ifndef eep_cachelen
+    #define eep_cachelen    16          // Bytes je Cachezeile (2er Potenz, max. 128)
+  #endif
 
+  #define  eep_cvalid      0x01         // Flags einer Cachezeile
+  #define  eep_cdirty      0x02
 
-  #define short_puls     1            // Einheiten fuer einen langen Taktimpuls
-  #define long_puls      1            // Einheiten fuer einen kurzen Taktimpuls
-  #define del_wait       1            // Wartezeit fuer garantierten 0 Pegel SCL-Leitung
+  typedef struct
+  {
+    uint16_t adr;                       // Anfangsadresse der Zeile im EEProm
+    uint8_t  flags;
+    uint8_t  age;                       // 0 = zuletzt benutzt
+    uint8_t  data[eep_cachelen];
+  } eep_line;
 
-  #define short_del()     i2c_delay(short_puls)
-  #define long_del()      i2c_delay(long_puls)
-  #define wait_del()      i2c_delay(del_wait)
 
 class eepr
 {
@@ -70,28 +117,50 @@ class eepr
     #define i2c_read_ack()    i2c_read(1)
     #define i2c_read_nack()   i2c_read(0)
       
-    eepr(void);
-    void i2c_delay(uint16_t anz);
-    void i2c_sendstart(void);
-    uint8_t i2c_start(uint8_t addr);
-    void i2c_stop();
-    void i2c_startaddr(uint8_t addr, uint8_t rwflag);
+    eepr(uint8_t pgsize = eep_pagesize);
+
+    // Buszugriffe (eep_bus)
+    void i2c_sendstart(void)                         { bus.sendstart(); }
+    uint8_t i2c_start(uint8_t addr)                  { return bus.start(addr); }
+    void i2c_stop()                                  { bus.stop(); }
+    void i2c_startaddr(uint8_t addr, uint8_t rwflag) { bus.startaddr(addr, rwflag); }
+    void i2c_write_nack(uint8_t data)                { bus.write_nack(data); }
+    uint8_t i2c_write(uint8_t data)                  { return bus.write(data); }
+    uint8_t i2c_write16(uint16_t data)               { return bus.write16(data); }
+    uint8_t i2c_read(uint8_t ack)                    { return bus.read(ack); }
+
     uint8_t check_eeprom(void);
-    void i2c_write_nack(uint8_t data);
-    uint8_t i2c_write(uint8_t data);
-    uint8_t i2c_write16(uint16_t data);
-    uint8_t i2c_read(uint8_t ack);
     
+    uint8_t ack_poll(void);
     void write(uint16_t adr, uint8_t value);
-    void erase(void);
+    void erase(uint8_t fast = 0);
     void writebuf(uint16_t adr, uint8_t *buf, uint16_t len);
     uint8_t read(uint16_t adr);
     void readbuf(uint16_t adr, uint8_t *buf, uint16_t len);    
+    void flush(void);
+    void clear_stats(void);
+    uint8_t get_pagesize(void);
+
+    uint32_t cache_hits;                // read / write aus dem Cache bedient
+    uint32_t cache_misses;              // Zeile musste gelesen werden
+    uint32_t page_writes;               // Schreibzyklen des EEProms
 
   protected:
 
   private:
 
+    eep_bus bus;
+    uint8_t pagesize;
+    uint8_t isblank(uint16_t adr, uint8_t len);
+    void rawwrite(uint16_t adr, uint8_t *buf, uint16_t len);
+    void rawread(uint16_t adr, uint8_t *buf, uint16_t len);
+
+    #if (eep_cachepages > 0)
+      eep_line cache[eep_cachepages];
+      eep_line *cache_get(uint16_t adr);
+      void cache_sync(uint16_t adr, uint16_t len, uint8_t drop);
+    #endif
+
 };
 
 
@@ -55,6 +55,7 @@ void loop()
     {
       data= tm16.input(0x5e, &key);     // zu schreibendes Datum einlesen,    0x5e = d
       eep.write(addr, data);
+      eep.flush();                      // Cache sofort zurueckschreiben
     }  
     addr= tm16.input(0x50, &key);     // zu schreibendes Datum einlesen,    0x50 = r    
     data= eep.read(addr);
@@ -0,0 +1,92 @@
+/* ---------------------------------------------------------------------------
+                                cp1_eeplog_demo.ino
+
+     Ringspeicher fuer Messwerte auf dem externen EEProm: alle 10 Sekunden
+     wird ein Datensatz (Zeit in Sekunden, Analogwert A0) angehaengt und die
+     Anzahl gespeicherter Datensaetze angezeigt. Ein Tastendruck zeigt die
+     Datensaetze vom aeltesten bis zum neuesten an.
+
+     Nach einem Reset wird der Ringspeicher mit begin wieder aufgenommen,
+     Datensaetze eines noch nicht vollen Blocks (seit dem letzten flush)
+     gehen dabei verloren.
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include "cp1_tm1637.h"
+#include "cp1_eeprom.h"
+#include "cp1_eeplog.h"
+
+
+// Belegung CP1+ Board :
+//    SCL = A5
+//    SDA = A4
+//    Shift-Taste = D5
+
+typedef struct
+{
+  uint32_t sek;
+  uint16_t value;
+} messung;
+
+tm1637  tm16(A5, A4, 5);
+eepr    eep(64);                                  // 24LC256
+eeplog  mlog(&eep, 0x4000, 0x4000, sizeof(messung));   // obere 16 kByte
+
+uint32_t lastlog;
+
+/*  ---------------------------------------------------------
+                             setup
+    --------------------------------------------------------- */
+void setup()
+{
+  tm16.clear();
+  tm16.setbright(2);
+
+  if (!eep.check_eeprom())
+  {
+    tm16.puts(0,"no I2C");
+    while(1);
+  }
+  if (!mlog.valid())                              // Datensatz / Bereich passt nicht
+  {
+    tm16.puts(0,"no LOG");
+    while(1);
+  }
+  mlog.begin();
+  lastlog= 0;
+}
+
+/*  ---------------------------------------------------------
+                             loop
+    --------------------------------------------------------- */
+void loop()
+{
+  messung  m;
+  uint16_t i;
+
+  if ((millis() - lastlog) >= 10000)
+  {
+    lastlog= millis();
+    m.sek= lastlog / 1000;
+    m.value= analogRead(A0);
+    mlog.append((uint8_t *)&m);                   // geschrieben wird, wenn ein Block voll ist
+    tm16.clear();
+    tm16.setdez(mlog.count(), 0, 0);
+  }
+
+  if (tm16.readkey() != 0xff)
+  {
+    mlog.flush();                                 // Datensaetze des angefangenen Blocks sichern
+    for (i= 0; i< mlog.count(); i++)
+    {
+      tm16.clear();
+      if (mlog.read(i, (uint8_t *)&m)) tm16.setdez(m.value, 0, 0);
+                                  else tm16.puts(0, "Err");
+      delay(500);
+    }
+    tm16.clear();
+    tm16.setdez(mlog.count(), 0, 0);
+  }
+}
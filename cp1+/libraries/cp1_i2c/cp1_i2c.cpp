@@ -62,6 +62,7 @@ void swi2c::sendstart()
 
   i2c_sda_lo();
   long_del();
+  i2ctr_start(i2ctr_swi2c);
 }
 
 /* -------------------------------------------------------
@@ -107,6 +108,7 @@ void swi2c::stop(void)
    short_del();
    i2c_sda_hi();
    long_del();
+   i2ctr_stop(i2ctr_swi2c);
 }
 
 /* -------------------------------------------------------
@@ -178,6 +180,7 @@ uint8_t swi2c::write(uint8_t data)
   i2c_scl_lo();
   long_del();
 
+  i2ctr_write(i2ctr_swi2c, data, ack);
   return ack;
 }
 
@@ -252,6 +255,7 @@ uint8_t swi2c::read(uint8_t ack)
 
   i2c_sda_hi();
 
+  i2ctr_read(i2ctr_swi2c);
   return data;
 }
 
@@ -3,6 +3,14 @@
 
      Rudimentaere I2C Funktionen mittels Bitbanging (Software) realisiert
 
+     Schnellere Variante mit zur Compilezeit festgelegten Pins und
+     einstellbarer Taktfrequenz: swi2c_fast in cp1_i2c_fast.h
+
+     Hardware-TWI mit denselben Memberfunktionen: hwi2c in cp1_i2c_twi.h,
+     Auswahl des Treibers fuer den gemeinsamen Bus: cp1_i2cbus.h
+
+     Mitschnitt der Transaktionen (i2c_trace): siehe cp1_i2ctr.h
+
      01.03.2021    R. Seelig
    --------------------------------------------------------------------------- */
    
@@ -14,6 +22,15 @@
   #include "Arduino.h"
   #include <avr/io.h>
   #include <util/delay.h>
+  #include "cp1_i2ctr.h"
+
+  // Pins des gemeinsamen Busses (cp1_i2cbus.h)
+  #ifndef i2c_sda
+    #define i2c_sda        P2_0
+  #endif
+  #ifndef i2c_scl
+    #define i2c_scl        P2_1
+  #endif
   
   class swi2c
   {
@@ -36,7 +53,7 @@
   
       uint8_t sda, scl;
   
-      swi2c(uint8_t da, uint8_t cl);
+      swi2c(uint8_t da = i2c_sda, uint8_t cl = i2c_scl);
       void setpins(uint8_t da, uint8_t cl);
       void delay(uint16_t anz);
       void sendstart(void);
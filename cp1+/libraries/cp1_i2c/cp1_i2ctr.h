@@ -0,0 +1,51 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2ctr.h
+
+     Schalter und Aufrufe fuer den Mitschnitt der I2C Transaktionen
+
+     swi2c, swi2c_fast, hwi2c und der TWI-Treiber (Wire, twi_queue)
+     binden nur diese Datei ein. Bei i2c_trace 0 (Voreinstellung) sind
+     alle i2ctr_xxx Makros leer, die Library cp1_i2ctrace wird dann
+     nicht benoetigt.
+
+     Eingeschaltet wird der Mitschnitt mit
+
+         #define i2c_trace   1
+
+     hier in der Datei (die Bibliotheken werden getrennt vom Sketch
+     uebersetzt, ein #define im Sketch erreicht sie nicht). Dann muss
+     die Library cp1_i2ctrace installiert sein (Ringpuffer, Zeitbasis,
+     Ausgabe, siehe cp1_i2ctrace.h).
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2ctr
+  #define in_cp1_i2ctr
+
+  #ifndef i2c_trace
+    #define i2c_trace       0           // 1 = Mitschnitt einschalten
+  #endif
+
+  // Busnummern
+  #define i2ctr_swi2c       0
+  #define i2ctr_fast        1
+  #define i2ctr_eepr        2
+  #define i2ctr_twi         3
+  #define i2ctr_busanz      4
+
+  #if (i2c_trace == 1)
+    #include "cp1_i2ctrace.h"
+
+    #define i2ctr_start(bus)             i2ctrace_start(bus)
+    #define i2ctr_write(bus, data, ack)  i2ctrace_write(bus, data, ack)
+    #define i2ctr_read(bus)              i2ctrace_read(bus)
+    #define i2ctr_stop(bus)              i2ctrace_stop(bus)
+  #else
+    #define i2ctr_start(bus)
+    #define i2ctr_write(bus, data, ack)
+    #define i2ctr_read(bus)
+    #define i2ctr_stop(bus)
+  #endif
+
+#endif
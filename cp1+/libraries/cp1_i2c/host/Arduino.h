@@ -0,0 +1,64 @@
+/* ---------------------------------------------------------------------------
+                                Arduino.h
+
+     Ersatz fuer Arduino.h beim Build auf einem Linux-Host: Pins und
+     Zeitfunktionen arbeiten auf dem Bussimulator (cp1_i2csim.h),
+     Implementierung in cp1_arduino_host.cpp
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_arduino_host
+  #define in_arduino_host
+
+  #include <stdint.h>
+  #include <stdlib.h>
+  #include <string.h>
+
+  #include <avr/io.h>
+  #include <avr/interrupt.h>
+  #include <util/delay.h>
+
+  #define INPUT           0
+  #define OUTPUT          1
+  #define INPUT_PULLUP    2
+  #define LOW             0
+  #define HIGH            1
+
+  // Pinbelegung wie variants/.../pins_arduino.h
+  #define A0              (14)
+  #define A1              (15)
+  #define A2              (16)
+  #define A3              (17)
+  #define A4              (18)
+  #define A5              (19)
+
+  #define P1_0            (6)
+  #define P1_1            (7)
+  #define P1_2            (8)
+  #define P1_3            (9)
+  #define P1_4            (10)
+  #define P1_5            (11)
+  #define P1_6            (12)
+  #define P1_7            (13)
+
+  #define P2_0            (A0)
+  #define P2_1            (A1)
+  #define P2_2            (A2)
+  #define P2_3            (A3)
+  #define P2_4            (4)
+  #define P2_5            (3)
+  #define P2_6            (2)
+  #define P2_7            (0)
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  int  digitalRead(uint8_t pin);
+  void delay(unsigned long ms);
+  void delayMicroseconds(unsigned int us);
+  unsigned long millis(void);
+  unsigned long micros(void);
+
+#endif
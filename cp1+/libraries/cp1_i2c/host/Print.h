@@ -0,0 +1,42 @@
+/* ---------------------------------------------------------------------------
+                                Print.h
+
+     Ersatz fuer die Arduino Klasse Print beim Build auf einem Linux-
+     Host, Ausgabe auf stdout
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_print_host
+  #define in_print_host
+
+  #include <stdio.h>
+
+  #define DEC             10
+  #define HEX             16
+
+  class __FlashStringHelper;
+  #define F(s)            ((const __FlashStringHelper *)(s))
+
+  class Print
+  {
+    public:
+      void print(const __FlashStringHelper *s)     { fputs((const char *)s, stdout); }
+      void print(const char *s)                    { fputs(s, stdout); }
+      void print(char c)                           { putchar(c); }
+      void print(unsigned long v, int base = DEC)  { printf((base == HEX) ? "%lX" : "%lu", v); }
+      void print(long v, int base = DEC)           { printf((base == HEX) ? "%lX" : "%ld", v); }
+      void print(unsigned int v, int base = DEC)   { print((unsigned long)v, base); }
+      void print(int v, int base = DEC)            { print((long)v, base); }
+      void print(unsigned char v, int base = DEC)  { print((unsigned long)v, base); }
+
+      template <typename T> void println(T v)      { print(v); putchar('\n'); }
+      template <typename T> void println(T v, int base) { print(v, base); putchar('\n'); }
+      void println(void)                           { putchar('\n'); }
+  };
+
+  extern Print Serial;
+
+#endif
@@ -0,0 +1,29 @@
+/* ---------------------------------------------------------------------------
+                                avr/interrupt.h
+
+     Ersatz fuer <avr/interrupt.h> beim Build auf einem Linux-Host:
+     ISR(v) wird zu einer normalen Funktion v(), die ein Test direkt
+     aufrufen kann
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_avr_interrupt_host
+  #define in_avr_interrupt_host
+
+  #define cli()
+  #define sei()
+
+  #define ISR(vect)       void vect(void)
+
+  #define PCINT0_vect     sim_pcint0_vect
+  #define PCINT1_vect     sim_pcint1_vect
+  #define PCINT2_vect     sim_pcint2_vect
+
+  void PCINT0_vect(void);
+  void PCINT1_vect(void);
+  void PCINT2_vect(void);
+
+#endif
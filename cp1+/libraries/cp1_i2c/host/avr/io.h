@@ -0,0 +1,61 @@
+/* ---------------------------------------------------------------------------
+                                avr/io.h
+
+     Ersatz fuer <avr/io.h> beim Build auf einem Linux-Host: die
+     Portregister B, C und D werden vom Bussimulator nachgebildet
+     (cp1_i2csim.h), alle anderen Register sind einfache Variable
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_avr_io_host
+  #define in_avr_io_host
+
+  #include <stdint.h>
+  #include "../cp1_i2csim.h"
+
+  #define PORTB           sim_portreg[sim_pb]
+  #define PORTC           sim_portreg[sim_pc]
+  #define PORTD           sim_portreg[sim_pd]
+  #define DDRB            sim_ddrreg[sim_pb]
+  #define DDRC            sim_ddrreg[sim_pc]
+  #define DDRD            sim_ddrreg[sim_pd]
+  #define PINB            sim_pinreg[sim_pb]
+  #define PINC            sim_pinreg[sim_pc]
+  #define PIND            sim_pinreg[sim_pd]
+
+  #define PB0 0
+  #define PB1 1
+  #define PB2 2
+  #define PB3 3
+  #define PB4 4
+  #define PB5 5
+  #define PB6 6
+  #define PB7 7
+  #define PC0 0
+  #define PC1 1
+  #define PC2 2
+  #define PC3 3
+  #define PC4 4
+  #define PC5 5
+  #define PD0 0
+  #define PD1 1
+  #define PD2 2
+  #define PD3 3
+  #define PD4 4
+  #define PD5 5
+  #define PD6 6
+  #define PD7 7
+
+  extern uint8_t SREG, PCICR, PCMSK0, PCMSK1, PCMSK2;
+
+  #define PCIE0           0
+  #define PCIE1           1
+  #define PCIE2           2
+  #define PCINT10         2
+
+  #define _BV(bit)        (1 << (bit))
+
+#endif
@@ -0,0 +1,78 @@
+/* ---------------------------------------------------------------------------
+                                cp1_arduino_host.cpp
+
+     Pin- und Zeitfunktionen von Arduino.h fuer den Build auf einem
+     Linux-Host. Die Pins wirken auf die Portregister des Bus-
+     simulators, jeder Aufruf kostet die im Kostenmodell angegebene
+     Anzahl Takte (cp1_i2csim.h)
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include "Arduino.h"
+#include "Print.h"
+
+uint8_t SREG, PCICR, PCMSK0, PCMSK1, PCMSK2;
+
+Print Serial;
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  uint8_t port, mask;
+
+  port= sim_pin2port(pin);
+  mask= sim_pin2mask(pin);
+  switch (mode)
+  {
+    case OUTPUT       : sim_ddrreg[port].val |= mask;
+                        break;
+    case INPUT_PULLUP : sim_ddrreg[port].val &= ~mask;
+                        sim_portreg[port].val |= mask;
+                        break;
+    default           : sim_ddrreg[port].val &= ~mask;
+                        sim_portreg[port].val &= ~mask;
+                        break;
+  }
+  sim_cycles(sim_cyc_pinmode);
+  sim_update();
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  uint8_t port, mask;
+
+  port= sim_pin2port(pin);
+  mask= sim_pin2mask(pin);
+  if (val) sim_portreg[port].val |= mask;
+      else sim_portreg[port].val &= ~mask;
+  sim_cycles(sim_cyc_dwrite);
+  sim_update();
+}
+
+int digitalRead(uint8_t pin)
+{
+  sim_cycles(sim_cyc_dread);
+  return (sim_pinread(sim_pin2port(pin)) & sim_pin2mask(pin)) ? HIGH : LOW;
+}
+
+void delay(unsigned long ms)
+{
+  sim_advance((uint64_t)ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  sim_advance((uint64_t)us * 1000ULL);
+}
+
+unsigned long millis(void)
+{
+  return sim_now_ns() / 1000000ULL;
+}
+
+unsigned long micros(void)
+{
+  return sim_now_ns() / 1000ULL;
+}
@@ -0,0 +1,406 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2cdev.cpp
+
+     Verhaltensmodelle der I2C Bausteine fuer den Bussimulator (siehe
+     cp1_i2cdev.h)
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <time.h>
+#include "cp1_i2cdev.h"
+
+static uint8_t bcd(int v)     { return ((v / 10) << 4) | (v % 10); }
+static int     dez(uint8_t v) { return (v >> 4) * 10 + (v & 0x0f); }
+
+/* #################################################################
+     24C256
+
+     Geschriebene Bytes landen im Pagepuffer (Adresse laeuft
+     innerhalb der Page um), mit dem Stop beginnt der Schreib-
+     zyklus. Bis zu dessen Ende wird die Adresse nicht quittiert.
+   ################################################################# */
+
+sim24c256::sim24c256(uint8_t a7)
+{
+  addr= a7;
+  memset(mem, 0xff, sizeof(mem));
+  adrcnt= 0; dirty= 0; ptr= 0;
+  busy_until= 0;
+  page_writes= 0; busy_polls= 0;
+}
+
+uint8_t sim24c256::match(uint8_t a7)
+{
+  return (a7 == addr);
+}
+
+uint8_t sim24c256::select(uint8_t, uint8_t)
+{
+  if (sim_now_ns() < busy_until)
+  {
+    busy_polls++;
+    return 0;
+  }
+  return 1;
+}
+
+void sim24c256::start(void)
+{
+  adrcnt= 0;
+  if (dirty)                            // Start ohne Stop verwirft den Pagepuffer
+  {
+    memset(pmask, 0, sizeof(pmask));
+    dirty= 0;
+  }
+}
+
+uint8_t sim24c256::write(uint8_t data)
+{
+  uint8_t ofs;
+
+  if (adrcnt < 2)
+  {
+    ptr= ((ptr << 8) | data) & (sim_eep_size - 1);
+    adrcnt++;
+    return 1;
+  }
+  ofs= ptr & (sim_eep_page - 1);
+  pbuf[ofs]= data;
+  pmask[ofs]= 1;
+  dirty= 1;
+  ptr= (ptr & ~(sim_eep_page - 1)) | ((ofs + 1) & (sim_eep_page - 1));
+  return 1;
+}
+
+uint8_t sim24c256::read(void)
+{
+  uint8_t b;
+
+  b= mem[ptr];
+  ptr= (ptr + 1) & (sim_eep_size - 1);
+  return b;
+}
+
+void sim24c256::stop(void)
+{
+  uint16_t page;
+  uint8_t  i;
+
+  if (!dirty) return;
+  page= ptr & ~(sim_eep_page - 1);
+  for (i= 0; i< sim_eep_page; i++)
+  {
+    if (pmask[i]) mem[page + i]= pbuf[i];
+  }
+  memset(pmask, 0, sizeof(pmask));
+  dirty= 0;
+  page_writes++;
+  busy_until= sim_now_ns() + sim_eep_twr_ns;
+}
+
+/* #################################################################
+     DS1307 / DS3231
+
+     Die Uhr zaehlt Sekunden ab 1.1.2000 mit der virtuellen Zeit.
+     Mit jedem Start werden die Zeitregister 0..6 aktualisiert
+     (wie der Pufferspeicher der Bausteine), nach einem Stop, dem
+     ein Schreiben der Zeitregister vorausging, wird die Uhr neu
+     gestellt.
+   ################################################################# */
+
+simrtc::simrtc(uint8_t typ)
+{
+  type= typ;
+  memset(regs, 0, sizeof(regs));
+  if (type == sim_ds3231)
+  {
+    regs[0x0e]= 0x1c;                   // INTCN, RS2, RS1
+    regs[0x11]= 25;                     // 25 Grad
+  }
+  ptr= 0; ptrset= 0; timeset= 0;
+  settime(0, 1, 1, 0, 0, 0);
+}
+
+/* -------------------------------------------------------
+                        simrtc::settime
+
+     stellt die Uhr (jahr 0..99 = 2000..2099)
+   ------------------------------------------------------- */
+void simrtc::settime(int jahr, int monat, int tag, int std, int min, int sek)
+{
+  struct tm t;
+
+  memset(&t, 0, sizeof(t));
+  t.tm_year= jahr + 100;
+  t.tm_mon= monat - 1;
+  t.tm_mday= tag;
+  t.tm_hour= std;
+  t.tm_min= min;
+  t.tm_sec= sek;
+  t0= (int64_t)timegm(&t) - 946684800LL;
+  ns0= sim_now_ns();
+  latch();
+}
+
+/* -------------------------------------------------------
+                        simrtc::latch
+
+     aktuelle Zeit in die Register 0..6 (BCD, 24h)
+   ------------------------------------------------------- */
+void simrtc::latch(void)
+{
+  struct tm t;
+  time_t    s;
+
+  s= (time_t)(t0 + (int64_t)((sim_now_ns() - ns0) / 1000000000ULL) + 946684800LL);
+  gmtime_r(&s, &t);
+  regs[0]= bcd(t.tm_sec) | (regs[0] & 0x80);
+  regs[1]= bcd(t.tm_min);
+  regs[2]= bcd(t.tm_hour);
+  regs[3]= t.tm_wday + 1;
+  regs[4]= bcd(t.tm_mday);
+  regs[5]= bcd(t.tm_mon + 1);
+  regs[6]= bcd(t.tm_year - 100);
+}
+
+uint8_t simrtc::match(uint8_t a7)
+{
+  return (a7 == 0x68);
+}
+
+void simrtc::start(void)
+{
+  if (!timeset) latch();
+  ptrset= 0;
+}
+
+uint8_t simrtc::write(uint8_t data)
+{
+  uint8_t last;
+
+  last= (type == sim_ds3231) ? 0x12 : 0x3f;
+  if (!ptrset)
+  {
+    ptr= (data > last) ? 0 : data;
+    ptrset= 1;
+    return 1;
+  }
+  if (ptr < 7) timeset= 1;
+  regs[ptr]= data;
+  ptr= (ptr >= last) ? 0 : ptr + 1;
+  return 1;
+}
+
+uint8_t simrtc::read(void)
+{
+  uint8_t b, last;
+
+  last= (type == sim_ds3231) ? 0x12 : 0x3f;
+  b= regs[ptr];
+  ptr= (ptr >= last) ? 0 : ptr + 1;
+  return b;
+}
+
+void simrtc::stop(void)
+{
+  if (!timeset) return;
+  timeset= 0;
+  settime(dez(regs[6]), dez(regs[5] & 0x1f), dez(regs[4] & 0x3f),
+          dez(regs[2] & 0x3f), dez(regs[1] & 0x7f), dez(regs[0] & 0x7f));
+}
+
+/* #################################################################
+     RDA5807
+
+     0x10 : sequentieller Zugriff, Schreiben beginnt bei Register
+            2, Lesen bei Register 0x0a
+     0x11 : wahlfreier Zugriff, das erste geschriebene Byte ist
+            die Registernummer
+
+     Ein Schreiben von Register 3 mit TUNE-Bit stellt die Frequenz
+     ein (Band 87..108 MHz, 100 kHz Raster), Register 0x0a / 0x0b
+     melden STC, Kanal und Empfangsstaerke.
+   ################################################################# */
+
+simrda5807::simrda5807()
+{
+  memset(regs, 0, sizeof(regs));
+  regs[0]= 0x5804;                      // Chip-ID
+  freq= 870;
+  stanz= 0;
+  random= 0; idx= 0; hibyte= 1; first= 0;
+}
+
+/* -------------------------------------------------------
+                       simrda5807::station
+
+     Sender auf Frequenz f (* 0.1 MHz) mit Empfangsstaerke
+     rssi (0..127)
+   ------------------------------------------------------- */
+void simrda5807::station(uint16_t f, uint8_t rssi)
+{
+  if (stanz >= sim_rda_stations) return;
+  stfreq[stanz]= f;
+  strssi[stanz]= rssi;
+  stanz++;
+}
+
+uint8_t simrda5807::match(uint8_t a7)
+{
+  return (a7 == 0x10) || (a7 == 0x11);
+}
+
+uint8_t simrda5807::select(uint8_t a7, uint8_t rw)
+{
+  hibyte= 1;
+  if (a7 == 0x10)
+  {
+    random= 0;
+    idx= rw ? 0x0a : 0x02;
+  }
+  else
+  {
+    random= 1;
+    first= !rw;                         // Registernummer folgt
+  }
+  return 1;
+}
+
+void simrda5807::start(void)
+{
+  hibyte= 1;
+}
+
+void simrda5807::regwrite(uint8_t r, uint16_t v)
+{
+  uint8_t  i, rssi;
+  uint16_t chan;
+
+  regs[r]= v;
+  if ((r == 2) && (v & 0x0002))         // Soft-Reset
+  {
+    memset(&regs[3], 0, sizeof(regs) - 3 * sizeof(regs[0]));
+  }
+  if ((r == 3) && (v & 0x0010))         // TUNE
+  {
+    chan= v >> 6;
+    freq= 870 + chan;
+    rssi= 20;
+    for (i= 0; i< stanz; i++)
+    {
+      if (stfreq[i] == freq) rssi= strssi[i];
+    }
+    regs[0x0a]= 0x4000 | (chan & 0x03ff);                         // STC + READCHAN
+    regs[0x0b]= ((uint16_t)(rssi & 0x7f) << 9) | ((rssi >= 72) ? 0x0100 : 0);  // RSSI, FM_TRUE
+  }
+}
+
+uint8_t simrda5807::write(uint8_t data)
+{
+  if (random && first)
+  {
+    idx= data & 0x0f;
+    first= 0;
+    return 1;
+  }
+  if (hibyte)
+  {
+    hival= data;
+    hibyte= 0;
+    return 1;
+  }
+  regwrite(idx, (hival << 8) | data);
+  idx= (idx + 1) & 0x0f;
+  hibyte= 1;
+  return 1;
+}
+
+uint8_t simrda5807::read(void)
+{
+  uint8_t b;
+
+  if (hibyte)
+  {
+    b= regs[idx] >> 8;
+    hibyte= 0;
+  }
+  else
+  {
+    b= regs[idx] & 0xff;
+    idx= (idx + 1) & 0x0f;
+    hibyte= 1;
+  }
+  return b;
+}
+
+/* #################################################################
+     LM75
+
+     Register 0 : Temperatur (16 Bit, 0.5 Grad in Bit 7), nur lesen
+              1 : Konfiguration (8 Bit)
+              2 : Thyst (16 Bit)
+              3 : Tos (16 Bit)
+   ################################################################# */
+
+simlm75::simlm75(uint8_t a7)
+{
+  addr= a7;
+  temp= 2 * 21;
+  ptr= 0; wcnt= 0; rcnt= 0;
+  config= 0;
+  thyst= 75 << 8;
+  tos= 80 << 8;
+}
+
+uint8_t simlm75::match(uint8_t a7)
+{
+  return (a7 == addr);
+}
+
+void simlm75::start(void)
+{
+  wcnt= 0;
+  rcnt= 0;
+}
+
+uint16_t simlm75::reg16(uint8_t r)
+{
+  switch (r)
+  {
+    case 0  : return (uint16_t)(temp << 7);
+    case 2  : return thyst;
+    case 3  : return tos;
+    default : return (config << 8) | config;
+  }
+}
+
+uint8_t simlm75::write(uint8_t data)
+{
+  if (!wcnt)
+  {
+    ptr= data & 0x03;
+    wcnt++;
+    return 1;
+  }
+  switch (ptr)
+  {
+    case 1 : config= data; break;
+    case 2 : if (wcnt == 1) thyst= (thyst & 0x00ff) | (data << 8); else thyst= (thyst & 0xff00) | data; break;
+    case 3 : if (wcnt == 1) tos= (tos & 0x00ff) | (data << 8); else tos= (tos & 0xff00) | data; break;
+    default : break;
+  }
+  wcnt++;
+  return 1;
+}
+
+uint8_t simlm75::read(void)
+{
+  uint16_t v;
+
+  v= reg16(ptr);
+  return (rcnt++ & 1) ? (v & 0xff) : (v >> 8);
+}
@@ -0,0 +1,155 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2cdev.h
+
+     Verhaltensmodelle der I2C Bausteine fuer den Bussimulator
+     (cp1_i2csim.h)
+
+       sim24c256   EEProm 32 kByte, Pagepuffer 64 Byte, Schreibzyklus
+                   tWR (waehrend dessen wird die Adresse nicht
+                   quittiert, ack polling)
+       simrtc      DS1307 (Register 0..7, RAM 8..0x3f) bzw. DS3231
+                   (Register 0..0x12), Uhr laeuft mit der virtuellen
+                   Zeit
+       simrda5807  UKW-Empfaenger, sequentieller (0x10) und wahlfreier
+                   (0x11) Zugriff, Empfangsstaerke aus einer Senderliste
+       simlm75     Temperatursensor, Register 0..3
+
+     Alle Adressen sind 7-Bit Adressen.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2cdev
+  #define in_cp1_i2cdev
+
+  #include <stdint.h>
+  #include "cp1_i2csim.h"
+
+  /* ------------------------------------------------------
+       Basisklasse
+
+       match  : 1 = Baustein hoert auf Adresse a7
+       select : Adresse wurde empfangen, 1 = Ack
+       start  : jede Start- / wiederholte Startbedingung
+       write  : Byte vom Master, 1 = Ack
+       read   : naechstes Byte an den Master
+       stop   : Stopbedingung
+     ------------------------------------------------------ */
+  class i2cdev
+  {
+    public:
+      virtual ~i2cdev() { }
+      virtual uint8_t match(uint8_t a7) = 0;
+      virtual uint8_t select(uint8_t, uint8_t)        { return 1; }
+      virtual void    start(void)                     { }
+      virtual uint8_t write(uint8_t data) = 0;
+      virtual uint8_t read(void) = 0;
+      virtual void    stop(void)                      { }
+  };
+
+  /* ------------------------------------------------------
+       24C256
+     ------------------------------------------------------ */
+  #define sim_eep_size      0x8000
+  #define sim_eep_page      64
+  #define sim_eep_twr_ns    5000000ULL  // Schreibzyklus 5 ms
+
+  class sim24c256 : public i2cdev
+  {
+    public:
+      uint8_t  mem[sim_eep_size];
+      uint32_t page_writes;             // Schreibzyklen
+      uint32_t busy_polls;              // Adressierungen waehrend tWR
+
+      sim24c256(uint8_t a7 = 0x50);
+      uint8_t match(uint8_t a7);
+      uint8_t select(uint8_t a7, uint8_t rw);
+      void    start(void);
+      uint8_t write(uint8_t data);
+      uint8_t read(void);
+      void    stop(void);
+
+    private:
+      uint8_t  addr, adrcnt, dirty;
+      uint16_t ptr;
+      uint8_t  pbuf[sim_eep_page];
+      uint8_t  pmask[sim_eep_page];
+      uint64_t busy_until;
+  };
+
+  /* ------------------------------------------------------
+       DS1307 / DS3231
+     ------------------------------------------------------ */
+  #define sim_ds1307        0
+  #define sim_ds3231        1
+
+  class simrtc : public i2cdev
+  {
+    public:
+      uint8_t regs[64];
+
+      simrtc(uint8_t type = sim_ds3231);
+      void    settime(int jahr, int monat, int tag, int std, int min, int sek);
+      uint8_t match(uint8_t a7);
+      void    start(void);
+      uint8_t write(uint8_t data);
+      uint8_t read(void);
+      void    stop(void);
+
+    private:
+      uint8_t  type, ptr, ptrset, timeset;
+      int64_t  t0;                      // Sekunden seit 1.1.2000 zur Zeit ns0
+      uint64_t ns0;
+      void     latch(void);
+  };
+
+  /* ------------------------------------------------------
+       RDA5807
+     ------------------------------------------------------ */
+  #define sim_rda_stations  8
+
+  class simrda5807 : public i2cdev
+  {
+    public:
+      uint16_t regs[16];
+      uint16_t freq;                    // eingestellte Frequenz * 0.1 MHz
+
+      simrda5807();
+      void    station(uint16_t f, uint8_t rssi);
+      uint8_t match(uint8_t a7);
+      uint8_t select(uint8_t a7, uint8_t rw);
+      void    start(void);
+      uint8_t write(uint8_t data);
+      uint8_t read(void);
+
+    private:
+      uint8_t  random, idx, hibyte, hival, first;
+      uint16_t stfreq[sim_rda_stations];
+      uint8_t  strssi[sim_rda_stations];
+      uint8_t  stanz;
+      void     regwrite(uint8_t r, uint16_t v);
+  };
+
+  /* ------------------------------------------------------
+       LM75
+     ------------------------------------------------------ */
+  class simlm75 : public i2cdev
+  {
+    public:
+      int16_t temp;                     // Temperatur * 2 (0.5 Grad Aufloesung)
+
+      simlm75(uint8_t a7 = 0x48);
+      uint8_t match(uint8_t a7);
+      void    start(void);
+      uint8_t write(uint8_t data);
+      uint8_t read(void);
+
+    private:
+      uint8_t  addr, ptr, wcnt, rcnt, config;
+      uint16_t thyst, tos;
+      uint16_t reg16(uint8_t r);
+  };
+
+#endif
@@ -0,0 +1,357 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2csim.cpp
+
+     I2C Bussimulator: virtuelle Zeit, Portregister und Slave-Automat
+     der Busse (siehe cp1_i2csim.h)
+
+     Zustaende des Slave-Automaten:
+
+       st_idle    : kein Transfer, wartet auf Start
+       st_rx      : Baustein empfaengt ein Byte (Adresse oder Daten)
+       st_ackout  : Baustein quittiert (9. Takt)
+       st_tx      : Baustein sendet ein Byte
+       st_mack    : Master quittiert (9. Takt)
+       st_ignore  : nicht adressiert bzw. Nack, wartet auf Start / Stop
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "cp1_i2csim.h"
+#include "cp1_i2cdev.h"
+
+#define st_idle         0
+#define st_rx           1
+#define st_ackout       2
+#define st_tx           3
+#define st_mack         4
+#define st_ignore       5
+
+uint64_t sim_ps = 0;
+
+simreg sim_portreg[3];
+simreg sim_ddrreg[3];
+simpin sim_pinreg[3] = { simpin(sim_pb), simpin(sim_pc), simpin(sim_pd) };
+
+static i2cbus  *buses[sim_maxbus];
+static uint8_t  busanz = 0;
+
+/* -------------------------------------------------------
+                        sim_advance
+
+     laesst die virtuelle Zeit um ns weiterlaufen
+   ------------------------------------------------------- */
+void sim_advance(uint64_t ns)
+{
+  sim_ps += ns * 1000;
+}
+
+/* -------------------------------------------------------
+                        sim_cycles
+
+     laesst die virtuelle Zeit um cyc Takte weiterlaufen
+   ------------------------------------------------------- */
+void sim_cycles(uint32_t cyc)
+{
+  sim_ps += (uint64_t)cyc * 1000000000000ULL / F_CPU;
+}
+
+/* -------------------------------------------------------
+                        sim_addbus
+
+     meldet einen Bus an, der bei jeder Aenderung der
+     Portregister ausgewertet wird
+   ------------------------------------------------------- */
+void sim_addbus(i2cbus *bus)
+{
+  if (busanz < sim_maxbus) buses[busanz++]= bus;
+  bus->update();
+}
+
+/* -------------------------------------------------------
+                        sim_update
+
+     wertet alle Busse nach einer Registeraenderung aus
+   ------------------------------------------------------- */
+void sim_update(void)
+{
+  uint8_t i;
+
+  for (i= 0; i< busanz; i++) buses[i]->update();
+}
+
+/* -------------------------------------------------------
+                        sim_pinread
+
+     Pegel der Pins eines Ports: Busleitungen liefern den
+     Pegel des Busses, Ausgaenge das PORT-Bit, offene
+     Eingaenge 1
+   ------------------------------------------------------- */
+uint8_t sim_pinread(uint8_t port)
+{
+  uint8_t v, i;
+
+  v= (sim_portreg[port].val & sim_ddrreg[port].val) | ~sim_ddrreg[port].val;
+  for (i= 0; i< busanz; i++) v &= buses[i]->pinmask(port);
+  return v;
+}
+
+/* -------------------------------------------------------
+                     sim_pin2port / sim_pin2mask
+
+     Arduino Pinnummer (ATmega328p) => Port / Bitmaske
+   ------------------------------------------------------- */
+uint8_t sim_pin2port(uint8_t pin)
+{
+  if (pin < 8) return sim_pd;
+  if (pin < 14) return sim_pb;
+  return sim_pc;
+}
+
+uint8_t sim_pin2mask(uint8_t pin)
+{
+  if (pin < 8) return 1 << pin;
+  if (pin < 14) return 1 << (pin - 8);
+  return 1 << (pin - 14);
+}
+
+/* -------------------------------------------------------
+                        i2cbus::i2cbus
+
+     Bus an SDA = Port sdaport, Bit sdabit und SCL =
+     Port sclport, Bit sclbit
+   ------------------------------------------------------- */
+i2cbus::i2cbus(uint8_t sdaport, uint8_t sdabit, uint8_t sclport, uint8_t sclbit)
+{
+  sdap= sdaport; sdam= 1 << sdabit;
+  sclp= sclport; sclm= 1 << sclbit;
+  devanz= 0;
+  state= st_idle;
+  devsda= 0;
+  sel= 0;
+  tstart= 0;
+  lastsda= 1; lastscl= 1;
+  clear_stats();
+}
+
+void i2cbus::attach(i2cdev *d)
+{
+  if (devanz < sim_maxdev) dev[devanz++]= d;
+}
+
+void i2cbus::clear_stats(void)
+{
+  memset(&stat, 0, sizeof(stat));
+  stat.bitmin_ns= ~0ULL;
+}
+
+/* -------------------------------------------------------
+                     i2cbus::master_level
+
+     Pegel, den der Controller an einem Pin ausgibt:
+     Ausgang = PORT-Bit, Eingang = 1 (Pull-Up am Bus)
+   ------------------------------------------------------- */
+uint8_t i2cbus::master_level(uint8_t port, uint8_t mask)
+{
+  if (sim_ddrreg[port].val & mask) return (sim_portreg[port].val & mask) ? 1 : 0;
+  return 1;
+}
+
+uint8_t i2cbus::scl(void)
+{
+  return master_level(sclp, sclm);
+}
+
+uint8_t i2cbus::sda(void)
+{
+  if (devsda) return 0;
+  return master_level(sdap, sdam);
+}
+
+/* -------------------------------------------------------
+                     i2cbus::pinmask
+
+     Maske fuer PINx von port: die Bits der Busleitungen
+     sind 0, wenn die Leitung Low ist
+   ------------------------------------------------------- */
+uint8_t i2cbus::pinmask(uint8_t port)
+{
+  uint8_t m;
+
+  m= 0xff;
+  if ((port == sdap) && !sda()) m &= ~sdam;
+  if ((port == sclp) && !scl()) m &= ~sclm;
+  return m;
+}
+
+/* -------------------------------------------------------
+                        i2cbus::update
+
+     stellt Flanken an SCL / SDA fest. Eine Aenderung
+     von SDA bei SCL = High ist Start bzw. Stop
+   ------------------------------------------------------- */
+void i2cbus::update(void)
+{
+  uint8_t s, d;
+
+  s= scl();
+  if (s != lastscl)
+  {
+    lastscl= s;
+    if (s) ev_rise(); else ev_fall();
+  }
+  d= sda();
+  // Slave zieht SDA auf Low, der Controller treibt High
+  if (devsda && (sim_ddrreg[sdap].val & sdam) && (sim_portreg[sdap].val & sdam)) stat.contention++;
+  if (d != lastsda)
+  {
+    lastsda= d;
+    if (lastscl)
+    {
+      if (d) ev_stop(); else ev_start();
+    }
+  }
+}
+
+void i2cbus::ev_start(void)
+{
+  uint8_t i;
+
+  if (!tstart) tstart= sim_now_ns();
+  stat.starts++;
+  for (i= 0; i< devanz; i++) dev[i]->start();
+  state= st_rx;
+  addrphase= 1;
+  bitcnt= 0; shift= 0;
+  devsda= 0;
+  sel= 0;
+  lastrise= 0;
+}
+
+void i2cbus::ev_stop(void)
+{
+  uint8_t i;
+
+  if (tstart)
+  {
+    stat.busy_ns += sim_now_ns() - tstart;
+    tstart= 0;
+  }
+  stat.stops++;
+  for (i= 0; i< devanz; i++) dev[i]->stop();
+  state= st_idle;
+  devsda= 0;
+  sel= 0;
+}
+
+void i2cbus::ev_rise(void)
+{
+  uint64_t now, per;
+
+  if ((state == st_idle) || (state == st_ignore)) return;
+
+  now= sim_now_ns();
+  if (lastrise)
+  {
+    per= now - lastrise;
+    stat.bits++;
+    stat.bit_ns += per;
+    if (per < stat.bitmin_ns) stat.bitmin_ns= per;
+    if (per > stat.bitmax_ns) stat.bitmax_ns= per;
+  }
+  lastrise= now;
+
+  switch (state)
+  {
+    case st_rx   : shift= (shift << 1) | (sda() ? 1 : 0);
+                   bitcnt++;
+                   break;
+    case st_mack : mack= sda() ? 0 : 1;
+                   break;
+    default      : break;
+  }
+}
+
+void i2cbus::ev_fall(void)
+{
+  uint8_t i;
+
+  switch (state)
+  {
+    case st_rx :
+      if (bitcnt < 8) break;
+      stat.bytes++;
+      bitcnt= 0;
+      if (addrphase)
+      {
+        addrphase= 0;
+        rw= shift & 1;
+        for (i= 0; i< devanz; i++)
+        {
+          if (dev[i]->match(shift >> 1)) { sel= dev[i]; break; }
+        }
+        if (sel && sel->select(shift >> 1, rw))
+        {
+          devsda= 1;
+          state= st_ackout;
+        }
+        else
+        {
+          sel= 0;
+          stat.nacks++;
+          state= st_ignore;
+        }
+      }
+      else
+      {
+        if (sel->write(shift)) devsda= 1; else stat.nacks++;
+        state= st_ackout;
+      }
+      shift= 0;
+      break;
+
+    case st_ackout :
+      devsda= 0;
+      if (rw)
+      {
+        shift= sel->read();
+        bitcnt= 0;
+        devsda= (shift & 0x80) ? 0 : 1;
+        state= st_tx;
+      }
+      else
+        state= st_rx;
+      break;
+
+    case st_tx :
+      bitcnt++;
+      if (bitcnt < 8)
+      {
+        devsda= ((shift << bitcnt) & 0x80) ? 0 : 1;
+      }
+      else
+      {
+        devsda= 0;
+        stat.bytes++;
+        mack= 0;
+        state= st_mack;
+      }
+      break;
+
+    case st_mack :
+      if (mack)
+      {
+        shift= sel->read();
+        bitcnt= 0;
+        devsda= (shift & 0x80) ? 0 : 1;
+        state= st_tx;
+      }
+      else
+        state= st_ignore;                       // Nack des Masters: letztes Byte
+      break;
+
+    default : break;
+  }
+}
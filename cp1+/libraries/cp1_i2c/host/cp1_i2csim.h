@@ -0,0 +1,158 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2csim.h
+
+     I2C Bussimulator fuer einen Build der Bibliotheken auf einem Linux-
+     Host (siehe Makefile)
+
+     Nachgebildet werden die Portregister PORTx / DDRx / PINx des
+     ATmega328p, eine virtuelle Zeit und ein oder mehrere I2C Busse
+     (open drain mit Pull-Up). Die Bibliotheken (swi2c, swi2c_fast,
+     eepr, realtimeclock, rda5807) werden unveraendert uebersetzt, jeder
+     Registerzugriff, pinMode / digitalWrite und jede Wartezeit laesst
+     die virtuelle Zeit weiterlaufen.
+
+     An einen Bus angeschlossene Bausteinmodelle (i2cdev, siehe
+     cp1_i2cdev.h) erkennen Start / Stop, lesen die Bits bei steigender
+     SCL-Flanke und legen Ack- bzw. Datenbits bei fallender Flanke an.
+
+     Kostenmodell (Takte bei F_CPU):
+
+         Registerzugriff (sbi / cbi / in)  : sim_cyc_reg
+         pinMode                           : sim_cyc_pinmode
+         digitalWrite                      : sim_cyc_dwrite
+         digitalRead                       : sim_cyc_dread
+
+     Schleifen und Funktionsaufrufe der Treiber selbst werden nicht
+     gezaehlt, die gemessenen Bitzeiten sind damit eine untere Grenze.
+     Fuer den Vergleich zweier Treiberversionen genuegt das.
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2csim
+  #define in_cp1_i2csim
+
+  #include <stdint.h>
+
+  #ifndef F_CPU
+    #define F_CPU             8000000UL
+  #endif
+
+  #define sim_cyc_reg         2
+  #define sim_cyc_pinmode     72
+  #define sim_cyc_dwrite      64
+  #define sim_cyc_dread       56
+
+  #define sim_maxbus          4
+  #define sim_maxdev          8
+
+  // Ports: Index fuer sim_port
+  #define sim_pb              0
+  #define sim_pc              1
+  #define sim_pd              2
+
+  /* ------------------------------------------------------
+       virtuelle Zeit
+     ------------------------------------------------------ */
+  extern uint64_t sim_ps;               // Picosekunden seit Programmstart
+
+  #define sim_now_ns()        (sim_ps / 1000)
+
+  void sim_advance(uint64_t ns);
+  void sim_cycles(uint32_t cyc);
+
+  /* ------------------------------------------------------
+       Portregister
+
+       Jede Aenderung eines PORT- oder DDR-Registers wertet
+       alle Busse aus, PINx liefert den Pegel der Busleitungen
+  ------------------------------------------------------ */
+  void sim_update(void);
+  uint8_t sim_pinread(uint8_t port);
+
+  class simreg
+  {
+    public:
+      uint8_t val;
+
+      simreg() : val(0) { }
+      operator uint8_t() const          { sim_cycles(sim_cyc_reg); return val; }
+      simreg &operator=(uint8_t v)      { val= v; sim_cycles(sim_cyc_reg); sim_update(); return *this; }
+      simreg &operator|=(uint8_t v)     { return *this= val | v; }
+      simreg &operator&=(uint8_t v)     { return *this= val & v; }
+      simreg &operator^=(uint8_t v)     { return *this= val ^ v; }
+  };
+
+  class simpin
+  {
+    public:
+      uint8_t port;
+
+      simpin(uint8_t p) : port(p) { }
+      operator uint8_t() const          { sim_cycles(sim_cyc_reg); return sim_pinread(port); }
+  };
+
+  extern simreg sim_portreg[3];
+  extern simreg sim_ddrreg[3];
+  extern simpin sim_pinreg[3];
+
+  /* ------------------------------------------------------
+       I2C Bus
+     ------------------------------------------------------ */
+  class i2cdev;
+
+  typedef struct
+  {
+    uint32_t starts;                    // Start- und wiederholte Startbedingungen
+    uint32_t stops;
+    uint32_t bytes;                     // alle Bytes inkl. Adressen
+    uint32_t nacks;                     // Nack auf Adresse oder Daten
+    uint32_t bits;                      // SCL-Perioden (steigende Flanke zu steigender
+    uint64_t bit_ns;                    // Flanke) zwischen Start und Stop, Summe
+    uint64_t bitmin_ns, bitmax_ns;
+    uint64_t busy_ns;                   // Zeit zwischen Start und Stop
+    uint32_t contention;                // Master treibt High, Slave Low
+  } i2cstat;
+
+  class i2cbus
+  {
+    public:
+
+      i2cstat stat;
+
+      i2cbus(uint8_t sdaport, uint8_t sdabit, uint8_t sclport, uint8_t sclbit);
+      void attach(i2cdev *dev);
+      void clear_stats(void);
+      uint8_t sda(void);
+      uint8_t scl(void);
+      uint8_t pinmask(uint8_t port);
+      void update(void);
+
+    private:
+
+      uint8_t  sdap, sdam, sclp, sclm;
+      uint8_t  lastsda, lastscl;
+      i2cdev  *dev[sim_maxdev];
+      uint8_t  devanz;
+
+      // Zustand des Slave-Automaten
+      uint8_t  state, addrphase, bitcnt, shift, rw, devsda, mack;
+      i2cdev  *sel;
+      uint64_t lastrise, tstart;
+
+      void  ev_start(void);
+      void  ev_stop(void);
+      void  ev_rise(void);
+      void  ev_fall(void);
+      uint8_t master_level(uint8_t port, uint8_t mask);
+  };
+
+  void sim_addbus(i2cbus *bus);
+
+  // Arduino Pinnummer => Port / Bitmaske
+  uint8_t sim_pin2port(uint8_t pin);
+  uint8_t sim_pin2mask(uint8_t pin);
+
+#endif
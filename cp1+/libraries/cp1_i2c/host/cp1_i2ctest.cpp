@@ -0,0 +1,97 @@
+/* ------------------------------------------------------------------
+                            cp1_i2ctest.cpp
+
+     prueft die I2C Treiber der Bibliotheken gegen die Bausteinmodelle
+     des Bussimulators (cp1_i2csim.h, cp1_i2cdev.h) bzw. misst deren
+     Busauslastung:
+
+       cp1_i2ctest        : Pruefungen (Rueckgabe 0, wenn alle
+                            bestanden sind)
+       cp1_i2ctest bench  : je Szenario Bytes auf dem Bus, Buszeit
+                            (Start bis Stop), mittlere / kuerzeste /
+                            laengste SCL-Periode, SCL-Frequenz und
+                            Durchsatz in Bytes / s Buszeit
+
+     Szenarien (cp1_test_swi2c.cpp, cp1_test_eepr.cpp):
+
+       i2c         : realtimeclock, rda5807 und LM75 auf dem gemeinsamen
+                     Bus (cp1_i2cbus.h, Treiber je nach i2c_backend) an
+                     P2_0 / P2_1 (PC0 / PC1) mit DS3231, RDA5807, LM75,
+                     bei swi2c zusaetzlich DS1307 an P2_2 / P2_3
+       swi2c_fast  : LM75 und DS3231 mit 100 kHz und 400 kHz
+       eepr        : 24C256 an PB7 / PB6
+
+     Die Makefile uebersetzt das Programm fuer i2c_bk_soft (cp1_i2ctest),
+     i2c_bk_fast mit 100 kHz, 400 kHz und ohne Wartezeit (cp1_i2ctest_100,
+     _400, _max).
+
+         make check
+         make bench
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <string.h>
+#include "cp1_i2ctest.h"
+#include "cp1_i2cbus.h"
+
+int errors= 0;
+
+void check(const char *name, int ok)
+{
+  printf("  %-44s %s\n", name, ok ? "ok" : "FAILED");
+  if (!ok) errors++;
+}
+
+void bench_head(void)
+{
+  printf("  %-30s %6s %10s %8s %8s %8s %7s %9s\n",
+         "Szenario", "Bytes", "Bus [us]", "SCL [ns]", "min", "max", "kHz", "Bytes/s");
+}
+
+void bench_begin(i2cbus *bus)
+{
+  bus->clear_stats();
+}
+
+void bench_end(const char *name, i2cbus *bus)
+{
+  i2cstat *s;
+  uint64_t per;
+
+  s= &bus->stat;
+  per= s->bits ? s->bit_ns / s->bits : 0;
+  printf("  %-30s %6u %10.1f %8llu %8llu %8llu %7.1f %9.0f\n",
+         name, s->bytes, s->busy_ns / 1000.0,
+         (unsigned long long)per,
+         (unsigned long long)(s->bits ? s->bitmin_ns : 0),
+         (unsigned long long)s->bitmax_ns,
+         per ? 1000000.0 / per : 0.0,
+         s->busy_ns ? s->bytes * 1.0e9 / s->busy_ns : 0.0);
+  if (s->contention) printf("  %-30s Buskonflikte: %u\n", "", s->contention);
+}
+
+int main(int argc, char **argv)
+{
+  uint8_t bench;
+
+  bench= (argc > 1) && !strcmp(argv[1], "bench");
+  if (bench)
+  {
+    printf("\n  I2C Busmessung (F_CPU = %lu Hz, Kostenmodell siehe cp1_i2csim.h)\n", (unsigned long)F_CPU);
+    printf("  i2c_backend = %d, i2c_freq = %lu\n\n", i2c_backend, (unsigned long)i2c_freq);
+    bench_head();
+  }
+  else
+    printf("\n  I2C Treiber gegen Bausteinmodelle (i2c_backend = %d, i2c_freq = %lu)\n\n",
+           i2c_backend, (unsigned long)i2c_freq);
+
+  test_swi2c(bench);
+  test_eepr(bench);
+
+  if (!bench) printf("\n  %d Fehler\n\n", errors);
+         else printf("\n");
+  return errors;
+}
@@ -0,0 +1,33 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2ctest.h
+
+     gemeinsame Funktionen der Pruef- und Messprogramme des Bus-
+     simulators (cp1_i2ctest.cpp)
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2ctest
+  #define in_cp1_i2ctest
+
+  #include <stdio.h>
+  #include "cp1_i2csim.h"
+  #include "cp1_i2cdev.h"
+
+  extern int errors;
+
+  void check(const char *name, int ok);
+
+  // Messung eines Szenarios: bench_begin setzt die Statistik des
+  // Busses zurueck, bench_end gibt eine Tabellenzeile aus
+  void bench_head(void);
+  void bench_begin(i2cbus *bus);
+  void bench_end(const char *name, i2cbus *bus);
+
+  // Pruefungen / Messungen je Treiber (bench = 1 : nur messen)
+  void test_swi2c(uint8_t bench);
+  void test_eepr(uint8_t bench);
+
+#endif
@@ -0,0 +1,206 @@
+/* ------------------------------------------------------------------
+                            cp1_test_eepr.cpp
+
+     eepr und eeplog (cp1_eeprom) gegen das Modell eines 24C256 an
+     PB7 (SDA) / PB6 (SCL)
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <string.h>
+#include "cp1_i2ctest.h"
+#include "cp1_eeprom.h"
+#include "cp1_eeplog.h"
+
+static i2cbus     bus(sim_pb, 7, sim_pb, 6);
+static sim24c256  chip;
+
+static eepr eep(sim_eep_page);
+static eepr eep8;                       // Pagegroesse eep_pagesize
+
+/* ---------------------------------------------------------
+                         test_eeplog
+
+     Datensaetze laenger als eine Page (eepr eep8, 8 Byte
+     Pages): ein Block aus 2 Pages je Datensatz
+   --------------------------------------------------------- */
+static void test_eeplog(void)
+{
+  eeplog   log8(&eep8, 0x800, 64, 6);   // 10 Byte Datensaetze, 4 Bloecke zu 16 Bytes
+  eeplog   big(&eep8, 0x800, 64, 61);   // Block 72 Bytes > elog_bufsize
+  eeplog   small(&eep, 0x800, 32, 8);   // Bereich kleiner als eine Page (64)
+  uint8_t  d[6], i, ok;
+
+  check("eeplog Datensatz > Page gueltig", log8.valid() && (log8.capacity() == 4));
+  check("eeplog Block > elog_bufsize ungueltig", !big.valid() && (big.capacity() == 0));
+  check("eeplog Bereich < Block ungueltig", !small.valid());
+
+  log8.clear();
+  chip.page_writes= 0;
+  for (i= 0; i< 6; i++)
+  {
+    memset(d, 0x10 + i, sizeof(d));
+    log8.append(d);
+  }
+  check("eeplog 2 Schreibzyklen je Datensatz", chip.page_writes == 12);
+
+  eeplog   again(&eep8, 0x800, 64, 6);
+  ok= again.begin() && (again.count() == 4);
+  for (i= 0; ok && (i< 4); i++)
+  {
+    ok= again.read(i, d) && (d[0] == 0x12 + i) && (d[5] == 0x12 + i);
+  }
+  check("eeplog begin / read nach Umlauf", ok);
+}
+
+/* ---------------------------------------------------------
+                       test_eeplog_bad
+
+     begin mit beschaedigten Datensaetzen (CRC-Fehler):
+     24 Datensaetze zu 10 Bytes, 4 Bloecke zu 64 Bytes.
+     Die beschaedigten Datensaetze liegen dort, wo die
+     binaere Suche zuerst liest.
+   --------------------------------------------------------- */
+static void eeplog_fill(eeplog *lg, uint8_t anz)
+{
+  uint8_t d[6], i;
+
+  lg->clear();
+  for (i= 0; i< anz; i++)
+  {
+    memset(d, i, sizeof(d));
+    lg->append(d);
+  }
+  lg->flush();
+}
+
+static void test_eeplog_bad(void)
+{
+  eeplog   lg(&eep, 0x1000, 256, 6);
+  uint8_t  d[6];
+  uint8_t  ok;
+
+  // 16 Datensaetze, Datensatz 12 (Mitte) beschaedigt
+  eeplog_fill(&lg, 16);
+  chip.mem[0x1000 + 2*64 + 0*10 + 4] ^= 0x01;
+  ok= lg.begin() && (lg.count() == 16) && !lg.read(12, d) &&
+      lg.read(13, d) && (d[0] == 13) && lg.read(15, d) && (d[0] == 15);
+  check("eeplog begin ueber beschaedigten Datensatz", ok);
+
+  memset(d, 0x40, sizeof(d));
+  lg.append(d);
+  lg.flush();
+  eeplog   again(&eep, 0x1000, 256, 6);
+  ok= again.begin() && (again.count() == 17) && again.read(16, d) && (d[0] == 0x40) &&
+      again.read(15, d) && (d[0] == 15);
+  check("eeplog append nach beschaedigtem Datensatz", ok);
+
+  // 30 Datensaetze (Umlauf), Datensatz 0 und der zuletzt geschriebene beschaedigt
+  eeplog_fill(&lg, 30);
+  chip.mem[0x1000 + 0*10 + 3] ^= 0x80;
+  chip.mem[0x1000 + 5*10 + 7] ^= 0x10;
+  ok= lg.begin() && (lg.count() == 24) && !lg.read(23, d) && !lg.read(18, d) &&
+      lg.read(22, d) && (d[0] == 28) && lg.read(0, d) && (d[0] == 6);
+  check("eeplog begin, letzter Datensatz beschaedigt", ok);
+
+  memset(d, 0x41, sizeof(d));
+  lg.append(d);
+  lg.flush();
+  ok= again.begin() && (again.count() == 24) && again.read(23, d) && (d[0] == 0x41) &&
+      !again.read(22, d) && again.read(0, d) && (d[0] == 7);
+  check("eeplog append, letzter Datensatz beschaedigt", ok);
+}
+
+void test_eepr(uint8_t bench)
+{
+  uint8_t  wbuf[256], rbuf[256];
+  uint16_t i;
+  uint8_t  ok;
+
+  bus.attach(&chip);
+  sim_addbus(&bus);
+
+  for (i= 0; i< sizeof(wbuf); i++) wbuf[i]= i * 7 + 3;
+
+  if (!bench)
+  {
+    check("eepr check_eeprom", eep.check_eeprom() == 1);
+
+    // 100 Bytes ab 0x1f0: Pages 0x1c0, 0x200, 0x240
+    eep.clear_stats();
+    chip.page_writes= 0;
+    chip.busy_polls= 0;
+    eep.writebuf(0x1f0, wbuf, 100);
+    check("eepr writebuf ueber Pagegrenzen im Modell", !memcmp(&chip.mem[0x1f0], wbuf, 100));
+    check("eepr writebuf 3 Schreibzyklen", (eep.page_writes == 3) && (chip.page_writes == 3));
+    check("eepr ack_poll wartet Schreibzyklus ab", chip.busy_polls > 0);
+    check("eepr Bytes vor / nach dem Block unveraendert",
+          (chip.mem[0x1ef] == 0xff) && (chip.mem[0x1f0 + 100] == 0xff));
+
+    memset(rbuf, 0, sizeof(rbuf));
+    eep.readbuf(0x1f0, rbuf, 100);
+    check("eepr readbuf", !memcmp(rbuf, wbuf, 100));
+
+    // 8 Byte Pages: 64 Bytes = 8 Schreibzyklen
+    chip.page_writes= 0;
+    eep8.writebuf(0x400, wbuf, 64);
+    check("eepr (Page 8) writebuf 8 Schreibzyklen",
+          (chip.page_writes == 8) && !memcmp(&chip.mem[0x400], wbuf, 64));
+
+#if (eep_cachepages > 0)
+    // Cache: write / read, erst flush schreibt
+    chip.page_writes= 0;
+    eep.write(0x10, 0x42);
+    eep.write(0x11, 0x43);
+    ok= (chip.mem[0x10] == 0xff) && (eep.read(0x10) == 0x42);
+    check("eepr write bleibt bis flush im Cache", ok && (chip.page_writes == 0));
+    eep.flush();
+    check("eepr flush", (chip.mem[0x10] == 0x42) && (chip.mem[0x11] == 0x43) && (chip.page_writes == 1));
+#else
+    // ohne Cache: write schreibt sofort
+    chip.page_writes= 0;
+    eep.write(0x10, 0x42);
+    eep.write(0x11, 0x43);
+    check("eepr write ohne Cache schreibt sofort",
+          (chip.mem[0x10] == 0x42) && (chip.mem[0x11] == 0x43) && (chip.page_writes == 2));
+    check("eepr read ohne Cache", eep.read(0x11) == 0x43);
+#endif
+
+    test_eeplog();
+    test_eeplog_bad();
+
+    chip.mem[0x2000]= 0x5a;
+    check("eepr read (Cache miss)", eep.read(0x2000) == 0x5a);
+
+    eep.erase(1);
+    ok= 1;
+    for (i= 0; i< sim_eep_size; i++) if (chip.mem[i] != 0xff) ok= 0;
+    check("eepr erase(1) loescht beschriebene Pages", ok);
+    check("eepr kein Buskonflikt", !bus.stat.contention);
+    return;
+  }
+
+  bench_begin(&bus);
+  eep.check_eeprom();
+  bench_end("eepr check_eeprom", &bus);
+
+  bench_begin(&bus);
+  eep.writebuf(0x0000, wbuf, 64);
+  bench_end("eepr writebuf 64 (Page)", &bus);
+
+  bench_begin(&bus);
+  eep.writebuf(0x0100, wbuf, 256);
+  bench_end("eepr writebuf 256", &bus);
+
+  bench_begin(&bus);
+  eep.readbuf(0x0100, rbuf, 256);
+  bench_end("eepr readbuf 256", &bus);
+
+  bench_begin(&bus);
+  eep.read(0x3000);
+  bench_end("eepr read (Cache miss)", &bus);
+
+  printf("  %-30s ack polls waehrend tWR: %u\n", "", chip.busy_polls);
+}
@@ -0,0 +1,228 @@
+/* ------------------------------------------------------------------
+                            cp1_test_swi2c.cpp
+
+     realtimeclock und rda5807 auf dem gemeinsamen Bus i2c (cp1_i2cbus.h)
+     sowie swi2c_fast gegen die Modelle von DS3231, DS1307, RDA5807 und
+     LM75
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include "cp1_i2ctest.h"
+#include "cp1_i2cbus.h"
+#include "cp1_rtc.h"
+#include "cp1_rda5807.h"
+
+#define lm75_addr       0x90
+
+i2cmaster i2c;                          // fuer realtimeclock und rda5807
+
+static i2cbus      bus(sim_pc, 0, sim_pc, 1);
+static i2cbus      bus1307(sim_pc, 2, sim_pc, 3);
+static simrtc      ds3231(sim_ds3231);
+static simrtc      ds1307(sim_ds1307);
+static simrda5807  radio;
+static simlm75     lm75;
+
+static realtimeclock rtc;
+static rda5807       rda;
+
+/* -------------------------------------------------------
+                        lm75_read
+
+     wie in lm75_rtc.ino: Temperatur * 10, -1000 bei
+     fehlendem Ack
+   ------------------------------------------------------- */
+template <class T> static int lm75_read(T &bus)
+{
+  uint8_t t1, t2;
+
+  if (!bus.start(lm75_addr))
+  {
+    bus.stop();
+    return -1000;
+  }
+  bus.write(0x00);
+  bus.write(0x00);
+  bus.stop();
+  bus.sendstart();
+  bus.write(lm75_addr | 1);
+  t1= bus.read_ack();
+  t2= bus.read_nack();
+  bus.stop();
+  return (int8_t)t1 * 10 + ((t2 & 0x80) ? 5 : 0);
+}
+
+// Blocklesen der Zeitregister 0..6 des DS3231
+template <class T> static void rtc_read7(T &bus, uint8_t *buf)
+{
+  uint8_t i;
+
+  bus.start(rtc_addr);
+  bus.write(0);
+  bus.stop();
+  bus.start(rtc_addr | 1);
+  for (i= 0; i< 6; i++) buf[i]= bus.read_ack();
+  buf[6]= bus.read_nack();
+  bus.stop();
+}
+
+/* -------------------------------------------------------
+                        fast_check
+
+     mittlere SCL-Periode von swi2c_fast<..., freq> muss
+     im Kostenmodell innerhalb 20% der Sollperiode liegen
+   ------------------------------------------------------- */
+template <uint32_t freq> static void fast_check(uint8_t bench)
+{
+  swi2c_fast<P2_0, P2_1, freq> fi2c;
+  uint8_t  buf[7];
+  uint64_t per, soll;
+  char     name[48];
+  int      t;
+
+  lm75.temp= 2 * 23 + 1;
+  bench_begin(&bus);
+  t= lm75_read(fi2c);
+  snprintf(name, sizeof(name), "swi2c_fast %lukHz lm75", (unsigned long)(freq / 1000));
+  if (bench) bench_end(name, &bus);
+        else check(name, t == 235);
+
+  bench_begin(&bus);
+  rtc_read7(fi2c, buf);
+  snprintf(name, sizeof(name), "swi2c_fast %lukHz rtc 7 Byte", (unsigned long)(freq / 1000));
+  if (bench)
+  {
+    bench_end(name, &bus);
+    return;
+  }
+  check(name, (buf[4] == 0x26) && (buf[5] == 0x03) && (buf[6] == 0x21));
+
+  per= bus.stat.bits ? bus.stat.bit_ns / bus.stat.bits : 0;
+  soll= 1000000000ULL / freq;
+  snprintf(name, sizeof(name), "swi2c_fast %lukHz SCL-Periode %lluns", (unsigned long)(freq / 1000),
+           (unsigned long long)per);
+  check(name, (per * 10 >= soll * 8) && (per * 10 <= soll * 12) && !bus.stat.contention);
+}
+
+void test_swi2c(uint8_t bench)
+{
+  uint8_t  i, sig;
+
+  bus.attach(&ds3231);
+  bus.attach(&radio);
+  bus.attach(&lm75);
+  sim_addbus(&bus);
+  bus1307.attach(&ds1307);
+  sim_addbus(&bus1307);
+
+  radio.station(1018, 90);
+  radio.station(1046, 80);
+
+  // ---------------- DS3231 -----------------
+  ds3231.settime(21, 3, 26, 12, 34, 56);
+
+  bench_begin(&bus);
+  rtc.readdate();
+  if (bench) bench_end("i2c rtc.readdate", &bus);
+  else
+  {
+    check("i2c rtc.readdate",
+          (date.jahr == 21) && (date.monat == 3) && (date.tag == 26) &&
+          (date.std == 12) && (date.min == 34) && (date.sek == 56));
+    check("i2c rtc.getwtag (Freitag)", rtc.getwtag() == 5);
+  }
+
+  delay(61000);
+  rtc.readdate();
+  if (!bench) check("i2c rtc laeuft mit (61 s)", (date.min == 35) && (date.sek == 57));
+
+  date.jahr= 24; date.monat= 2; date.tag= 29;
+  date.std= 23; date.min= 59; date.sek= 58;
+  bench_begin(&bus);
+  rtc.writedate();
+  if (bench) bench_end("i2c rtc.writedate", &bus);
+  delay(3000);
+  rtc.readdate();
+  if (!bench) check("i2c rtc.writedate, Tageswechsel",
+                    (date.jahr == 24) && (date.monat == 3) && (date.tag == 1) &&
+                    (date.std == 0) && (date.min == 0) && (date.sek == 1));
+
+  bench_begin(&bus);
+  i= rtc.read(0x11);
+  if (bench) bench_end("i2c rtc.read (1 Register)", &bus);
+        else check("i2c rtc.read Temperaturregister", i == 25);
+
+  ds3231.settime(21, 3, 26, 12, 34, 56);
+
+  // ---------------- DS1307 (RAM) ------------
+  // nur swi2c kann die Pins zur Laufzeit wechseln
+#if (i2c_backend == i2c_bk_soft)
+  uint8_t buf[8], ram[8];
+
+  for (i= 0; i< 8; i++) ram[i]= 0xa0 + i;
+  i2c.setpins(P2_2, P2_3);
+  bench_begin(&bus1307);
+  rtc.write_block(0x08, ram, 8);
+  if (bench) bench_end("i2c rtc.write_block 8", &bus1307);
+  memset(buf, 0, sizeof(buf));
+  bench_begin(&bus1307);
+  rtc.read_block(0x08, buf, 8);
+  if (bench) bench_end("i2c rtc.read_block 8", &bus1307);
+  else
+  {
+    check("i2c ds1307 RAM write_block / read_block", !memcmp(buf, ram, 8));
+    check("i2c ds1307 Register im Modell", !memcmp(&ds1307.regs[8], ram, 8));
+  }
+  i2c.setpins(P2_0, P2_1);
+#endif
+
+  // ---------------- RDA5807 -----------------
+  bench_begin(&bus);
+  rda.setfreq(1018);
+  if (bench) bench_end("i2c rda.setfreq", &bus);
+        else check("i2c rda.setfreq 101.8 MHz", radio.freq == 1018);
+
+  bench_begin(&bus);
+  sig= rda.getsig();
+  if (bench) bench_end("i2c rda.getsig", &bus);
+        else check("i2c rda.getsig Sender", sig >= sigschwelle);
+
+  rda.setfreq(1000);
+  if (!bench) check("i2c rda.getsig ohne Sender", rda.getsig() < sigschwelle);
+
+  bench_begin(&bus);
+  rda.setvol(5);
+  if (bench) bench_end("i2c rda.setvol", &bus);
+        else check("i2c rda.setvol (wahlfrei)", (radio.regs[5] & 0x0f) == 5);
+
+  if (!bench)
+  {
+    rda.scanup();
+    check("i2c rda.scanup 100.0 -> 101.8 MHz", (rda.aktfreq == 1018) && (radio.freq == 1018));
+    rda.scanup();
+    check("i2c rda.scanup 101.8 -> 104.6 MHz", (rda.aktfreq == 1046) && (radio.freq == 1046));
+  }
+
+  // ---------------- LM75 --------------------
+  lm75.temp= 2 * 23 + 1;
+  bench_begin(&bus);
+  if (bench)
+  {
+    lm75_read(i2c);
+    bench_end("i2c lm75", &bus);
+  }
+  else
+  {
+    check("i2c lm75 23.5 Grad", lm75_read(i2c) == 235);
+    lm75.temp= -2 * 5;
+    check("i2c lm75 -5.0 Grad", lm75_read(i2c) == -50);
+    check("i2c kein Buskonflikt", !bus.stat.contention);
+  }
+
+  // ---------------- swi2c_fast --------------
+  fast_check<100000>(bench);
+  fast_check<400000>(bench);
+}
@@ -0,0 +1,29 @@
+/* ---------------------------------------------------------------------------
+                                util/crc16.h
+
+     Ersatz fuer <util/crc16.h> beim Build auf einem Linux-Host
+     (nur _crc_xmodem_update, fuer eeplog)
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_util_crc16_host
+  #define in_util_crc16_host
+
+  #include <stdint.h>
+
+  static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data)
+  {
+    int i;
+
+    crc= crc ^ ((uint16_t)data << 8);
+    for (i= 0; i< 8; i++)
+    {
+      if (crc & 0x8000) crc= (crc << 1) ^ 0x1021; else crc <<= 1;
+    }
+    return crc;
+  }
+
+#endif
@@ -0,0 +1,22 @@
+/* ---------------------------------------------------------------------------
+                                util/delay.h
+
+     Ersatz fuer <util/delay.h> beim Build auf einem Linux-Host:
+     Wartezeiten lassen die virtuelle Zeit des Bussimulators
+     weiterlaufen
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_util_delay_host
+  #define in_util_delay_host
+
+  #include "../cp1_i2csim.h"
+
+  #define _delay_us(us)                     sim_advance((uint64_t)((us) * 1000.0))
+  #define _delay_ms(ms)                     sim_advance((uint64_t)((ms) * 1000000.0))
+  #define __builtin_avr_delay_cycles(cyc)   sim_cycles(cyc)
+
+#endif
@@ -0,0 +1,58 @@
+/* -------------------------------------------------------
+                         i2c_trace.ino
+
+     Mitschnitt der I2C Zugriffe: jede Sekunde wird die
+     Uhrzeit des DS3231 gelesen und ein Byte im externen
+     EEProm geschrieben. Ein Zeichen auf der seriellen
+     Schnittstelle (38400 Bd) gibt den Mitschnitt als CSV
+     aus und loescht ihn.
+
+     In cp1_i2ctr.h (cp1_i2c) muss dazu i2c_trace 1 gesetzt sein.
+     Der Mitschnitt belegt Timer1.
+
+     R. Seelig
+   ------------------------------------------------------ */
+
+#include "cp1_i2c.h"
+#include "cp1_rtc.h"
+#include "cp1_eeprom.h"
+#include "cp1_i2ctrace.h"
+
+swi2c           i2c(P2_0, P2_1);     // Objekt Software-I2C : i2c(sda, scl)
+realtimeclock   rtc;
+eepr            eep(64);             // 24LC256
+
+uint32_t        lastsek;
+uint8_t         cnt;
+
+/*  ---------------------------------------------------------
+                             setup
+    --------------------------------------------------------- */
+void setup()
+{
+  Serial.begin(38400);
+  i2ctrace_begin();
+  lastsek= 0;
+  cnt= 0;
+}
+
+/*  ---------------------------------------------------------
+                             loop
+    --------------------------------------------------------- */
+void loop()
+{
+  if ((millis() - lastsek) >= 1000)
+  {
+    lastsek= millis();
+    rtc.readdate();
+    eep.write(0, cnt++);
+    eep.flush();
+  }
+
+  if (Serial.available() > 0)
+  {
+    Serial.read();
+    i2ctrace_dump(Serial);
+    i2ctrace_clear();
+  }
+}
@@ -10,10 +10,9 @@
 #include <util/delay.h>
 
 #include "Arduino.h"
-#include "cp1_i2c.h"
+#include "cp1_i2cbus.h"
 
-// Software - I2C : i2c(sda, scl)
-extern swi2c i2c;
+// I2C-Bus i2c: Treiber und Takt siehe cp1_i2cbus.h
 
 class rda5807
 {
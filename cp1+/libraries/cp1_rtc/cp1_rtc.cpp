@@ -12,6 +12,13 @@
 
 struct my_datum date;  
 
+#if (rtc_sqwint == 1)
+  volatile uint8_t  rtc_tick= 0;
+  volatile uint16_t rtc_sqwcnt= 0;
+
+  static const uint8_t monatstage[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+#endif
+
 /* --------------------------------------------------
                        Konstruktor
    -------------------------------------------------- */  
@@ -24,6 +31,9 @@ realtimeclock::realtimeclock()
   date.tag= 1;
   date.monat= 1;
   date.jahr= 0; 
+  #if (rtc_sqwint == 1)
+    sqw_on= 0;
+  #endif
 }
 
 
@@ -70,6 +80,53 @@ void realtimeclock::write(uint8_t addr, uint8_t value)
   i2c.stop();
 }
 
+/* --------------------------------------------------
+     realtimeclock::read_block
+
+     liest n aufeinanderfolgende Register ab addr in
+     einer einzigen I2C-Uebertragung (Adresse setzen,
+     wiederholter Start, n Bytes lesen). Der RTC-Chip
+     liefert dabei einen konsistenten Zeitstand, auch
+     wenn waehrenddessen die Sekunde umspringt.
+
+     Uebergabe:
+         addr : erstes Register
+         buf  : Puffer fuer n Bytes
+         n    : Anzahl Register (> 0)
+   -------------------------------------------------- */
+void realtimeclock::read_block(uint8_t addr, uint8_t *buf, uint8_t n)
+{
+  i2c.sendstart();
+  i2c.write(rtc_addr);
+  i2c.write(addr);
+  i2c.sendstart();                            // wiederholter Start
+  i2c.write(rtc_addr | 1);
+  while (--n)
+  {
+    *buf++= i2c.read_ack();
+  }
+  *buf= i2c.read_nack();
+  i2c.stop();
+}
+
+/* --------------------------------------------------
+     realtimeclock::write_block
+
+     schreibt n aufeinanderfolgende Register ab addr
+     in einer einzigen I2C-Uebertragung
+   -------------------------------------------------- */
+void realtimeclock::write_block(uint8_t addr, uint8_t *buf, uint8_t n)
+{
+  i2c.sendstart();
+  i2c.write(rtc_addr);
+  i2c.write(addr);
+  while (n--)
+  {
+    i2c.write(*buf++);
+  }
+  i2c.stop();
+}
+
 /* --------------------------------------------------
       realtimeclock::bcd2dez
 
@@ -126,9 +183,9 @@ uint8_t realtimeclock::getwtag(void)
   int tag, monat, jahr;
   int w_tag;
 
-  tag=  bcd2dez(date.tag);
-  monat= bcd2dez(date.monat);
-  jahr= bcd2dez(date.jahr)+2000;
+  tag=  date.tag;
+  monat= date.monat;
+  jahr= date.jahr+2000;
 
   if (monat < 3)
   {
@@ -143,32 +200,175 @@ uint8_t realtimeclock::getwtag(void)
       realtimeclock::readdate
 
       liest den DS1307 / DS3231 Baustein in die
-      globale Struktur date ein.
+      globale Struktur date ein (Register 0..6 in
+      einem Block).
    -------------------------------------------------- */
 void realtimeclock::readdate(void)
 {
-  date.sek= bcd2dez(read(0) & 0x7f);
-  date.min= bcd2dez(read(1) & 0x7f);
-  date.std= bcd2dez(read(2) & 0x3f);
-  date.tag= bcd2dez(read(4) & 0x3f);
-  date.monat= bcd2dez(read(5) & 0x1f);
-  date.jahr= bcd2dez(read(6));
-  date.dow= bcd2dez(getwtag());
+  uint8_t r[7];
+  uint8_t sreg;
+
+  read_block(0, r, 7);
+  sreg= SREG;
+  cli();                                      // date wird evtl. im SQW-Interrupt weitergezaehlt
+  date.sek= bcd2dez(r[0] & 0x7f);
+  date.min= bcd2dez(r[1] & 0x7f);
+  date.std= bcd2dez(r[2] & 0x3f);
+  date.tag= bcd2dez(r[4] & 0x3f);
+  date.monat= bcd2dez(r[5] & 0x1f);
+  date.jahr= bcd2dez(r[6]);
+  date.dow= getwtag();
+  #if (rtc_sqwint == 1)
+    rtc_sqwcnt= 0;
+  #endif
+  SREG= sreg;
 }
 
 /* --------------------------------------------------
      realtimeclock::writedate
 
      schreibt die in der Struktur enthaltenen Daten
-     in den RTC-Chip
+     in den RTC-Chip (Register 0..6 in einem Block,
+     Register 3 erhaelt den Wochentag 1..7, 1 =
+     Sonntag)
    -------------------------------------------------- */
 void realtimeclock::writedate(void)
 {
-           
-  write(2, dez2bcd(date.std));
-  write(1, dez2bcd(date.min));
-  write(0, dez2bcd(date.sek));
-  write(4, dez2bcd(date.tag));
-  write(5, dez2bcd(date.monat));
-  write(6, dez2bcd(date.jahr));     
+  uint8_t r[7];
+
+  r[0]= dez2bcd(date.sek);
+  r[1]= dez2bcd(date.min);
+  r[2]= dez2bcd(date.std);
+  r[3]= getwtag() + 1;
+  r[4]= dez2bcd(date.tag);
+  r[5]= dez2bcd(date.monat);
+  r[6]= dez2bcd(date.jahr);
+  write_block(0, r, 7);
+}
+
+#if (rtc_sqwint == 1)
+
+/* --------------------------------------------------
+     realtimeclock::sqw_begin
+
+     schaltet den 1 Hz Ausgang SQW des DS3231 ein
+     (INTCN, RS2, RS1 = 0), liest die Uhrzeit und
+     gibt den Pinchange-Interrupt fuer SQW frei. Ab
+     jetzt wird date im Interrupt weitergezaehlt.
+   -------------------------------------------------- */
+void realtimeclock::sqw_begin(void)
+{
+  write(rtc_ctrl, read(rtc_ctrl) & ~0x1c);
+  rtc_sqw_init();
+  readdate();
+  rtc_tick= 0;
+
+  RTC_SQW_PCMSK |= (1 << RTC_SQW_PCINT);
+  PCICR |= (1 << RTC_SQW_PCIE);
+  sqw_on= 1;
 }
+
+/* --------------------------------------------------
+     realtimeclock::sqw_end
+
+     sperrt den SQW-Interrupt, date wird nicht mehr
+     weitergezaehlt
+   -------------------------------------------------- */
+void realtimeclock::sqw_end(void)
+{
+  RTC_SQW_PCMSK &= ~(1 << RTC_SQW_PCINT);
+  PCICR &= ~(1 << RTC_SQW_PCIE);
+  sqw_on= 0;
+}
+
+#endif
+
+/* --------------------------------------------------
+     realtimeclock::sek_changed
+
+     fuer die Hauptschleife anstelle von staendigem
+     readdate: liefert 1, wenn seit dem letzten
+     Aufruf eine neue Sekunde begonnen hat.
+
+     Im SQW-Betrieb wird alle rtc_resync Sekunden
+     die Uhrzeit per I2C neu gelesen, ohne SQW-
+     Betrieb bei jedem Aufruf.
+   -------------------------------------------------- */
+uint8_t realtimeclock::sek_changed(void)
+{
+  static uint8_t oldsek = 0xff;
+  #if (rtc_sqwint == 1)
+    uint16_t cnt;
+    uint8_t  sreg;
+
+    if (sqw_on)
+    {
+      if (!rtc_tick) return 0;
+      rtc_tick= 0;
+      sreg= SREG;
+      cli();                                  // 16 Bit, wird im SQW-Interrupt veraendert
+      cnt= rtc_sqwcnt;
+      SREG= sreg;
+      if (cnt >= rtc_resync) readdate();      // kurz nach dem Sekundenwechsel
+      return 1;
+    }
+  #endif
+
+  readdate();
+  if (date.sek== oldsek) return 0;
+  oldsek= date.sek;
+  return 1;
+}
+
+/* --------------------------------------------------
+     realtimeclock::getdate
+
+     kopiert date ohne Unterbrechung durch den SQW-
+     Interrupt nach *d
+   -------------------------------------------------- */
+void realtimeclock::getdate(struct my_datum *d)
+{
+  uint8_t sreg;
+
+  sreg= SREG;
+  cli();
+  *d= date;
+  SREG= sreg;
+}
+
+#if (rtc_sqwint == 1)
+
+/* --------------------------------------------------
+     RTC_SQW_vect
+
+     Pinchange-Interrupt des SQW-Ausgangs: mit der
+     fallenden Flanke beginnt beim DS3231 eine neue
+     Sekunde, date wird um eine Sekunde weiter-
+     gezaehlt.
+   -------------------------------------------------- */
+ISR (RTC_SQW_vect)
+{
+  uint8_t tage;
+
+  if (is_rtc_sqw()) return;                   // steigende Flanke
+
+  rtc_tick= 1;
+  rtc_sqwcnt++;
+  if (++date.sek < 60) return;
+  date.sek= 0;
+  if (++date.min < 60) return;
+  date.min= 0;
+  if (++date.std < 24) return;
+  date.std= 0;
+
+  date.dow= (date.dow + 1) % 7;
+  tage= monatstage[date.monat - 1];
+  if ((date.monat== 2) && !(date.jahr & 3)) tage++;        // Schaltjahr (2000..2099)
+  if (++date.tag <= tage) return;
+  date.tag= 1;
+  if (++date.monat <= 12) return;
+  date.monat= 1;
+  date.jahr++;
+}
+
+#endif
@@ -12,17 +12,46 @@
 #include <avr/interrupt.h>
   
 #include "Arduino.h"   
-#include "cp1_i2c.h"
+#include "cp1_i2cbus.h"
 
-// Software - I2C : i2c(sda, scl)
-extern swi2c i2c;
+// I2C-Bus i2c: Treiber und Takt siehe cp1_i2cbus.h
 
 extern struct my_datum date;  
 
 #define rtc_addr            0xd0              // 8-Bit I2C Adresse: R/W Flag ist Bestandteil der Adresse !
+#define rtc_ctrl            0x0e              // DS3231 Control-Register (INTCN, RS2, RS1)
 
-// Software - I2C : i2c(sda, scl)
-extern swi2c i2c;
+/*
+   SQW-Betrieb (nur DS3231): der 1 Hz Ausgang SQW des DS3231
+   (open drain) wird an P2_2 (PC2) angeschlossen und loest
+   einen Pinchange-Interrupt aus. Die Uhrzeit in date wird
+   dann im RAM weitergezaehlt und nur alle rtc_resync
+   Sekunden per I2C abgeglichen (siehe sqw_begin, sek_changed)
+
+   Der SQW-Betrieb belegt den Interruptvektor PCINT1_vect und
+   wird deshalb nur mit rtc_sqwint 1 uebersetzt. Da die Library
+   getrennt vom Sketch uebersetzt wird, ist rtc_sqwint hier
+   (oder per Compileroption) einzuschalten, ein #define im
+   Sketch reicht nicht.
+*/
+#ifndef rtc_sqwint
+  #define rtc_sqwint        0                 // 1: SQW-Betrieb, sqw_begin / sqw_end und ISR (PCINT1_vect)
+#endif
+
+#define rtc_sqw_init()      { DDRC &= ~(1 << PC2); PORTC |= (1 << PC2); }   // Eingang mit Pull-Up
+#define is_rtc_sqw()        ( PINC & (1 << PC2) )
+
+#define RTC_SQW_vect        PCINT1_vect
+#define RTC_SQW_PCINT       PCINT10
+#define RTC_SQW_PCMSK       PCMSK1
+#define RTC_SQW_PCIE        PCIE1
+
+#define rtc_resync          3600              // Sekunden zwischen zwei Abgleichen per I2C
+
+#if (rtc_sqwint == 1)
+  extern volatile uint8_t  rtc_tick;          // wird mit jeder neuen Sekunde gesetzt
+  extern volatile uint16_t rtc_sqwcnt;        // Sekunden seit dem letzten Abgleich
+#endif
 
 struct my_datum                               // Datum- und Uhrzeitsstruktur
 {
@@ -42,14 +71,25 @@ class realtimeclock
     realtimeclock();
     uint8_t read(uint8_t addr);
     void write(uint8_t addr, uint8_t value);
+    void read_block(uint8_t addr, uint8_t *buf, uint8_t n);
+    void write_block(uint8_t addr, uint8_t *buf, uint8_t n);
     uint8_t getwtag(void);
     void readdate(void);
     void writedate(void);
+  #if (rtc_sqwint == 1)
+    void sqw_begin(void);
+    void sqw_end(void);
+  #endif
+    uint8_t sek_changed(void);
+    void getdate(struct my_datum *d);
   
   protected:
   
   private:
     uint8_t bcd2dez(uint8_t value);
     uint8_t dez2bcd(uint8_t value);
+  #if (rtc_sqwint == 1)
+    uint8_t sqw_on;
+  #endif
 };
 
@@ -8,10 +8,10 @@
    ------------------------------------------------------ */
    
 #include "my_printf.h"   
-#include "cp1_i2c.h"
+#include "cp1_i2cbus.h"
 #include "cp1_rtc.h"
 
-swi2c i2c(P2_0, P2_1);  // Object Software-I2C : i2c(sda, scl)
+i2cmaster i2c;          // I2C-Bus, Treiber und Pins siehe cp1_i2cbus.h
 realtimeclock rtc;      // Object rtc
 
 
@@ -0,0 +1,100 @@
+/* -------------------------------------------------------
+                         rtc_sqw.ino
+
+     Uhrzeit des DS3231 auf der 7-Segmentanzeige, die
+     Uhrzeit wird ueber den 1 Hz Ausgang SQW (an P2_2)
+     im RAM weitergezaehlt und nur stuendlich per I2C
+     abgeglichen.
+
+     Benoetigt rtc_sqwint 1 in cp1_rtc.h (SQW-Interrupt).
+
+     R. Seelig
+   ------------------------------------------------------ */
+
+#include "cp1_tm1637.h"   
+#include "cp1_i2cbus.h"
+#include "cp1_rtc.h"
+
+#if (rtc_sqwint == 0)
+  #error "rtc_sqw benoetigt rtc_sqwint 1 in cp1_rtc.h"
+#endif
+
+i2cmaster       i2c;                 // I2C-Bus, Treiber und Pins siehe cp1_i2cbus.h
+realtimeclock   rtc;                 // Objekt rtc
+
+// tm1637 (Tastatur und 7-Segmentanzeige Chip) :
+//    SCL = A5
+//    SDA = A4
+//    Shift-Taste = D5
+
+tm1637          tm16(A5, A4, 5);     // Objekt Tasten- und Segmentanzeigentreiber
+
+/* --------------------------------------------------
+     stellen
+
+     die Uhr benutzerabgefragt stellen
+   -------------------------------------------------- */
+void stellen(void)
+{
+  uint8_t key;
+  
+  rtc.sqw_end();                       // date waehrend der Eingabe nicht weiterzaehlen
+  date.std= tm16.input(0x01, &key);    // Stunden einlesen
+  date.min= tm16.input(0x40, &key);    // Minuten einlesen
+  date.sek= tm16.input(0x08, &key);    // Sekunden einlesen
+  rtc.writedate();
+  rtc.sqw_begin();
+}
+
+/* --------------------------------------------------
+     showtime
+
+     zeigt die Uhrzeit an. date wird vom SQW-Interrupt
+     weitergezaehlt und deshalb mit getdate kopiert
+   -------------------------------------------------- */
+void showtime(void)
+{
+  struct my_datum d;
+
+  rtc.getdate(&d);
+
+  tm16.setzif(0,d.std /10);
+  tm16.setzif_dp(1,d.std % 10);
+  
+  tm16.setzif(2,d.min /10);
+  tm16.setzif_dp(3,d.min % 10);
+  
+  tm16.setzif(4,d.sek /10);
+  tm16.setzif(5,d.sek % 10);
+}
+
+/*  ---------------------------------------------------------
+                             setup
+    --------------------------------------------------------- */
+void setup() 
+{ 
+  tm16.clear();
+  tm16.setbright(2);
+
+  rtc.sqw_begin();                     // DS3231 SQW 1 Hz an P2_2
+  showtime(); 
+
+}
+
+  
+/*  ---------------------------------------------------------
+                             loop
+    --------------------------------------------------------- */
+void loop() 
+{
+  if (rtc.sek_changed())               // kein I2C-Zugriff bis zum naechsten Abgleich
+  {
+    showtime();    
+  }  
+
+  // Shift 8 aktiviert "Uhr stellen"
+  if (tm16.readshiftkeys(1,1)== 0x88)     // Shift - 8 = Input
+  {
+    stellen();
+  }    
+}
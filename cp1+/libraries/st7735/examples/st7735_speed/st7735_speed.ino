@@ -0,0 +1,129 @@
+/* -------------------------------------------------------------
+        Geschwindigkeit der Ausgabe auf ein ST7735 Display
+
+     misst mit micros() die Zeit fuer clrscr, push_pixels,
+     push_buffer, fillrect, putpixel und Textausgabe und gibt
+     Punkte pro Sekunde auf der seriellen Schnittstelle
+     (38400 Bd) aus.
+
+     Zum Vergleich eine geschaetzte Obergrenze, keine Messung
+     (auf echter Hardware nicht nachgeprueft):
+
+       SPI-Takt F_CPU/2     : 8 Bit = 16 CPU-Takte je Byte
+       + 2 Takte je Byte    : SPDR nach SPIF neu laden (angenommen)
+       2 Bytes je Punkt     : 36 CPU-Takte je Punkt
+       Punkte/s             = F_CPU / 36
+
+       F_CPU 16 MHz :  ca. 444000 Punkte/s (geschaetzt)
+       F_CPU  8 MHz :  ca. 222000 Punkte/s (geschaetzt)
+
+     Die Ausgabe dieses Sketches ist der gemessene Wert, er
+     liegt wegen Adressfenster, Schleifen und Funktionsaufrufen
+     darunter.
+   ------------------------------------------------------------- */
+
+#include "st7735.h"
+
+/*
+ Verdrahtung Display:
+   da Hardware-SPI verwendet wird sind CLK und DIO des Displays nicht
+   waehlbar.
+
+   Anschluss CLK:  Arduino D13  =  AVR-PB5
+   Anschluss DIO:  Arduino D11  =  AVR-PB3
+
+   rst= 8   = PB0
+   dc=  9   = PB1
+   ce=  10  = PB2
+*/
+
+#define xres            128
+#define yres            128
+
+st7735 lcd(8, 9, 10);         // Displayobjekt erzeugen
+
+uint16_t zeile[xres];         // eine Displayzeile fuer push_buffer
+
+/* --------------------------------------------------
+                       ausgabe
+
+     gibt die gemessene Zeit und die daraus be-
+     rechneten Punkte pro Sekunde aus
+   -------------------------------------------------- */
+void ausgabe(const __FlashStringHelper *name, uint32_t t, uint32_t punkte)
+{
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.print(t);
+  Serial.print(F(" us, "));
+  Serial.print((punkte * 10000UL) / (t / 100 ? t / 100 : 1));
+  Serial.println(F(" Punkte/s"));
+}
+
+/* --------------------------------------------------
+                       setup
+   -------------------------------------------------- */
+void setup()
+{
+  uint8_t i;
+
+  Serial.begin(38400);
+  lcd.init(xres, yres, 0, _RGB);
+  for (i= 0; i< xres; i++) zeile[i]= rgbfromvalue(i*2, 0, 255-i*2);
+}
+
+/* --------------------------------------------------
+                       loop
+   -------------------------------------------------- */
+void loop()
+{
+  uint32_t t;
+  int      x, y;
+
+  lcd.outmode= 0;
+
+  lcd.bkcolor= rgbfromega(blue);
+  t= micros();
+  lcd.clrscr();
+  lcd.flush();
+  ausgabe(F("clrscr     "), micros()-t, (uint32_t)xres*yres);
+
+  t= micros();
+  lcd.set_ram_address(0, 0, xres-1, yres-1);
+  lcd.push_pixels(rgbfromega(red), xres*yres);
+  lcd.flush();
+  ausgabe(F("push_pixels"), micros()-t, (uint32_t)xres*yres);
+
+  t= micros();
+  lcd.set_ram_address(0, 0, xres-1, yres-1);
+  for (y= 0; y< yres; y++) lcd.push_buffer(zeile, xres);
+  lcd.flush();
+  ausgabe(F("push_buffer"), micros()-t, (uint32_t)xres*yres);
+
+  t= micros();
+  for (y= 0; y< yres; y+= 8) lcd.fillrect(0, y, xres-1, y+7, rgbfromega(y >> 3));
+  lcd.flush();
+  ausgabe(F("fillrect   "), micros()-t, (uint32_t)xres*yres);
+
+  t= micros();
+  for (y= 0; y< 32; y++)
+    for (x= 0; x< xres; x++) lcd.putpixel(x, y, rgbfromega(white));
+  lcd.flush();
+  ausgabe(F("putpixel   "), micros()-t, (uint32_t)xres*32);
+
+  lcd.setfont(FNT8x8);
+  lcd.textsize= 0;
+  lcd.textcolor= rgbfromega(yellow);
+  lcd.bkcolor= rgbfromega(black);
+  t= micros();
+  for (y= 0; y< 16; y++)
+  {
+    lcd.gotoxy(0, y);
+    for (x= 0; x< 16; x++) lcd.lcd_putchar('A'+x);
+  }
+  lcd.flush();
+  ausgabe(F("Text 8x8   "), micros()-t, (uint32_t)16*16*64);
+
+  Serial.println();
+  delay(2000);
+}
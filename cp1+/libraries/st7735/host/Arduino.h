@@ -0,0 +1,38 @@
+/* ---------------------------------------------------------------------------
+                                Arduino.h
+
+     Ersatz fuer Arduino.h beim Build auf einem Linux-Host: Pin- und
+     Zeitfunktionen wirken auf das Panelmodell (st7735sim.h),
+     Implementierung in st7735sim.cpp
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_arduino_host
+  #define in_arduino_host
+
+  #include <stdint.h>
+  #include <stdlib.h>
+  #include <string.h>
+
+  #include <avr/io.h>
+  #include <avr/pgmspace.h>
+
+  #define INPUT           0
+  #define OUTPUT          1
+  #define LOW             0
+  #define HIGH            1
+
+  // Pinbelegung wie variants/.../pins_arduino.h
+  #define P1_2            (8)
+  #define P1_3            (9)
+  #define P1_4            (10)
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  void delay(unsigned long ms);
+  unsigned long micros(void);
+
+#endif
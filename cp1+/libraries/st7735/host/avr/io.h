@@ -0,0 +1,48 @@
+/* ---------------------------------------------------------------------------
+                                avr/io.h
+
+     Ersatz fuer <avr/io.h> beim Build auf einem Linux-Host: SPDR und
+     SPSR sind Objekte des Panelmodells (st7735sim.h), ein Schreiben
+     auf SPDR sendet ein Byte zum Display, ein Lesen von SPSR laesst
+     die laufende Uebertragung fortschreiten. Alle anderen Register
+     sind einfache Variable
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_avr_io_host
+  #define in_avr_io_host
+
+  #include <stdint.h>
+
+  struct sim_spdr
+  {
+    sim_spdr &operator=(uint8_t val);
+    operator uint8_t() const;
+  };
+
+  struct sim_spsr
+  {
+    sim_spsr &operator=(uint8_t val);
+    operator uint8_t() const;
+  };
+
+  extern sim_spdr SPDR;
+  extern sim_spsr SPSR;
+  extern uint8_t  SPCR, DDRB, PORTB;
+
+  #define SPIF            7
+  #define WCOL            6
+  #define SPI2X           0
+  #define SPE             6
+  #define MSTR            4
+
+  #define PB2             2
+  #define PB3             3
+  #define PB5             5
+
+  #define _BV(bit)        (1 << (bit))
+
+#endif
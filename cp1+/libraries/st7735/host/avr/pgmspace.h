@@ -0,0 +1,21 @@
+/* ---------------------------------------------------------------------------
+                                avr/pgmspace.h
+
+     Ersatz fuer <avr/pgmspace.h> beim Build auf einem Linux-Host:
+     Flash und RAM sind derselbe Adressraum
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_avr_pgmspace_host
+  #define in_avr_pgmspace_host
+
+  #include <stdint.h>
+
+  #define PROGMEM
+  #define pgm_read_byte(p)        (*(const uint8_t *)(p))
+  #define pgm_read_word(p)        (*(const uint16_t *)(p))
+
+#endif
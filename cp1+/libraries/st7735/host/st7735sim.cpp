@@ -0,0 +1,178 @@
+/* ---------------------------------------------------------------------------
+                                st7735sim.cpp
+
+     Modell eines ST7735 am SPI (siehe st7735sim.h) und die Pin- und
+     Zeitfunktionen von Arduino.h fuer den Build auf einem Linux-Host
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include "Arduino.h"
+#include "st7735sim.h"
+
+sim_spdr SPDR;
+sim_spsr SPSR;
+uint8_t  SPCR, DDRB, PORTB;
+
+uint16_t      sim_ram[sim_maxh][sim_maxw];
+int           sim_ramw, sim_ramh;
+unsigned long sim_spibytes, sim_spierr, sim_spihang, sim_outside;
+
+static uint8_t  dcpin, cepin;
+static uint8_t  dc, ce;
+static int      busy;                   // Abfragen von SPSR bis SPIF
+static uint8_t  spif;
+static long     polls;                  // Abfragen ohne laufende Uebertragung
+
+static uint8_t  cmd, npar, par[4];
+static uint8_t  madctl, hib, hav;
+static int      xs, xe, ys, ye, cx, cy;
+static unsigned long us;
+
+/* ---------------------------------------------------------
+                         sim_panel
+   --------------------------------------------------------- */
+void sim_panel(uint8_t dc_pin, uint8_t ce_pin, int ramw, int ramh)
+{
+  dcpin= dc_pin; cepin= ce_pin;
+  sim_ramw= ramw; sim_ramh= ramh;
+  dc= 1; ce= 1; busy= 0; spif= 0; polls= 0;
+  cmd= 0; madctl= 0; hav= 0;
+  xs= 0; xe= ramw-1; ys= 0; ye= ramh-1;
+  sim_spibytes= 0; sim_spierr= 0; sim_spihang= 0; sim_outside= 0;
+  sim_clear();
+}
+
+void sim_clear(void)
+{
+  memset(sim_ram, 0, sizeof(sim_ram));
+}
+
+void sim_foreign(void)
+{
+  if (busy) sim_spierr++;
+  busy= 0; spif= 0;
+}
+
+/* ---------------------------------------------------------
+                         ramwrite
+
+     ein Punkt an der Adresse cx, cy des Fensters, danach
+     weiter zur naechsten Adresse (Spalte zuerst)
+   --------------------------------------------------------- */
+static void ramwrite(uint16_t color)
+{
+  int u, v;
+
+  if (madctl & 0x20) { u= cy; v= cx; }          // MV
+                else { u= cx; v= cy; }
+  if (madctl & 0x40) u= sim_ramw-1-u;           // MX
+  if (madctl & 0x80) v= sim_ramh-1-v;           // MY
+  if ((u >= 0) && (v >= 0) && (u < sim_ramw) && (v < sim_ramh))
+    sim_ram[v][u]= color;
+  else
+    sim_outside++;
+
+  if (++cx > xe)
+  {
+    cx= xs;
+    if (++cy > ye) cy= ys;
+  }
+}
+
+/* ---------------------------------------------------------
+                         SPDR, SPSR
+   --------------------------------------------------------- */
+sim_spdr &sim_spdr::operator=(uint8_t val)
+{
+  int a1, a2;
+
+  if (busy) sim_spierr++;
+  busy= sim_spipoll; spif= 0;
+  if (ce) return *this;
+
+  sim_spibytes++;
+  us++;                                         // 8 Bit bei F_CPU/2, 16 MHz
+  if (!dc)
+  {
+    cmd= val; npar= 0; hav= 0;
+    if (cmd == 0x2c) { cx= xs; cy= ys; }
+    return *this;
+  }
+  switch (cmd)
+  {
+    case 0x36 : madctl= val;
+                break;
+    case 0x2a :
+    case 0x2b : if (npar < 4) par[npar++]= val;
+                a1= (par[0] << 8) | par[1];
+                a2= (par[2] << 8) | par[3];
+                if (cmd == 0x2a) { if (npar == 2) xs= a1; if (npar == 4) xe= a2; }
+                            else { if (npar == 2) ys= a1; if (npar == 4) ye= a2; }
+                break;
+    case 0x2c : if (!hav) { hib= val; hav= 1; break; }
+                hav= 0;
+                ramwrite((hib << 8) | val);
+                break;
+    default   : break;
+  }
+  return *this;
+}
+
+sim_spdr::operator uint8_t() const
+{
+  spif= 0;
+  return 0;
+}
+
+sim_spsr &sim_spsr::operator=(uint8_t)
+{
+  return *this;
+}
+
+sim_spsr::operator uint8_t() const
+{
+  if (busy && !--busy) spif= 1;
+  if (!busy && !spif)
+  {
+    if (++polls > sim_maxpoll)
+    {
+      sim_spihang++;                            // auf dem AVR: Endlosschleife
+      polls= 0;
+      spif= 1;
+    }
+  }
+  else
+    polls= 0;
+  return spif ? (1 << SPIF) : 0;
+}
+
+/* ---------------------------------------------------------
+                 Pin- und Zeitfunktionen
+   --------------------------------------------------------- */
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if ((pin == dcpin) || (pin == cepin))
+  {
+    if (busy) sim_spierr++;
+    if (pin == dcpin) dc= val; else ce= val;
+  }
+}
+
+void delay(unsigned long ms)
+{
+  us += ms * 1000;
+}
+
+unsigned long micros(void)
+{
+  return us;
+}
@@ -0,0 +1,53 @@
+/* ---------------------------------------------------------------------------
+                                st7735sim.h
+
+     Modell eines ST7735 am SPI des ATmega328p fuer einen Build der
+     Bibliothek auf einem Linux-Host (siehe Makefile)
+
+     Nachgebildet werden SPDR / SPSR mit einer Uebertragungsdauer von
+     sim_spipoll Abfragen von SPSR, die Pins DC und CE und im Controller
+     die Kommandos CASET (0x2a), RASET (0x2b), RAMWR (0x2c) und MADCTL
+     (0x36). Der Displayram (sim_ramw x sim_ramh) wird so abgelegt, wie
+     er auf dem Glas erscheint: Spalte / Zeile nach der Umsetzung durch
+     MV, MX und MY.
+
+     Gezaehlt werden:
+
+         sim_spibytes  : gesendete Bytes bei aktivem CE
+         sim_spierr    : Schreiben auf SPDR, Umschalten von DC oder CE
+                         waehrend einer laufenden Uebertragung
+         sim_spihang   : Warten auf SPIF ohne laufende Uebertragung
+                         (auf dem AVR eine Endlosschleife, hier wird
+                         nach sim_maxpoll Abfragen abgebrochen)
+         sim_outside   : Punkte ausserhalb des Displayrams
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_st7735sim
+  #define in_st7735sim
+
+  #include <stdint.h>
+
+  #define sim_spipoll         3
+  #define sim_maxpoll         100000L
+
+  #define sim_maxw            256
+  #define sim_maxh            256
+
+  extern uint16_t      sim_ram[sim_maxh][sim_maxw];
+  extern int           sim_ramw, sim_ramh;
+
+  extern unsigned long sim_spibytes, sim_spierr, sim_spihang, sim_outside;
+
+  // Panel an den Pins dc / ce mit ramw x ramh Punkten Displayram,
+  // loescht Displayram und Zaehler
+  void sim_panel(uint8_t dcpin, uint8_t cepin, int ramw, int ramh);
+  void sim_clear(void);
+
+  // ein anderer Baustein hat den SPI-Bus benutzt: SPIF ist geloescht
+  void sim_foreign(void);
+
+#endif
@@ -0,0 +1,346 @@
+/* ------------------------------------------------------------------
+                            st7735test.cpp
+
+     prueft st7735 und st7735tile gegen das Panelmodell (st7735sim.h)
+     fuer Displays mit 128x160 und 128x128 Punkten (ofsmode, ramrows,
+     version_g, gespiegelt) in allen 4 Lagen (outmode):
+
+       Drehung  : putpixel trifft den Punkt des Displayrams, auf dem
+                  er mit MX und MY nach init (Lage 0) und der Drehung
+                  in Software erscheinen muss. Punkte ausserhalb des
+                  Displays werden nicht gesetzt
+       Fenster  : fillrect, clrscr und push_buffer (ueber set_ram_address)
+                  ergeben dasselbe Bild wie putpixel
+       Kacheln  : st7735tile ergibt dasselbe Bild wie die direkte Aus-
+                  gabe, ein zweites render gibt keine Kachel aus
+       SPI      : keine Kollision auf SPI, kein Warten auf SPIF ohne
+                  laufende Uebertragung (auch nachdem ein anderer
+                  Baustein den Bus benutzt hat), keine Punkte ausserhalb
+                  des Displayrams
+
+     Rueckgabe 0, wenn alle Pruefungen bestanden sind.
+
+         make check
+
+     MCU  :   Linux-Host
+
+     R. Seelig
+   ------------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <string.h>
+#include "st7735.h"
+#include "st7735_tile.h"
+#include "st7735sim.h"
+
+struct cfg
+{
+  const char *name;
+  uint16_t   yres;
+  uint8_t    mirror;
+  uint8_t    vg;                        // version_g
+  int8_t     ofs;                       // ofsmode
+  uint8_t    rows;                      // ramrows, 0 = Standard
+  int        ramw, ramh;                // Displayram des Modells
+  int        co, ro;                    // Offset von Spalte / Zeile in Lage 0
+};
+
+static const cfg cfgs[] =
+{
+  { "128x160",               160, 0, 0, -32,   0, 128, 160, 0,  0 },
+  { "128x160 gespiegelt",    160, 1, 0, -32,   0, 128, 160, 0,  0 },
+  { "128x128",               128, 0, 0, -32,   0, 128, 160, 0,  0 },
+  { "128x128 ofsmode(0)",    128, 0, 0,   0,   0, 128, 160, 0, 32 },
+  { "128x128 ramrows(162)",  128, 0, 0, -32, 162, 128, 162, 0,  0 },
+  { "128x128 version_g",     128, 0, 1, -32,   0, 132, 132, 2,  3 }
+};
+
+#define cfganz      (sizeof(cfgs) / sizeof(cfgs[0]))
+#define xres        128
+
+static const unsigned char PROGMEM bmp[] = { 0,10, 0,3, 0xff,0xc0, 0x81,0x40, 0xaa,0x80 };
+
+static uint16_t ref[sim_maxh][sim_maxw];
+static uint16_t prev[sim_maxh][sim_maxw];
+static char     txt[16];
+
+int errors= 0;
+
+void check(const char *name, int ok)
+{
+  printf("  %-44s %s\n", name, ok ? "ok" : "FAILED");
+  if (!ok) errors++;
+}
+
+static int ramdiff(void)
+{
+  int x, y, n;
+
+  n= 0;
+  for (y= 0; y< sim_maxh; y++)
+    for (x= 0; x< sim_maxw; x++)
+      if (sim_ram[y][x] != ref[y][x]) n++;
+  return n;
+}
+
+static int ramcount(void)
+{
+  int x, y, n;
+
+  n= 0;
+  for (y= 0; y< sim_maxh; y++)
+    for (x= 0; x< sim_maxw; x++)
+      if (sim_ram[y][x]) n++;
+  return n;
+}
+
+/* ---------------------------------------------------------
+                           glass
+
+     Punkt x,y in Lage mode auf dem Displayram, wie ihn
+     putpixel bei fester Lage des Controllers (MX, MY nach
+     init) in Software umgesetzt hat. Rueckgabe 0, wenn er
+     nicht auf dem Display liegt
+   --------------------------------------------------------- */
+static uint8_t glass(const cfg *c, uint8_t mode, int x, int y, int *col, int *row)
+{
+  int u, v;
+
+  switch (mode)
+  {
+    case 0  : u= x;          v= y;           break;
+    case 1  : u= y;          v= c->yres-1-x; break;
+    case 2  : u= xres-1-y;   v= x;           break;
+    default : u= xres-1-x;   v= c->yres-1-y; break;
+  }
+  if (c->mirror) u= xres-u;
+  *col= c->ramw-1-(u+c->co);
+  *row= c->ramh-1-(v+c->ro);
+  return (u >= 0) && (u < xres) && (v >= 0) && (v < c->yres);
+}
+
+static void lcd_setup(st7735 *lcd, const cfg *c)
+{
+  sim_panel(P1_3, P1_4, c->ramw, c->ramh);
+  if (c->vg) lcd->version_g();
+  lcd->ofsmode(c->ofs);
+  if (c->rows) lcd->ramrows(c->rows);
+  lcd->init(xres, c->yres, c->mirror, _RGB);
+}
+
+/* ---------------------------------------------------------
+                         test_rotation
+
+     Punkte eines Rasters (auch ausserhalb des Displays),
+     Farbe aus den Koordinaten
+   --------------------------------------------------------- */
+static uint8_t test_rotation(st7735 *lcd, const cfg *c, uint8_t mode, int w, int h)
+{
+  int      x, y, col, row, n;
+  uint8_t  ok;
+  uint16_t color;
+
+  sim_clear();
+  for (y= -2; y< h+2; y+= 3)
+    for (x= -2; x< w+2; x+= 3) lcd->putpixel(x, y, ((x+4) << 8) | (y+4));
+  for (x= 0; x< w; x++) lcd->putpixel(x, h-1, ((x+4) << 8) | (h+3));
+  for (y= 0; y< h; y++) lcd->putpixel(w-1, y, ((w+3) << 8) | (y+4));
+
+  ok= 1; n= 0;
+  for (y= -2; y< h+2; y++)
+    for (x= -2; x< w+2; x++)
+    {
+      if (((x+2) % 3) || ((y+2) % 3))               // Raster oder rechte / untere Kante
+        if (!(((x == w-1) && (y >= 0) && (y < h)) || ((y == h-1) && (x >= 0) && (x < w)))) continue;
+      if (!glass(c, mode, x, y, &col, &row)) continue;
+      color= ((x+4) << 8) | (y+4);
+      if (sim_ram[row][col] != color) ok= 0;
+      n++;
+    }
+  return ok && (ramcount() == n);
+}
+
+/* ---------------------------------------------------------
+                          test_window
+
+     fillrect (auch teilweise ausserhalb), push_buffer und
+     clrscr gegen putpixel
+   --------------------------------------------------------- */
+static uint8_t test_window(st7735 *lcd, const cfg *c, uint8_t mode, int w, int h)
+{
+  static const int r[4][4] = { { -5, -3, 20, 10 }, { 30, 40, 50, 41 }, { 7, 7, 7, 7 }, { -4, -4, -4, -4 } };
+  uint16_t buf[13*6];
+  int      i, x, y, col, row;
+  uint8_t  ok;
+
+  sim_clear();
+  for (i= 0; i< 4; i++) lcd->fillrect(r[i][0], r[i][1], r[i][2], r[i][3], 0x1111*(i+1));
+  lcd->fillrect(w-10, h-7, w+4, h+2, 0x5555);
+  for (i= 0; i< 13*6; i++) buf[i]= 0x0100 + i;
+  lcd->set_ram_address(5, 9, 5+13-1, 9+6-1);
+  lcd->push_buffer(buf, 13*6);
+  memcpy(ref, sim_ram, sizeof(ref));
+
+  sim_clear();
+  for (i= 0; i< 4; i++)
+    for (y= r[i][1]; y<= r[i][3]; y++)
+      for (x= r[i][0]; x<= r[i][2]; x++) lcd->putpixel(x, y, 0x1111*(i+1));
+  for (y= h-7; y<= h+2; y++)
+    for (x= w-10; x<= w+4; x++) lcd->putpixel(x, y, 0x5555);
+  for (i= 0; i< 13*6; i++) lcd->putpixel(5 + i % 13, 9 + i / 13, buf[i]);
+  ok= !ramdiff();
+
+  sim_clear();
+  lcd->bkcolor= 0x0f0f;
+  lcd->clrscr();
+  for (y= -1; y<= h; y++)                        // gespiegelt um einen Punkt verschoben
+    for (x= -1; x<= w; x++)
+      if (glass(c, mode, x, y, &col, &row) && (sim_ram[row][col] != 0x0f0f)) ok= 0;
+  lcd->bkcolor= 0;
+  return ok && (ramcount() == w*h);
+}
+
+/* ---------------------------------------------------------
+                          test_tiles
+
+     Szene aus Linien, Rechtecken, Ellipsen, Text und einer
+     Bitmap, 4 Bilder nacheinander: direkt (Text und Bitmap
+     ueber putpixel) und ueber st7735tile (ab dem 2. Bild
+     nur die geaenderten Kacheln)
+   --------------------------------------------------------- */
+template <class D> static void scene(D *d, int k, int h)
+{
+  d->fillcircle(64, 62, 41, 0x1234);
+  d->rectangle(30, 30, 70, 55, 0x2222);
+  d->fillrect(60, 40, 110, 47, 0x3333);
+  d->ellipse(50, 70, 30, 9, 0x4444);
+  d->line(0, 0, 127, h-1, 0x5555);
+  d->line(64, 62, 64+k*3, 20, 0x6666+k);
+  d->line(64, 62, 100, 62+k, 0x7777);
+}
+
+static void direct_bitmap(st7735 *lcd, int x, int y, const unsigned char *image, uint16_t color)
+{
+  int bw, bh, bpr, r, c;
+
+  bw= image[1]; bh= image[3]; bpr= (bw+7) / 8;
+  for (r= 0; r< bh; r++)
+    for (c= 0; c< bw; c++)
+      if (image[4 + r*bpr + c/8] & (0x80 >> (c & 7))) lcd->putpixel(x+c, y+r, color);
+}
+
+static uint8_t test_tiles(st7735 *lcd, st7735tile *t, int w, int h)
+{
+  int           ax1, ay1, ax2, ay2, k, f;
+  uint8_t       ok;
+  unsigned long b;
+  char          *p;
+
+  ax1= 3; ay1= 5; ax2= w-4; ay2= h-2;
+  if (!t->area(ax1, ay1, ax2, ay2)) return 0;
+  t->bkcolor= 0x0101;
+
+  ok= 1;
+  for (k= 0; k< 4; k++)
+  {
+    sprintf(txt, "Ab%d:%c", k, 'x'+k%2);
+
+    sim_clear();
+    lcd->fillrect(ax1, ay1, ax2, ay2, 0x0101);
+    scene(lcd, k, h);
+    direct_bitmap(lcd, 20+k, 90, bmp, 0x8888);
+    lcd->fntfilled= 0;
+    for (f= 0; f< 3; f++)
+    {
+      lcd->setfont(f); lcd->textsize= (f == 0);
+      lcd->textcolor= 0x9999+f;
+      lcd->aktxp= 8; lcd->aktyp= 100+f*20;
+      for (p= txt; *p; p++) lcd->lcd_putchar(*p);
+    }
+    lcd->fillrect(-2, -2, w+1, ay1-1, 0);   lcd->fillrect(-2, ay2+1, w+1, h+1, 0);
+    lcd->fillrect(-2, -2, ax1-1, h+1, 0);   lcd->fillrect(ax2+1, -2, w+1, h+1, 0);
+    memcpy(ref, sim_ram, sizeof(ref));
+
+    if (!k) { sim_clear(); t->invalidate(); }
+       else memcpy(sim_ram, prev, sizeof(prev));
+    t->reset();
+    scene(t, k, h);
+    t->bitmap(20+k, 90, bmp, 0x8888);
+    for (f= 0; f< 3; f++)
+    {
+      lcd->setfont(f); lcd->textsize= (f == 0);
+      t->outtextxy(8, 100+f*20, txt, 0x9999+f);
+    }
+    lcd->setfont(0); lcd->textsize= 0;
+    t->render();
+    if (ramdiff() || t->lost) ok= 0;
+    memcpy(prev, sim_ram, sizeof(prev));
+
+    b= sim_spibytes;
+    if (t->render() || (sim_spibytes != b)) ok= 0;
+  }
+  lcd->fntfilled= 1;
+  return ok;
+}
+
+/* ---------------------------------------------------------
+                          test_foreign
+
+     ein anderer Baustein benutzt den Bus zwischen zwei
+     Ausgaben (nach flush), SPIF ist danach geloescht
+   --------------------------------------------------------- */
+static uint8_t test_foreign(st7735 *lcd, const cfg *c)
+{
+  int col, row;
+
+  lcd->outmode= 0;
+  sim_clear();
+  lcd->putpixel(1, 1, 0x1234);
+  lcd->flush();
+  sim_foreign();
+  lcd->putpixel(2, 1, 0x4321);
+  lcd->flush();
+  sim_foreign();
+  lcd->fillrect(3, 1, 3, 1, 0x5678);
+  glass(c, 0, 3, 1, &col, &row);
+  return !sim_spihang && (sim_ram[row][col] == 0x5678);
+}
+
+int main(void)
+{
+  unsigned int i;
+  uint8_t      mode, okr, okw, okt;
+  int          w, h;
+  char         s[64];
+
+  printf("\n  st7735 gegen Panelmodell\n\n");
+
+  for (i= 0; i< cfganz; i++)
+  {
+    const cfg  *c= &cfgs[i];
+    st7735     lcd(P1_2, P1_3, P1_4);
+    st7735tile t(&lcd);
+
+    lcd_setup(&lcd, c);
+    okr= okw= okt= 1;
+    for (mode= 0; mode< 4; mode++)
+    {
+      lcd.outmode= mode;
+      w= (mode == 1) || (mode == 2) ? c->yres : xres;
+      h= (mode == 1) || (mode == 2) ? xres : c->yres;
+      if (!test_rotation(&lcd, c, mode, w, h)) okr= 0;
+      if (!test_window(&lcd, c, mode, w, h)) okw= 0;
+      if (!test_tiles(&lcd, &t, w, h)) okt= 0;
+    }
+    printf("  %s\n", c->name);
+    check("  Drehung (outmode 0..3)", okr);
+    check("  Fenster gegen putpixel", okw);
+    check("  Kacheln gegen direkte Ausgabe", okt);
+    check("  SPI nach fremdem Buszugriff", test_foreign(&lcd, c));
+    snprintf(s, sizeof(s), "  SPI Fehler %lu, SPIF %lu, ausserhalb %lu", sim_spierr, sim_spihang, sim_outside);
+    check(s, !sim_spierr && !sim_spihang && !sim_outside);
+  }
+
+  printf("\n  %d Fehler\n\n", errors);
+  return errors;
+}
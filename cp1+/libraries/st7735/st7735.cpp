@@ -102,7 +102,8 @@ st7735::st7735(uint8_t rst, uint8_t dc, uint8_t ce)
    ------------------------------------------------------- */
 void st7735::version_g()
 {
-  colofs= 2; rowofs= 3;  
+  colofs= 2; rowofs= 3; _ramh= 132;
+  _actmode= 0xff;
 }
 
 /* -------------------------------------------------------
@@ -116,6 +117,23 @@ void st7735::version_g()
 void st7735::ofsmode(int8_t ofs)
 {
   _lcyofs= ofs;
+  _actmode= 0xff;
+}
+
+/* -------------------------------------------------------
+                       st7735::ramrows
+
+     Anzahl der Zeilen des Displayrams im Controller.
+     Standard ist 160 (ST7735 fuer 128x160 Pixel), nach
+     version_g 132. Fuer Controller, die 162 Zeilen
+     adressieren, muss hier 162 angegeben werden, sonst
+     sind bei Displays mit 128 Zeilen die Ausgaben in den
+     Lagen 1 und 3 um 2 Zeilen verschoben.
+   ------------------------------------------------------- */
+void st7735::ramrows(uint8_t rows)
+{
+  _ramh= rows;
+  _actmode= 0xff;
 }
 
 /* ----------------------------------------------------------
@@ -131,35 +149,20 @@ void st7735::spi_init()
   SPCR = (1 << SPE) | (1 << MSTR);
   // Taktrate F_CPU/2
   SPSR = (1 << SPI2X);
-}
-
-
-/* -------------------------------------------------------------
-     st7735::spi_lcdout
-
-      Byte ueber SPI senden
-
-        data : zu sendendes Datum
-   ------------------------------------------------------------- */
-void st7735::spi_lcdout(uint8_t data)
-{
-  uint8_t dummy;
-
-  SPDR=data;                                // Datum senden
-  while( ( SPSR & 0x80 ) != 0x80 );         // ... und warten bis es gesendet ist
-
-  dummy= SPDR;
+  _spipend= 0;
 }
 
 /* -------------------------------------------------------------
      st7735::wrcmd
 
-     sendet Kommando via SPI an das LCD
+     sendet Kommando via SPI an das LCD. DC wird erst nach dem
+     Ende der laufenden Uebertragung umgeschaltet.
 
       data : zu sendendes Datum
    ------------------------------------------------------------- */
 void st7735::wrcmd(uint8_t cmd)
 {
+  spi_wait();
   dc_clr();                             // C/D = 0 Kommandomodus
   spi_lcdout(cmd);                         // senden
 }
@@ -173,142 +176,179 @@ void st7735::wrcmd(uint8_t cmd)
    ------------------------------------------------------------- */
 void st7735::wrdata(uint8_t data)
 {
-  dc_set();                             // C/D = 1 Kommandomodus
+  spi_wait();
+  dc_set();                             // C/D = 1 Datenmodus
   spi_lcdout(data);                        // senden/
 }
 
 /* ----------------------------------------------------------
-     st7735::wrdata16
-
-     sendet ein 16 Bit Integer via SPI an das Display
-
-       data : zu sendendes 16-Bit Datum
+     st7735::wrwin
 
+     sendet ein Kommando mit Start- und Endadresse (coladdr
+     bzw. rowaddr) als 4 Datenbytes
    ---------------------------------------------------------- */
-
-void st7735::wrdata16(int data)
+void st7735::wrwin(uint8_t cmd, uint16_t a1, uint16_t a2)
 {
-    int data1 = data >> 8;
-    int data2 = data & 0xff;
-
-    dc_set();
-    spi_lcdout(data1);
-    spi_lcdout(data2);
+  wrcmd(cmd);
+  wrdata(a1 >> 8);
+  spi_lcdout(a1);
+  spi_lcdout(a2 >> 8);
+  spi_lcdout(a2);
 }
-    
-/* ----------------------------------------------------------
-     st7735::set_ram_address
 
-     legt den Zeichenbereich des Displays fest
+/* ----------------------------------------------------------
+     st7735::setrotation
+
+     programmiert MADCTL (0x36) fuer die in "outmode"
+     angegebene Drehung und fuer _mirror. Der Controller
+     setzt damit Fenster in jeder Lage selbst um, fuer jede
+     Achse bleibt nur eine Verschiebung (_xofs, _yofs) der
+     Adressen durch colofs, rowofs und den Offset der
+     Displays mit 128 Zeilen.
+
+     Wird eine Achse gegenueber der Lage nach init (MX, MY
+     gesetzt) gespiegelt, gilt fuer sie der Offset vom
+     anderen Ende des Displayrams: die Zeilen des Displayrams
+     (_ramh) abzueglich der sichtbaren Zeilen und des eigenen
+     Offsets. Bei 128 Zeilen und 160 Zeilen Displayram sind
+     das 32 (ofsmode(-32)) bzw. 0 (ofsmode(0)).
    ---------------------------------------------------------- */
-void st7735::set_ram_address (uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+void st7735::setrotation()
 {
-  wrcmd(coladdr);
-  wrdata((x1) >> 8);
-  wrdata(x1 + colofs);
-  wrdata((x2) >> 8);
-  wrdata(x2 + colofs);
-
-  wrcmd(rowaddr);
-  if (_yres == 128)
+  uint8_t madctl, mode, uinc, vinc;
+  int     co, ro, fco, fro, xo, yo, um;
+
+  mode= outmode & 3;
+  co= colofs;
+  ro= rowofs;
+  if (_yres == 128) ro += 32+_lcyofs;
+  fco= co;
+  fro= _ramh - _yres - ro;
+
+  // Lage wie bisher durch putpixel: Displayspalte u, Displayzeile v
+  //   0 : u= x,         v= y
+  //   1 : u= y,         v= yres-1-x
+  //   2 : u= xres-1-y,  v= x
+  //   3 : u= xres-1-x,  v= yres-1-y
+
+  uinc= (mode < 2);                             // u waechst mit x bzw. y
+  vinc= !(mode & 1);                            // v waechst mit y bzw. x
+
+  madctl= (_colfolge == _RGB) ? 0x08 : 0x00;
+  if (_mirror == 1)                             // Displayspalte u wird zu xres-u, sichtbar
+  {                                             // sind damit die Koordinaten 1..xres (bzw.
+    if (!uinc) madctl |= 0x40;                  // -1..xres-2)
+    xo= uinc ? fco-1 : co+1;
+    um= uinc ? 1 : -1;
+  }
+  else
   {
-     wrdata(0x00 + rowofs);
-     wrdata(y1+32+_lcyofs + rowofs);
-     y2 += 32;					// Dummy um Warning85 zu verhindern
-  }    
+    if (uinc) madctl |= 0x40;                   // MX
+    xo= uinc ? co : fco;
+    um= 0;
+  }
+  if (vinc) madctl |= 0x80;                     // MY
+  yo= vinc ? ro : fro;
+
+  if ((mode == 1) || (mode == 2))               // MV: Zeilen / Spalten getauscht
+  {
+    madctl |= 0x20;
+    _xofs= yo; _yofs= xo;
+    _xmin= 0;  _ymin= um;
+    _width= _yres; _height= _xres;
+  }
   else
   {
-    wrdata((y1 >> 8) + rowofs);
-    wrdata(y1);
-    wrdata((y2 >> 8) + rowofs);
-    wrdata(y2);
+    _xofs= xo; _yofs= yo;
+    _xmin= um; _ymin= 0;
+    _width= _xres; _height= _yres;
   }
+  _actmode= outmode;
 
-  wrcmd(writereg);
+  wrcmd(0x36);
+  wrdata(madctl);
 }
 
 /* ----------------------------------------------------------
-     st7735::clrscr
-
-     loescht den Displayinhalt mit der in der Variable
-     "bkcolor" angegebenen Farbe
-   ---------------------------------------------------------- */
+     st7735::set_ram_address
 
-void st7735::clrscr()
-{
-  int      x,y;
-  uint8_t  colouthi, coloutlo;
+     legt den Zeichenbereich (Fenster) des Displays fest,
+     nachfolgende Farbwerte (push_pixels, push_buffer)
+     werden zeilenweise von x1,y1 bis x2,y2 in das Fenster
+     geschrieben. DC steht danach auf Daten.
 
-  set_ram_address(0,0,_xres-1,_yres-1);
+     Die Koordinaten gelten in der Lage "outmode", das
+     Fenster muss auf dem Display liegen.
 
-  colouthi = bkcolor >> 8;
-  coloutlo = bkcolor & 0xff;
+       x1,y1 : linke obere Ecke
+       x2,y2 : rechte untere Ecke
+   ---------------------------------------------------------- */
+void st7735::set_ram_address (uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
+{
+  if (outmode != _actmode) setrotation();
 
+  wrwin(coladdr, x1 + _xofs, x2 + _xofs);
+  wrwin(rowaddr, y1 + _yofs, y2 + _yofs);
+  wrcmd(writereg);
+  spi_wait();
   dc_set();
-
-  for (y= 0; y< _yres; y++)
-  {
-    for (x= 0; x< _xres; x++)
-    {
-      wrdata(colouthi);
-      wrdata(coloutlo);
-    }
-  }
-
 }
 
 /* ----------------------------------------------------------
-     st7735::setcol
+     st7735::clipwin
 
-     schreibt einen Farbpunkt ins Display-Ram
+     schneidet das Rechteck x1,y1 .. x2,y2 (x1 <= x2,
+     y1 <= y2) am Displayrand (_xmin .. _xmin+_width-1,
+     _ymin .. _ymin+_height-1) ab
 
-       coladdr  : Adresse im Display-Ram
+     Rueckgabe: 0 = Rechteck liegt ausserhalb
    ---------------------------------------------------------- */
-void st7735::setcol(int startcol)
+uint8_t st7735::clipwin(int *x1, int *y1, int *x2, int *y2)
 {
-    wrcmd(coladdr);
-    wrdata16(startcol + colofs);
+  if (outmode != _actmode) setrotation();
+
+  if (*x1 < _xmin) *x1= _xmin;
+  if (*y1 < _ymin) *y1= _ymin;
+  if (*x2 > _xmin+(int)_width-1) *x2= _xmin+_width-1;
+  if (*y2 > _ymin+(int)_height-1) *y2= _ymin+_height-1;
+  return (*x1 <= *x2) && (*y1 <= *y2);
 }
 
 /* ----------------------------------------------------------
-     st7735::setpage
+     st7735::fillwindow
+
+     fuellt das Rechteck x1,y1 .. x2,y2 mit einer Farbe. Das
+     Rechteck wird am Displayrand abgeschnitten, anschliessend
+     wird das Fenster einmal gesetzt und alle Pixel am Stueck
+     gesendet.
+
+       x1,y1 : eine Ecke des Rechtecks
+       x2,y2 : gegenueberliegende Ecke
+       color : RGB565 Farbwert
    ---------------------------------------------------------- */
-void st7735::setpage(int startpage)
+void st7735::fillwindow(int x1, int y1, int x2, int y2, uint16_t color)
 {
-    wrcmd(rowaddr);
-    wrdata16(startpage + rowofs);
+  int tmp;
+
+  if (x1 > x2) { tmp= x1; x1= x2; x2= tmp; }
+  if (y1 > y2) { tmp= y1; y1= y2; y2= tmp; }
+  if (!clipwin(&x1, &y1, &x2, &y2)) return;
+
+  set_ram_address(x1, y1, x2, y2);
+  push_pixels(color, (uint16_t)(x2-x1+1) * (uint16_t)(y2-y1+1));
 }
 
 /* ----------------------------------------------------------
-     st7735::setxypos
-
-     waehlt die Position im Display-Ram aus, auf die der
-     naechste Datentransfer erfolgen wird
+     st7735::clrscr
 
-       x,y : fuer diese Koordinaten wird die Speicheradresse
-             im Display-Ram berechnet
+     loescht den Displayinhalt mit der in der Variable
+     "bkcolor" angegebenen Farbe
    ---------------------------------------------------------- */
-void st7735::setxypos(int x, int y)
-{
-      if (_mirror == 1)
-      {
-        setcol(_xres-x);
-      }
-      else
-      {
-        setcol(x);
-      }
 
-      if ( _yres == 128 )
-      {
-        setpage(y+32+_lcyofs);
-      }  
-      else
-      {
-        setpage(y);
-      }
-
-    wrcmd(writereg);
+void st7735::clrscr()
+{
+  if (outmode != _actmode) setrotation();
+  fillwindow(_xmin, _ymin, _xmin+_width-1, _ymin+_height-1, bkcolor);
 }
 
 /* ----------------------------------------------------------
@@ -317,9 +357,9 @@ void st7735::setxypos(int x, int y)
      zeichnet einen einzelnen Punkt auf dem Display an der
      Koordinate x,y mit der Farbe color.
 
-     Putpixel beruecksichtigt die globale Variable "outmode"
-     mithilfe derer es moeglich ist, eine Ausgabe auf dem
-     Display zu "drehen"
+     Die Drehung durch "outmode" uebernimmt der Controller
+     (setrotation), Punkte ausserhalb des Displays werden
+     nicht gezeichnet
 
        x,y   : Koordinaten, an die ein Farbpixel gezeichnet
                wird
@@ -327,35 +367,144 @@ void st7735::setxypos(int x, int y)
    ---------------------------------------------------------- */
 void st7735::putpixel(int x, int y,uint16_t color)
 {
-  switch (outmode)
-  {
-    case 0  :  setxypos(x,y); break;
-    case 1  :  setxypos(y,_yres-1-x); break;
-    case 2  :  setxypos(_xres-1-y,x); break;
-    case 3  :  setxypos(_xres-1-x, _yres-1-y); break;
-  
-    default : break;
-  
-  }
-  
-  wrdata16(color);
+  int x2, y2;
+
+  x2= x; y2= y;
+  if (!clipwin(&x, &y, &x2, &y2)) return;
+
+  set_ram_address(x, y, x, y);
+  push_pixels(color, 1);
 }
 
 /* -------------------------------------------------------------
-     st7735::putpixeltx
+     st7735::txmap
 
-     Pixelausgabe, von den putchar Funktionen benutzt, damit
-     fuer outtextxy die Ausgaberichtung vorgegeben werden
-     kann
+     Drehung einer Koordinate der Textausgabe durch
+     "txoutmode"
 
-        x,y   : Koordinaten an der der Punkt gezeichnet
-                werden soll
-        color : 16 - Bit RGB565 Farbwert der gezeichnet
-                werden soll
+        x,y   : Koordinate, wird durch die gedrehte ersetzt
    ------------------------------------------------------------- */
-void st7735::putpixeltx(int x, int y, uint16_t color)
+void st7735::txmap(int *x, int *y)
 {
-  if (txoutmode) putpixel(_xres-1-y,x,color); else putpixel(x,y,color);
+  int tx;
+
+  if (txoutmode)
+  {
+    tx= *x;
+    *x= _xres-1-*y;
+    *y= tx;
+  }
+}
+
+/* -------------------------------------------------------------
+     st7735::putglyph
+
+     gibt eine Glyphe (max. 16x16 Punkte) als ein Fenster im
+     Display-Ram aus. Die Glyphe wird zuerst in die Lage auf
+     dem Display (txoutmode, outmode, _mirror) umgesetzt, bei
+     fntfilled werden danach alle Punkte der Zelle zeilenweise
+     in Vorder- bzw. Hintergrundfarbe gesendet. Ohne fntfilled
+     wird jede zusammenhaengende Reihe gesetzter Punkte einer
+     Zeile als eigenes Fenster gefuellt. Punkte ausserhalb
+     des Displays werden abgeschnitten.
+
+        x,y   : Koordinate der linken oberen Ecke
+        g     : Zeilen der Glyphe, MSB = linker Punkt
+        w,h   : Breite, Hoehe der Glyphe
+        sc    : Vergroesserung (1 = Originalgroesse)
+   ------------------------------------------------------------- */
+void st7735::putglyph(int x, int y, uint16_t *g, uint8_t w, uint8_t h, uint8_t sc)
+{
+  uint16_t t[16];
+  uint16_t bits, mask, color;
+  int      x0, y0, x1, y1, x2, y2;
+  int      cx1, cy1, cx2, cy2;
+  int      px, py, ye;
+  uint8_t  swap, fx, fy, pw, ph;
+  uint8_t  r, c, c1, u, v, rs, cs, c0, cs0;
+
+  // Lage der Glyphe: Ursprung und Richtung der Glyphenachsen auf dem Display
+
+  x0= x;   y0= y;   txmap(&x0, &y0);
+  x1= x+1; y1= y;   txmap(&x1, &y1);
+  x2= x;   y2= y+1; txmap(&x2, &y2);
+
+  swap= (x1 == x0);                         // Glyphenzeilen verlaufen senkrecht
+  if (swap) { fx= (x2 < x0); fy= (y1 < y0); pw= h; ph= w; }
+       else { fx= (x1 < x0); fy= (y2 < y0); pw= w; ph= h; }
+
+  // Glyphe in Displaylage umsetzen: t[Displayzeile], MSB = linker Punkt
+
+  for (r= 0; r< ph; r++)
+  {
+    v= fy ? ph-1-r : r;
+    if (!swap && !fx)
+    {
+      t[r]= g[v];
+    }
+    else
+    {
+      t[r]= 0;
+      for (c= 0; c< pw; c++)
+      {
+        u= fx ? pw-1-c : c;
+        if (swap) bits= g[u] & (0x8000 >> v);
+             else bits= g[v] & (0x8000 >> u);
+        if (bits) t[r] |= 0x8000 >> c;
+      }
+    }
+  }
+
+  // Zelle auf dem Display (x0,y0 = linke obere Ecke), am Rand abschneiden
+
+  if (fx) x0 -= pw*sc-1;
+  if (fy) y0 -= ph*sc-1;
+
+  cx1= x0; cx2= x0+pw*sc-1;
+  cy1= y0; cy2= y0+ph*sc-1;
+  if (!clipwin(&cx1, &cy1, &cx2, &cy2)) return;
+
+  c0= (cx1-x0) / sc; cs0= (cx1-x0) % sc;
+  r = (cy1-y0) / sc; rs = (cy1-y0) % sc;
+
+  if (fntfilled)
+  {
+    set_ram_address(cx1, cy1, cx2, cy2);
+    for (py= cy1; py<= cy2; py++)
+    {
+      bits= t[r]; mask= 0x8000 >> c0; cs= cs0;
+      for (px= cx1; px<= cx2; px++)
+      {
+        color= (bits & mask) ? textcolor : bkcolor;     // laeuft parallel zum letzten Byte
+        spi_lcdout(color >> 8);
+        spi_lcdout(color);
+        if (++cs == sc) { cs= 0; mask >>= 1; }
+      }
+      if (++rs == sc) { rs= 0; r++; }
+    }
+    return;
+  }
+
+  for (py= cy1; py<= cy2; py= ye+1, r++)    // je Glyphenzeile (sc Displayzeilen)
+  {
+    ye= y0 + (r+1)*sc - 1;
+    if (ye > cy2) ye= cy2;
+    bits= t[r];
+    c= 0;
+    while (c < pw)
+    {
+      if (!(bits & (0x8000 >> c))) { c++; continue; }
+      c1= c;
+      while ((c < pw) && (bits & (0x8000 >> c))) c++;
+      x1= x0 + c1*sc; if (x1 < cx1) x1= cx1;
+      x2= x0 + c*sc-1; if (x2 > cx2) x2= cx2;
+      if (x1 <= x2)
+      {
+        set_ram_address(x1, py, x2, ye);
+        push_pixels(textcolor, (x2-x1+1) * (ye-py+1));
+      }
+    }
+  }
 }
 
 /* --------------------------------------------------
@@ -411,9 +560,12 @@ void st7735::init(uint16_t xres, uint16_t yres, uint8_t mirror, uint8_t colfolge
   const uint8_t *tabseq;
 
   _xres= xres; _yres= yres; _mirror= mirror;
+  _colfolge= colfolge; _actmode= 0xff;
 
-  spi_init();
   lcd_pin_init();
+  lcd_disable();
+  spi_init();
+  lcd_enable();
 
   rst_clr();                            // Resets LCD controler
   delay(2);
@@ -457,7 +609,6 @@ void st7735::init(uint16_t xres, uint16_t yres, uint8_t mirror, uint8_t colfolge
       for (i= 0; i< ms; i++) delay(1);             // und entsprechend "nichts" tun
     }
   }
-  ce_clr();
   bkcolor= 0;
   clrscr();
 }
@@ -478,6 +629,58 @@ void st7735::gotoxy(unsigned char x, unsigned char y)
   aktyp= y*(fontsizey+(textsize*fontsizey));
 }
 
+/* --------------------------------------------------
+     st7735::getglyph
+
+     liest das Zeichen ch eines Fonts aus dem Flash
+     in Zeilen: g[0] = oberste Zeile, MSB = linker
+     Punkt (5x7: 7, 8x8: 8, 12x16: 16 Zeilen)
+
+     Parameter:
+        fnt :   FNT8x8, FNT12x16 oder FNT5x7
+        ch  :   Zeichen
+        g   :   Puffer fuer die Zeilen
+   -------------------------------------------------- */
+void st7735::getglyph(uint8_t fnt, unsigned char ch, uint16_t *g)
+{
+  uint8_t x, y, v;
+
+  ch -= 32;
+  switch (fnt)
+  {
+    case FNT5x7:
+    {
+      for (y= 0; y< 7; y++) g[y]= 0;
+      for (x= 0; x< 5; x++)                             // Font ist spaltenweise abgelegt
+      {
+        v= pgm_read_byte(&(font5x7[ch][x]));
+        for (y= 0; y< 7; y++)
+        {
+          if (v & (1 << y)) g[y] |= 0x8000 >> x;
+        }
+      }
+      break;
+    }
+    case FNT12x16:
+    {
+      for (y= 0; y< 16; y++)
+      {
+        g[y]= pgm_read_byte(&(font12x16[ch][y*2])) << 4;
+        g[y]|= pgm_read_byte(&(font12x16[ch][(y*2)+1])) << 12;
+      }
+      break;
+    }
+    default:
+    {
+      for (y= 0; y< 8; y++)
+      {
+        g[y]= pgm_read_byte(&(font8x8[ch][y])) << 8;
+      }
+      break;
+    }
+  }
+}
+
 /* --------------------------------------------------
      lcd_putchar5x7
 
@@ -489,7 +692,7 @@ void st7735::gotoxy(unsigned char x, unsigned char y)
    -------------------------------------------------- */
 void st7735::putchar5x7(unsigned char ch)
 {
-  uint8_t x,y,v;
+  uint16_t g[7];
 
   if (ch== 13)                                          // Fuer <printf> "/r" Implementation
   {
@@ -502,24 +705,8 @@ void st7735::putchar5x7(unsigned char ch)
     return;
   }
 
-  for (x= 0; x< 5; x++)
-  {
-    v= pgm_read_byte(&(font5x7[(ch-32)][x]));
-    for (y= 0; y< 7; y++)
-    {
-      if (v & (1 << y)) 
-      {
-        putpixeltx(aktxp+x, aktyp+y-1, textcolor);
-      }
-      else
-      {
-        if (fntfilled)
-        {
-          putpixeltx(aktxp+x, aktyp+y-1, bkcolor);
-        }        
-      }  
-    }
-  }
+  getglyph(FNT5x7, ch, g);
+  putglyph(aktxp, aktyp-1, g, 5, 7, 1);
   aktxp= aktxp+fontsizex+1;
 }
 
@@ -534,11 +721,7 @@ void st7735::putchar5x7(unsigned char ch)
    -------------------------------------------------- */
 void st7735::putchar8x8(unsigned char ch)
 {
-  uint8_t   i,i2;
-  uint8_t   b;
-  int       oldx,oldy;
-  uint16_t  fontint;
-  uint16_t  fmask;
+  uint16_t  g[8];
 
   if (ch== 13)                                          // Fuer <printf> "/r" Implementation
   {
@@ -551,47 +734,8 @@ void st7735::putchar8x8(unsigned char ch)
     return;
   }
 
-  fmask= 1<<(fontsizex-1);
-
-  oldx= aktxp;
-  oldy= aktyp;
-  for (i=0; i<fontsizey; i++)
-  {
-    b= pgm_read_byte(&(font8x8[(ch-32)][i]));
-    fontint= b;
-
-    for (i2= 0; i2<fontsizex; i2++)
-    {
-      if (fmask & fontint)
-      {
-        putpixeltx(oldx,oldy,textcolor);
-        if ((textsize==1))
-        {
-          putpixeltx(oldx+1,oldy,textcolor);
-          putpixeltx(oldx,oldy+1,textcolor);
-          putpixeltx(oldx+1,oldy+1,textcolor);
-        }
-      }
-      else
-      {
-        if (fntfilled)
-        {
-          putpixeltx(oldx,oldy,bkcolor);
-          if ((textsize==1))
-          {
-            putpixeltx(oldx+1,oldy,bkcolor);
-            putpixeltx(oldx,oldy+1,bkcolor);
-            putpixeltx(oldx+1,oldy+1,bkcolor);
-          }
-        }
-      }
-      fontint= fontint<<1;
-      oldx= oldx+1+textsize;
-    }
-    oldy++;
-    if ((textsize==1)) {oldy++; }
-    oldx= aktxp;
-  }
+  getglyph(FNT8x8, ch, g);
+  putglyph(aktxp, aktyp, g, 8, 8, textsize+1);
   aktxp= aktxp+fontsizex+(fontsizex*textsize);
 }
 
@@ -606,12 +750,7 @@ void st7735::putchar8x8(unsigned char ch)
    -------------------------------------------------- */
 void st7735::putchar12x16(unsigned char ch)
 {
-  uint8_t   i,i2;
-  uint16_t  b;
-  int       oldx,oldy;
-  uint16_t  fontint;
-  uint16_t  fmask;
-  uint16_t  findex;
+  uint16_t  g[16];
 
   if (ch== 13)                                          // Fuer <printf> "/r" Implementation
   {
@@ -624,51 +763,9 @@ void st7735::putchar12x16(unsigned char ch)
     return;
   }
 
-  fmask= 1<<(16-1);
-  oldx= aktxp;
-  oldy= aktyp;
-  for (i=0; i<16; i++)
-  {
-    findex= (ch-32);
-
-    b= pgm_read_byte(&(font12x16[findex][i*2])) << 4;
-    b|= pgm_read_byte(&(font12x16[findex][(i*2)+1])) << 12;
-
-    fontint= b;
-
-    for (i2= 0; i2<12; i2++)
-    {
-      if (fmask & fontint)
-      {
-        putpixeltx(oldx,oldy,textcolor);
-        if ((textsize==1))
-        {
-          putpixeltx(oldx+1,oldy,textcolor);
-          putpixeltx(oldx,oldy+1,textcolor);
-          putpixeltx(oldx+1,oldy+1,textcolor);
-        }
-      }
-      else
-      {
-        if (fntfilled)
-        {
-          putpixeltx(oldx,oldy,bkcolor);
-          if ((textsize==1))
-          {
-            putpixeltx(oldx+1,oldy,bkcolor);
-            putpixeltx(oldx,oldy+1,bkcolor);
-            putpixeltx(oldx+1,oldy+1,bkcolor);
-          }
-        }
-      }
-      fontint= fontint<<1;
-      oldx= oldx+1+textsize;
-    }
-    oldy++;
-    if ((textsize==1)) {oldy++; }
-    oldx= aktxp;
-  }
-  if (textsize==1) aktxp= aktxp + 24; else aktxp = aktxp +12;
+  getglyph(FNT12x16, ch, g);
+  putglyph(aktxp, aktyp, g, 12, 16, textsize+1);
+  aktxp= aktxp+12+(12*textsize);
 }
 
 /* --------------------------------------------------
@@ -779,15 +876,7 @@ void st7735::line(int x0, int y0, int x1, int y1, uint16_t color)
    ---------------------------------------------------------- */
 void st7735::fastxline(uint8_t x1, uint8_t y1, uint8_t x2, uint16_t color)
 {
-  uint8_t x;
-
-  if (x2< x1) { x= x1; x1= x2; x= x2= x; }
-
-  for (x= x1; x< (x2+1); x++)
-  {
-    putpixel(x,y1, color);
-  }
-
+  fillwindow(x1, y1, x2, y1, color);
 }
 
 /* ----------------------------------------------------------
@@ -803,19 +892,7 @@ void st7735::fastxline(uint8_t x1, uint8_t y1, uint8_t x2, uint16_t color)
    ---------------------------------------------------------- */
 void st7735::fillrect(int x1, int y1, int x2, int y2, uint16_t color)
 {
-  int y;
-
-  if (y1> y2)
-  {
-    y= y1;
-    y1= y2;
-    y2= y;
-  }
-
-  for (y= y1; y< y2+1; y++)
-  {
-    fastxline(x1,y,x2,color);
-  }
+  fillwindow(x1, y1, x2, y2, color);
 }
 
 /* -------------------------------------------------------------
@@ -914,23 +991,28 @@ void st7735::fillellipse(int xm, int ym, int a, int b, uint16_t color )
   // Algorithmus nach Bresenham (www.wikipedia.org)
 
   int dx = 0, dy = b;                       // im I. Quadranten von links oben nach rechts unten
+  int xs, ys;
   long a2 = a*a, b2 = b*b;
   long err = b2-(2*b-1)*a2, e2;             // Fehler im 1. Schritt */
 
   do
   {
-    fastxline(xm+dx, ym+dy,xm-dx, color);            // I. und II.   Quadrant
-    fastxline(xm-dx, ym-dy,xm+dx, color);            // III. und IV. Quadrant
+    xs= dx; ys= dy;
 
     e2 = 2*err;
     if (e2 <  (2*dx+1)*b2) { dx++; err += (2*dx+1)*b2; }
     if (e2 > -(2*dy-1)*a2) { dy--; err -= (2*dy-1)*a2; }
+
+    if (dy != ys)                           // letzter (breitester) Punkt dieser Zeile:
+    {                                       // Zeile einmal als Fenster fuellen
+      fillwindow(xm-xs, ym+ys, xm+xs, ym+ys, color);              // I. und II.   Quadrant
+      if (ys) fillwindow(xm-xs, ym-ys, xm+xs, ym-ys, color);      // III. und IV. Quadrant
+    }
   } while (dy >= 0);
 
-  while (dx++ < a)                        // fehlerhafter Abbruch bei flachen Ellipsen (b=1)
+  if (dx < a)                               // fehlerhafter Abbruch bei flachen Ellipsen (b=1)
   {
-    putpixel(xm+dx, ym,color);             // -> Spitze der Ellipse vollenden
-    putpixel(xm-dx, ym,color);
+    fillwindow(xm-a, ym, xm+a, ym, color);  // -> Spitze der Ellipse vollenden
   }
 }
 
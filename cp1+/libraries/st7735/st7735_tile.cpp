@@ -0,0 +1,546 @@
+/* ---------------------------------------------------------------------------
+                               st7735_tile.cpp
+
+     Kachelweise Ausgabe fuer st7735 (optional), siehe st7735_tile.h
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <string.h>
+#include "st7735_tile.h"
+
+#define sig_seed        5381            // Startwert der Pruefsumme einer Kachel
+
+/* --------------------------------------------------
+     sigadd
+
+     nimmt einen 16-Bit Wert in die Pruefsumme h
+     auf (h * 33 + Byte, je Byte)
+   -------------------------------------------------- */
+static uint16_t sigadd(uint16_t h, uint16_t v)
+{
+  h= (h << 5) + h + (v & 0xff);
+  return (h << 5) + h + (v >> 8);
+}
+
+st7735tile::st7735tile(st7735 *dev)
+{
+  _dev= dev;
+  _cols= 0; _rows= 0;
+  _cnt= 0; _keep= 0;
+  _full= 1;
+}
+
+/* -------------------------------------------------------------
+     st7735tile::area
+
+     legt den Ausgabebereich fest. Die Kacheln beginnen an der
+     linken oberen Ecke, am rechten und unteren Rand koennen sie
+     schmaler sein. Das naechste render gibt alle Kacheln aus.
+
+        x1,y1 : linke obere Ecke
+        x2,y2 : rechte untere Ecke
+
+     Rueckgabe: 0 = mehr als tile_maxtiles Kacheln, der Bereich
+                    bleibt unveraendert
+   ------------------------------------------------------------- */
+uint8_t st7735tile::area(int x1, int y1, int x2, int y2)
+{
+  int tmp;
+  int cols, rows;
+
+  if (x1 > x2) { tmp= x1; x1= x2; x2= tmp; }
+  if (y1 > y2) { tmp= y1; y1= y2; y2= tmp; }
+
+  cols= (x2-x1+tile_w) / tile_w;
+  rows= (y2-y1+tile_h) / tile_h;
+  if (cols * rows > tile_maxtiles) return 0;
+
+  _ax1= x1; _ay1= y1; _ax2= x2; _ay2= y2;
+  _cols= cols; _rows= rows;
+  _full= 1;
+  return 1;
+}
+
+/* --------------------------------------------------
+     st7735tile::keep
+
+     die bisher eingetragenen Objekte (z.B. ein fester
+     Hintergrund) bleiben bei clear erhalten
+   -------------------------------------------------- */
+void st7735tile::keep()
+{
+  _keep= _cnt;
+}
+
+/* --------------------------------------------------
+     st7735tile::clear
+
+     beginnt ein neues Bild: loescht alle Objekte der
+     Displayliste ausser den mit keep festgehaltenen
+   -------------------------------------------------- */
+void st7735tile::clear()
+{
+  _cnt= _keep;
+  lost= 0;
+}
+
+/* --------------------------------------------------
+     st7735tile::reset
+
+     loescht die gesamte Displayliste
+   -------------------------------------------------- */
+void st7735tile::reset()
+{
+  _keep= 0;
+  clear();
+}
+
+/* --------------------------------------------------
+     st7735tile::invalidate
+
+     das naechste render gibt alle Kacheln aus (z.B.
+     nachdem direkt auf das Display gezeichnet wurde)
+   -------------------------------------------------- */
+void st7735tile::invalidate()
+{
+  _full= 1;
+}
+
+/* -------------------------------------------------------------
+     st7735tile::add
+
+     traegt ein Objekt in die Displayliste ein. Objekte ganz
+     ausserhalb des Bereichs werden verworfen, ist die Liste
+     voll, wird lost erhoeht.
+   ------------------------------------------------------------- */
+void st7735tile::add(tileobj *o)
+{
+  int x1, y1, x2, y2;
+
+  objbox(o, &x1, &y1, &x2, &y2);
+  if ((x2 < _ax1) || (x1 > _ax2) || (y2 < _ay1) || (y1 > _ay2)) return;
+
+  if (_cnt == tile_maxobj)
+  {
+    lost++;
+    return;
+  }
+  _obj[_cnt++]= *o;
+}
+
+/* -------------------------------------------------------------
+     st7735tile::objbox
+
+     umschliessendes Rechteck eines Objekts
+   ------------------------------------------------------------- */
+void st7735tile::objbox(tileobj *o, int *x1, int *y1, int *x2, int *y2)
+{
+  switch (o->typ)
+  {
+    case tobj_line:
+    {
+      if (o->x1 < o->x2) { *x1= o->x1; *x2= o->x2; }
+                    else { *x1= o->x2; *x2= o->x1; }
+      if (o->y1 < o->y2) { *y1= o->y1; *y2= o->y2; }
+                    else { *y1= o->y2; *y2= o->y1; }
+      break;
+    }
+    case tobj_ellipse:
+    case tobj_fillellipse:
+    {
+      *x1= o->x1 - o->x2; *x2= o->x1 + o->x2;
+      *y1= o->y1 - o->y2; *y2= o->y1 + o->y2;
+      break;
+    }
+    default:                                // Rechteck, Text, Bitmap
+    {
+      *x1= o->x1; *y1= o->y1;
+      *x2= o->x2; *y2= o->y2;
+      break;
+    }
+  }
+}
+
+/* -------------------------------------------------------------
+     st7735tile::objsig
+
+     nimmt ein Objekt in die Pruefsumme h einer Kachel auf.
+     Bei Texten geht der Inhalt ein, nicht die Adresse.
+   ------------------------------------------------------------- */
+uint16_t st7735tile::objsig(uint16_t h, tileobj *o)
+{
+  const char *s;
+
+  h= sigadd(h, o->typ | (o->fnt << 8));
+  h= sigadd(h, o->x1);
+  h= sigadd(h, o->y1);
+  h= sigadd(h, o->x2);
+  h= sigadd(h, o->y2);
+  h= sigadd(h, o->color);
+  if (o->typ == tobj_text)
+  {
+    for (s= (const char *)o->p; *s; s++) h= sigadd(h, *s);
+  }
+  if (o->typ == tobj_bitmap) h= sigadd(h, (uint16_t)(uintptr_t)o->p);
+  return h;
+}
+
+/* -------------------------------------------------------------
+     st7735tile::render
+
+     setzt alle Kacheln zusammen, deren Pruefsumme sich seit
+     dem letzten render geaendert hat, und gibt sie je als ein
+     Fenster auf dem Display aus. Eine Aenderung, die zufaellig
+     dieselbe 16-Bit Pruefsumme ergibt, wird nicht erkannt
+     (siehe st7735_tile.h, invalidate).
+
+     Die Objekte einer Kachel werden fuer die Pruefsumme und
+     fuers Zeichnen je einmal gesucht, eine Liste auf dem Stack
+     ist so nicht noetig.
+
+     Rueckgabe: Anzahl ausgegebener Kacheln
+   ------------------------------------------------------------- */
+uint8_t st7735tile::render()
+{
+  uint8_t  c, r, i, t, n;
+  uint16_t h, anz;
+  int      x1, y1, x2, y2;
+  tileobj  *o;
+
+  n= 0; t= 0;
+  for (r= 0; r< _rows; r++)
+  {
+    for (c= 0; c< _cols; c++, t++)
+    {
+      _tx1= _ax1 + c*tile_w; _tx2= _tx1 + tile_w-1;
+      _ty1= _ay1 + r*tile_h; _ty2= _ty1 + tile_h-1;
+      if (_tx2 > _ax2) _tx2= _ax2;
+      if (_ty2 > _ay2) _ty2= _ay2;
+
+      // Objekte, die die Kachel beruehren, und deren Pruefsumme
+
+      h= sigadd(sig_seed, bkcolor);
+      for (i= 0; i< _cnt; i++)
+      {
+        objbox(&_obj[i], &x1, &y1, &x2, &y2);
+        if ((x2 < _tx1) || (x1 > _tx2) || (y2 < _ty1) || (y1 > _ty2)) continue;
+        h= objsig(h, &_obj[i]);
+      }
+      if (!_full && (h == _sig[t])) continue;
+      _sig[t]= h;
+
+      // Kachel im Puffer zusammensetzen
+
+      _tw= _tx2-_tx1+1;
+      anz= _tw * (_ty2-_ty1+1);
+      for (y1= _ty1; y1<= _ty2; y1++) hspan(_tx1, _tx2, y1, bkcolor);
+
+      for (i= 0; i< _cnt; i++)
+      {
+        o= &_obj[i];
+        objbox(o, &x1, &y1, &x2, &y2);
+        if ((x2 < _tx1) || (x1 > _tx2) || (y2 < _ty1) || (y1 > _ty2)) continue;
+        switch (o->typ)
+        {
+          case tobj_line        : drawline(o); break;
+          case tobj_rect        :
+          {
+            hspan(o->x1, o->x2, o->y1, o->color);
+            hspan(o->x1, o->x2, o->y2, o->color);
+            for (y1= o->y1; y1<= o->y2; y1++)
+            {
+              pixel(o->x1, y1, o->color);
+              pixel(o->x2, y1, o->color);
+            }
+            break;
+          }
+          case tobj_fillrect    :
+          {
+            for (y1= o->y1; y1<= o->y2; y1++) hspan(o->x1, o->x2, y1, o->color);
+            break;
+          }
+          case tobj_ellipse     : drawellipse(o); break;
+          case tobj_fillellipse : drawfillellipse(o); break;
+          case tobj_text        : drawtext(o); break;
+          case tobj_bitmap      : drawbitmap(o); break;
+          default               : break;
+        }
+      }
+
+      _dev->set_ram_address(_tx1, _ty1, _tx2, _ty2);
+      _dev->push_buffer(_buf, anz);
+      n++;
+    }
+  }
+  _full= 0;
+  return n;
+}
+
+/* -------------------------------------------------------------
+     st7735tile::pixel, hspan
+
+     setzen einen Punkt bzw. eine waagerechte Linie im Kachel-
+     puffer, Punkte ausserhalb der Kachel werden abgeschnitten
+   ------------------------------------------------------------- */
+void st7735tile::pixel(int x, int y, uint16_t color)
+{
+  if ((x < _tx1) || (x > _tx2) || (y < _ty1) || (y > _ty2)) return;
+  _buf[(y-_ty1)*_tw + (x-_tx1)]= color;
+}
+
+void st7735tile::hspan(int x1, int x2, int y, uint16_t color)
+{
+  uint16_t *p;
+
+  if ((y < _ty1) || (y > _ty2)) return;
+  if (x1 < _tx1) x1= _tx1;
+  if (x2 > _tx2) x2= _tx2;
+  if (x1 > x2) return;
+  p= &_buf[(y-_ty1)*_tw + (x1-_tx1)];
+  for (; x1<= x2; x1++) *p++= color;
+}
+
+/* -------------------------------------------------------------
+     st7735tile::drawline, drawellipse, drawfillellipse
+
+     rastern die Objekte mit denselben Algorithmen wie
+     st7735::line, ::ellipse und ::fillellipse in die Kachel,
+     die Punkte stimmen mit der direkten Ausgabe ueberein
+   ------------------------------------------------------------- */
+void st7735tile::drawline(tileobj *o)
+{
+  int x0= o->x1, y0= o->y1, x1= o->x2, y1= o->y2;
+  int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1;
+  int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1;
+  int err = dx+dy, e2;
+
+  for(;;)
+  {
+    pixel(x0, y0, o->color);
+    if (x0==x1 && y0==y1) break;
+    e2 = 2*err;
+    if (e2 > dy) { err += dy; x0 += sx; }
+    if (e2 < dx) { err += dx; y0 += sy; }
+  }
+}
+
+void st7735tile::drawellipse(tileobj *o)
+{
+  int  xm= o->x1, ym= o->y1, a= o->x2, b= o->y2;
+  int  dx = 0, dy = b;
+  long a2 = (long)a*a, b2 = (long)b*b;
+  long err = b2-(2*b-1)*a2, e2;
+
+  do
+  {
+    pixel(xm+dx, ym+dy, o->color);
+    pixel(xm-dx, ym+dy, o->color);
+    pixel(xm-dx, ym-dy, o->color);
+    pixel(xm+dx, ym-dy, o->color);
+
+    e2 = 2*err;
+    if (e2 <  (2*dx+1)*b2) { dx++; err += (2*dx+1)*b2; }
+    if (e2 > -(2*dy-1)*a2) { dy--; err -= (2*dy-1)*a2; }
+  } while (dy >= 0);
+
+  while (dx++ < a)
+  {
+    pixel(xm+dx, ym, o->color);
+    pixel(xm-dx, ym, o->color);
+  }
+}
+
+void st7735tile::drawfillellipse(tileobj *o)
+{
+  int  xm= o->x1, ym= o->y1, a= o->x2, b= o->y2;
+  int  dx = 0, dy = b;
+  int  xs, ys;
+  long a2 = (long)a*a, b2 = (long)b*b;
+  long err = b2-(2*b-1)*a2, e2;
+
+  do
+  {
+    xs= dx; ys= dy;
+
+    e2 = 2*err;
+    if (e2 <  (2*dx+1)*b2) { dx++; err += (2*dx+1)*b2; }
+    if (e2 > -(2*dy-1)*a2) { dy--; err -= (2*dy-1)*a2; }
+
+    if (dy != ys)
+    {
+      hspan(xm-xs, xm+xs, ym+ys, o->color);
+      if (ys) hspan(xm-xs, xm+xs, ym-ys, o->color);
+    }
+  } while (dy >= 0);
+
+  if (dx < a) hspan(xm-a, xm+a, ym, o->color);
+}
+
+/* -------------------------------------------------------------
+     st7735tile::drawtext
+
+     setzt die Punkte der Zeichen wie st7735::putglyph ohne
+     fntfilled (Schrittweite und Vergroesserung wie bei
+     putchar5x7, putchar8x8, putchar12x16)
+   ------------------------------------------------------------- */
+void st7735tile::drawtext(tileobj *o)
+{
+  uint16_t    g[16];
+  uint8_t     fnt, sc, w, h, adv, r, c;
+  int         x, y, py;
+  const char  *s;
+
+  fnt= o->fnt & 0x0f;
+  sc = (o->fnt >> 4) + 1;
+  switch (fnt)
+  {
+    case FNT5x7   : w= 5;  h= 7;  sc= 1; adv= 6; break;
+    case FNT12x16 : w= 12; h= 16; adv= 12*sc; break;
+    default       : w= 8;  h= 8;  adv= 8*sc; break;
+  }
+
+  x= o->x1; y= o->y1;
+  for (s= (const char *)o->p; *s; s++, x += adv)
+  {
+    if (((uint8_t)*s < 32) || (x > _tx2) || (x + w*sc-1 < _tx1)) continue;
+    _dev->getglyph(fnt, *s, g);
+    for (r= 0; r< h; r++)
+    {
+      if (!g[r]) continue;
+      for (c= 0; c< w; c++)
+      {
+        if (!(g[r] & (0x8000 >> c))) continue;
+        for (py= y + r*sc; py< y + (r+1)*sc; py++)
+          hspan(x + c*sc, x + (c+1)*sc-1, py, o->color);
+      }
+    }
+  }
+}
+
+/* -------------------------------------------------------------
+     st7735tile::drawbitmap
+
+     setzt die Punkte eines Bitmaps aus dem Flash, nur die
+     Zeilen innerhalb der Kachel werden gelesen
+   ------------------------------------------------------------- */
+void st7735tile::drawbitmap(tileobj *o)
+{
+  const unsigned char *image;
+  uint16_t bw, bh, bpr;
+  int      r, r2, c;
+  uint8_t  b= 0;
+
+  image= (const unsigned char *)o->p;
+  bw = (pgm_read_byte(&image[0]) << 8) + pgm_read_byte(&image[1]);
+  bh = (pgm_read_byte(&image[2]) << 8) + pgm_read_byte(&image[3]);
+  bpr= (bw + 7) / 8;
+
+  r = _ty1 - o->y1; if (r < 0) r= 0;
+  r2= _ty2 - o->y1; if (r2 > (int)bh-1) r2= bh-1;
+  for (; r<= r2; r++)
+  {
+    for (c= 0; c< (int)bw; c++)
+    {
+      if (!(c & 7)) b= pgm_read_byte(&image[4 + r*bpr + c/8]);
+      if (b & (0x80 >> (c & 7))) pixel(o->x1 + c, o->y1 + r, o->color);
+    }
+  }
+}
+
+/* -------------------------------------------------------------
+     Objekte eintragen
+
+     Parameter wie bei den gleichnamigen Funktionen von st7735,
+     color : 16 - Bit RGB565 Farbwert
+
+     outtextxy verwendet fontnr und textsize des Displays, das
+     Rechteck des Textes wird beim Eintragen bestimmt.
+   ------------------------------------------------------------- */
+void st7735tile::line(int x0, int y0, int x1, int y1, uint16_t color)
+{
+  tileobj o;
+
+  o.typ= tobj_line; o.color= color;
+  o.x1= x0; o.y1= y0; o.x2= x1; o.y2= y1;
+  add(&o);
+}
+
+void st7735tile::rectangle(int x1, int y1, int x2, int y2, uint16_t color)
+{
+  tileobj o;
+
+  o.typ= tobj_rect; o.color= color;
+  if (x1 < x2) { o.x1= x1; o.x2= x2; } else { o.x1= x2; o.x2= x1; }
+  if (y1 < y2) { o.y1= y1; o.y2= y2; } else { o.y1= y2; o.y2= y1; }
+  add(&o);
+}
+
+void st7735tile::fillrect(int x1, int y1, int x2, int y2, uint16_t color)
+{
+  tileobj o;
+
+  o.typ= tobj_fillrect; o.color= color;
+  if (x1 < x2) { o.x1= x1; o.x2= x2; } else { o.x1= x2; o.x2= x1; }
+  if (y1 < y2) { o.y1= y1; o.y2= y2; } else { o.y1= y2; o.y2= y1; }
+  add(&o);
+}
+
+void st7735tile::ellipse(int xm, int ym, int a, int b, uint16_t color)
+{
+  tileobj o;
+
+  o.typ= tobj_ellipse; o.color= color;
+  o.x1= xm; o.y1= ym; o.x2= a; o.y2= b;
+  add(&o);
+}
+
+void st7735tile::fillellipse(int xm, int ym, int a, int b, uint16_t color)
+{
+  tileobj o;
+
+  o.typ= tobj_fillellipse; o.color= color;
+  o.x1= xm; o.y1= ym; o.x2= a; o.y2= b;
+  add(&o);
+}
+
+void st7735tile::circle(int x, int y, int r, uint16_t color)
+{
+  ellipse(x, y, r, r, color);
+}
+
+void st7735tile::fillcircle(int x, int y, int r, uint16_t color)
+{
+  fillellipse(x, y, r, r, color);
+}
+
+void st7735tile::outtextxy(int x, int y, const char *p, uint16_t color)
+{
+  tileobj o;
+  uint8_t sc, w, h;
+
+  o.typ= tobj_text; o.color= color; o.p= p;
+  o.fnt= _dev->fontnr | (_dev->textsize << 4);
+  sc= _dev->textsize + 1;
+  switch (_dev->fontnr)
+  {
+    case FNT5x7   : w= 6; h= 7; sc= 1; y--; break;      // wie putchar5x7
+    case FNT12x16 : w= 12; h= 16; break;
+    default       : w= 8; h= 8; break;
+  }
+  o.x1= x; o.y1= y;
+  o.x2= x + strlen(p)*w*sc - 1;
+  o.y2= y + h*sc - 1;
+  add(&o);
+}
+
+void st7735tile::bitmap(int x, int y, const unsigned char *image, uint16_t color)
+{
+  tileobj o;
+
+  o.typ= tobj_bitmap; o.color= color; o.p= image;
+  o.x1= x; o.y1= y;
+  o.x2= x + (pgm_read_byte(&image[0]) << 8) + pgm_read_byte(&image[1]) - 1;
+  o.y2= y + (pgm_read_byte(&image[2]) << 8) + pgm_read_byte(&image[3]) - 1;
+  add(&o);
+}
@@ -0,0 +1,212 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2c_fast.h
+
+     I2C mittels Bitbanging mit zur Compilezeit festgelegten Pins. Die
+     Pins (P1_x, P2_x oder Arduino Pinnummern) werden bereits beim
+     Uebersetzen in PORT / DDR / PIN Register und Bitmaske aufgeloest,
+     jeder Pegelwechsel ist damit ein einzelner sbi / cbi Befehl (statt
+     pinMode / digitalWrite / digitalRead).
+
+     Die Wartezeiten werden aus F_CPU und der gewuenschten Bustaktfrequenz
+     berechnet:
+
+         swi2c_fast<P2_0, P2_1>            i2c;     // 100 kHz
+         swi2c_fast<P2_0, P2_1, 400000>    i2c;     // 400 kHz
+         swi2c_fast<P2_0, P2_1, 0>         i2c;     // ohne Wartezeit
+
+     freq == 0 taktet so schnell, wie die Portzugriffe es zulassen
+     (ca. 1 MHz bei 8 MHz, nur fuer Bausteine, die das vertragen).
+
+     Portpins ohne Arduino Pinnummer (PB6 / PB7 des CP1+ EEProms) werden
+     mit fi2c_pb(bit) angegeben: swi2c_fast<fi2c_pb(7), fi2c_pb(6)>.
+     trbus ist die Busnummer fuer den Mitschnitt (cp1_i2ctr.h).
+
+     Die Memberfunktionen entsprechen denen von swi2c (cp1_i2c.h). swi2c
+     mit zur Laufzeit waehlbaren Pins bleibt unveraendert erhalten.
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2c_fast
+  #define in_cp1_i2c_fast
+
+  #include "Arduino.h"
+  #include <avr/io.h>
+  #include "cp1_i2ctr.h"
+
+  #define fi2c_overhead   4             // Takte je Halbperiode fuer Portzugriffe und Schleife
+
+  // Pin 0..7 : PORTD, 8..13 : PORTB, 14..19 (A0..A5) : PORTC, fi2c_pb(0..7) : PORTB
+  #define fi2c_pb(bit)    (0x40 | (bit))
+  #define fi2c_port(p)    (*((p) >= 0x40 ? &PORTB : ((p) < 8 ? &PORTD : ((p) < 14 ? &PORTB : &PORTC))))
+  #define fi2c_ddr(p)     (*((p) >= 0x40 ? &DDRB  : ((p) < 8 ? &DDRD  : ((p) < 14 ? &DDRB  : &DDRC))))
+  #define fi2c_pin(p)     (*((p) >= 0x40 ? &PINB  : ((p) < 8 ? &PIND  : ((p) < 14 ? &PINB  : &PINC))))
+  #define fi2c_mask(p)    (1 << ((p) >= 0x40 ? (p) & 7 : ((p) < 8 ? (p) : ((p) < 14 ? (p) - 8 : (p) - 14))))
+  #define fi2c_nmask(p)   ((uint8_t)~fi2c_mask(p))
+
+  template <uint8_t da, uint8_t cl, uint32_t freq = 100000, uint8_t trbus = i2ctr_fast>
+  class swi2c_fast
+  {
+    // Takte einer halben SCL-Periode abzueglich der Befehle selbst
+    static const uint16_t hcycles = freq ? (F_CPU / 2) / freq : 0;
+    static const uint16_t hdelay  = (hcycles > fi2c_overhead) ? hcycles - fi2c_overhead : 0;
+
+    // Open-Drain: PORT-Bit bleibt 0, High = Eingang (Pull-Up am Bus), Low = Ausgang
+    static inline void scl_hi(void)     { fi2c_ddr(cl) &= fi2c_nmask(cl); }
+    static inline void scl_lo(void)     { fi2c_ddr(cl) |= fi2c_mask(cl); }
+    static inline void sda_hi(void)     { fi2c_ddr(da) &= fi2c_nmask(da); }
+    static inline void sda_lo(void)     { fi2c_ddr(da) |= fi2c_mask(da); }
+    static inline uint8_t is_sda(void)  { return fi2c_pin(da) & fi2c_mask(da); }
+    static inline void half(void)       { __builtin_avr_delay_cycles(hdelay); }
+
+    public:
+
+      swi2c_fast(void)
+      {
+        sda_hi();
+        scl_hi();
+        fi2c_port(da) &= fi2c_nmask(da);
+        fi2c_port(cl) &= fi2c_nmask(cl);
+      }
+
+      /* ----------------------------------------------
+           sendstart
+
+           erzeugt die Startbedingung (auch als
+           wiederholter Start), SCL ist danach Low
+         ---------------------------------------------- */
+      void sendstart(void)
+      {
+        sda_hi();
+        half();
+        scl_hi();
+        half();
+        sda_lo();
+        half();
+        scl_lo();
+        i2ctr_start(trbus);
+      }
+
+      /* ----------------------------------------------
+           start
+
+           Startbedingung und Deviceadresse senden
+
+           Rueckgabe: 1 = Acknowledge vom Slave
+         ---------------------------------------------- */
+      uint8_t start(uint8_t addr)
+      {
+        sendstart();
+        return write(addr);
+      }
+
+      void startaddr(uint8_t addr, uint8_t rwflag)
+      {
+        sendstart();
+        write((addr << 1) | rwflag);
+      }
+
+      /* ----------------------------------------------
+           stop
+
+           erzeugt die Stopbedingung
+         ---------------------------------------------- */
+      void stop(void)
+      {
+        sda_lo();
+        half();
+        scl_hi();
+        half();
+        sda_hi();
+        half();
+        i2ctr_stop(trbus);
+      }
+
+      /* ----------------------------------------------
+           write_nack
+
+           sendet ein Byte ohne das Acknowledge zu
+           takten
+         ---------------------------------------------- */
+      void write_nack(uint8_t data)
+      {
+        uint8_t i;
+
+        for (i= 0; i< 8; i++)
+        {
+          if (data & 0x80) sda_hi(); else sda_lo();
+          half();
+          scl_hi();
+          half();
+          scl_lo();
+          data <<= 1;
+        }
+      }
+
+      /* ----------------------------------------------
+           write
+
+           sendet ein Byte
+
+           Rueckgabe: 1 = Acknowledge vom Slave
+                      0 = kein Acknowledge
+         ---------------------------------------------- */
+      uint8_t write(uint8_t data)
+      {
+        uint8_t ack;
+
+        write_nack(data);
+
+        sda_hi();                               // 9. Taktimpuls (Ack)
+        half();
+        scl_hi();
+        half();
+        ack= is_sda() ? 0 : 1;
+        scl_lo();
+        i2ctr_write(trbus, data, ack);
+        return ack;
+      }
+
+      uint8_t write16(uint16_t data)
+      {
+        if (!write(data >> 8)) return 0;
+        return write(data & 0xff);
+      }
+
+      /* ----------------------------------------------
+           read
+
+           liest ein Byte, ack == 1 sendet nach dem
+           Lesen ein Acknowledge
+         ---------------------------------------------- */
+      uint8_t read(uint8_t ack)
+      {
+        uint8_t data, i;
+
+        data= 0;
+        sda_hi();
+        for (i= 0; i< 8; i++)
+        {
+          half();
+          scl_hi();
+          half();
+          data <<= 1;
+          if (is_sda()) data |= 1;
+          scl_lo();
+        }
+
+        if (ack) sda_lo();
+        half();
+        scl_hi();
+        half();
+        scl_lo();
+        sda_hi();
+        i2ctr_read(trbus);
+        return data;
+      }
+
+      uint8_t read_ack(void)   { return read(1); }
+      uint8_t read_nack(void)  { return read(0); }
+  };
+
+#endif
@@ -0,0 +1,154 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2c_twi.h
+
+     I2C mit dem Hardware-TWI des ATmega328p (SDA = PC4 / A4,
+     SCL = PC5 / A5). Die Memberfunktionen entsprechen denen von swi2c
+     (cp1_i2c.h) und swi2c_fast (cp1_i2c_fast.h), die Bibliotheken
+     koennen damit ohne Aenderung auf dem TWI arbeiten:
+
+         hwi2c<>           i2c;     // 100 kHz
+         hwi2c<400000>     i2c;     // 400 kHz
+
+     Jede Funktion wartet (ohne Interrupt) auf das Ende der jeweiligen
+     Busaktion. Antwortet der Bus nicht innerhalb von twi_timeout
+     Abfragen (fehlende Pull-Ups, Slave haelt SCL), liefert sie 0 bzw.
+     Nack.
+
+     hwi2c und Wire (twi.c) duerfen nicht gleichzeitig verwendet werden.
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2c_twi
+  #define in_cp1_i2c_twi
+
+  #include "Arduino.h"
+  #include <avr/io.h>
+  #include <util/twi.h>
+  #include "cp1_i2ctr.h"
+
+  #define twi_timeout     20000         // Abfragen von TWINT (ca. 20 ms bei 8 MHz)
+
+  template <uint32_t freq = 100000>
+  class hwi2c
+  {
+    // SCL = F_CPU / (16 + 2 * TWBR), Prescaler 1
+    static const uint8_t twbr = ((F_CPU / freq) > 16) ? ((F_CPU / freq) - 16) / 2 : 0;
+
+    // wartet auf TWINT, Rueckgabe: Status (TW_STATUS), 0 bei Zeitueberschreitung
+    static uint8_t wait(void)
+    {
+      uint16_t n;
+
+      for (n= 0; n< twi_timeout; n++)
+      {
+        if (TWCR & (1 << TWINT)) return TW_STATUS;
+      }
+      return 0;
+    }
+
+    public:
+
+      hwi2c(void)
+      {
+        PORTC |= (1 << PC4) | (1 << PC5);       // interne Pull-Ups (externe sind besser)
+        TWSR= 0;
+        TWBR= twbr;
+        TWCR= (1 << TWEN);
+      }
+
+      /* ----------------------------------------------
+           sendstart
+
+           erzeugt die Startbedingung (auch als
+           wiederholter Start)
+         ---------------------------------------------- */
+      void sendstart(void)
+      {
+        TWCR= (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
+        wait();
+        i2ctr_start(i2ctr_twi);
+      }
+
+      /* ----------------------------------------------
+           start
+
+           Startbedingung und Deviceadresse senden
+
+           Rueckgabe: 1 = Acknowledge vom Slave
+         ---------------------------------------------- */
+      uint8_t start(uint8_t addr)
+      {
+        sendstart();
+        return write(addr);
+      }
+
+      void startaddr(uint8_t addr, uint8_t rwflag)
+      {
+        sendstart();
+        write((addr << 1) | rwflag);
+      }
+
+      /* ----------------------------------------------
+           stop
+
+           erzeugt die Stopbedingung und wartet, bis
+           sie auf dem Bus ist
+         ---------------------------------------------- */
+      void stop(void)
+      {
+        uint16_t n;
+
+        TWCR= (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+        for (n= 0; (n< twi_timeout) && (TWCR & (1 << TWSTO)); n++);
+        i2ctr_stop(i2ctr_twi);
+      }
+
+      /* ----------------------------------------------
+           write
+
+           sendet ein Byte (Adresse oder Daten)
+
+           Rueckgabe: 1 = Acknowledge vom Slave
+                      0 = kein Acknowledge
+         ---------------------------------------------- */
+      uint8_t write(uint8_t data)
+      {
+        uint8_t st, ack;
+
+        TWDR= data;
+        TWCR= (1 << TWINT) | (1 << TWEN);
+        st= wait();
+        ack= (st == TW_MT_SLA_ACK) || (st == TW_MT_DATA_ACK) || (st == TW_MR_SLA_ACK);
+        i2ctr_write(i2ctr_twi, data, ack);
+        return ack;
+      }
+
+      // das TWI taktet das Acknowledge immer mit
+      void write_nack(uint8_t data)  { write(data); }
+
+      uint8_t write16(uint16_t data)
+      {
+        if (!write(data >> 8)) return 0;
+        return write(data & 0xff);
+      }
+
+      /* ----------------------------------------------
+           read
+
+           liest ein Byte, ack == 1 sendet nach dem
+           Lesen ein Acknowledge
+         ---------------------------------------------- */
+      uint8_t read(uint8_t ack)
+      {
+        TWCR= (1 << TWINT) | (1 << TWEN) | (ack ? (1 << TWEA) : 0);
+        wait();
+        i2ctr_read(i2ctr_twi);
+        return TWDR;
+      }
+
+      uint8_t read_ack(void)   { return read(1); }
+      uint8_t read_nack(void)  { return read(0); }
+  };
+
+#endif
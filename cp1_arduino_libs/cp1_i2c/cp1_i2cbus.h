@@ -0,0 +1,60 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2cbus.h
+
+     gemeinsamer I2C Bus der Bibliotheken (realtimeclock, rda5807, eepr)
+
+     Alle Treiber (swi2c, swi2c_fast, hwi2c) haben dieselben Member-
+     funktionen (sendstart, start, startaddr, stop, write, write_nack,
+     write16, read, read_ack, read_nack). Welcher davon fuer den Bus i2c
+     verwendet wird, legt i2c_backend hier in der Datei fest (die Biblio-
+     theken werden getrennt vom Sketch uebersetzt, ein #define im Sketch
+     erreicht sie nicht):
+
+       i2c_bk_soft : swi2c, Pins zur Laufzeit (pinMode / digitalWrite),
+                     ca. 20 kHz, i2c_freq ohne Bedeutung (Vorgabe)
+       i2c_bk_fast : swi2c_fast, Pins i2c_sda / i2c_scl zur Compilezeit,
+                     Takt i2c_freq (100000, 400000 oder 0 = ohne
+                     Wartezeit)
+       i2c_bk_twi  : hwi2c, Hardware-TWI an PC4 (SDA) / PC5 (SCL), Takt
+                     i2c_freq (100000 oder 400000)
+
+     Im Sketch wird der Bus angelegt mit
+
+         i2cmaster i2c;                 // SDA = i2c_sda, SCL = i2c_scl (cp1_i2c.h)
+
+     Das EEProm (eepr) liegt fest an PB6 / PB7 und hat einen eigenen Bus,
+     der ebenfalls i2c_backend und i2c_freq folgt (eep_bus, cp1_eeprom.h).
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2cbus
+  #define in_cp1_i2cbus
+
+  #include "cp1_i2c.h"
+  #include "cp1_i2c_fast.h"
+
+  #define i2c_bk_soft       0
+  #define i2c_bk_fast       1
+  #define i2c_bk_twi        2
+
+  #ifndef i2c_backend
+    #define i2c_backend     i2c_bk_soft
+  #endif
+
+  #ifndef i2c_freq
+    #define i2c_freq        100000      // SCL-Takt fuer i2c_bk_fast / i2c_bk_twi
+  #endif
+
+  #if (i2c_backend == i2c_bk_twi)
+    #include "cp1_i2c_twi.h"
+    typedef hwi2c<i2c_freq> i2cmaster;
+  #elif (i2c_backend == i2c_bk_fast)
+    typedef swi2c_fast<i2c_sda, i2c_scl, i2c_freq> i2cmaster;
+  #else
+    typedef swi2c i2cmaster;
+  #endif
+
+  extern i2cmaster i2c;
+
+#endif
@@ -0,0 +1,295 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2ctrace.cpp
+
+     Mitschnitt der I2C Transaktionen mit Zeitstempel (siehe
+     cp1_i2ctrace.h)
+
+     Je Bus gibt es einen offenen Datensatz, der mit der Start-
+     bedingung begonnen und mit der Stopbedingung (bzw. einem
+     wiederholten Start) in den Ring uebernommen wird. Das erste
+     Byte nach dem Start ist die Adresse.
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Arduino.h"
+#include "cp1_i2ctrace.h"
+
+#define  i2ctr_faddr     0x40           // intern: Adressbyte steht noch aus
+#define  i2ctr_fopen     0x80           // intern: Datensatz ist offen
+
+#if (i2c_trace == 1)
+
+static i2ctr_rec  ring[i2ctr_size];
+static i2ctr_rec  act[i2ctr_busanz];    // offene Datensaetze je Bus
+static volatile uint8_t  rput, ranz;
+static volatile uint16_t tick_hi;       // oberes Wort der Ticks
+
+volatile uint16_t i2ctr_lost;
+
+/* -------------------------------------------------------
+                     ISR(TIMER1_OVF_vect)
+
+     zaehlt das obere Wort der Zeitbasis
+   ------------------------------------------------------- */
+ISR(TIMER1_OVF_vect)
+{
+  tick_hi++;
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_begin
+
+     startet Timer1 als Zeitbasis und leert den Ring
+   ------------------------------------------------------- */
+void i2ctrace_begin(void)
+{
+  TCCR1A= 0;                            // normal mode
+  TCCR1B= 1 << CS11;                    // Prescaler 8
+  TCNT1= 0;
+  TIFR1= 1 << TOV1;
+  TIMSK1= 1 << TOIE1;
+  i2ctrace_clear();
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_clear
+
+     verwirft alle Eintraege und offenen Datensaetze
+   ------------------------------------------------------- */
+void i2ctrace_clear(void)
+{
+  uint8_t sreg, i;
+
+  sreg= SREG;
+  cli();
+  rput= 0; ranz= 0; i2ctr_lost= 0;
+  for (i= 0; i< i2ctr_busanz; i++) act[i].flags= 0;
+  SREG= sreg;
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_ticks
+
+     Rueckgabe: Zeit in Timer1 Ticks (32 Bit)
+   ------------------------------------------------------- */
+uint32_t i2ctrace_ticks(void)
+{
+  uint8_t  sreg;
+  uint16_t lo, hi;
+
+  sreg= SREG;
+  cli();
+  lo= TCNT1;
+  hi= tick_hi;
+  // Ueberlauf, dessen Interrupt noch aussteht
+  if ((TIFR1 & (1 << TOV1)) && (lo < 0x8000)) hi++;
+  SREG= sreg;
+  return ((uint32_t)hi << 16) | lo;
+}
+
+/* -------------------------------------------------------
+                        i2ctr_commit
+
+     uebernimmt den offenen Datensatz von bus in den
+     Ring, der aelteste Eintrag wird ggf. ueberschrieben
+   ------------------------------------------------------- */
+static void i2ctr_commit(uint8_t bus, uint32_t now)
+{
+  i2ctr_rec *r;
+  uint32_t  dur;
+  uint8_t   sreg;
+
+  r= &act[bus];
+  dur= now - r->start;
+  r->dur= (dur > 0xffff) ? 0xffff : dur;
+  r->flags &= ~(i2ctr_faddr | i2ctr_fopen);
+
+  sreg= SREG;
+  cli();
+  ring[rput]= *r;
+  rput++;
+  if (rput== i2ctr_size) rput= 0;
+  if (ranz < i2ctr_size) ranz++; else i2ctr_lost++;
+  SREG= sreg;
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_start
+
+     Startbedingung (auch wiederholter Start) auf bus
+   ------------------------------------------------------- */
+void i2ctrace_start(uint8_t bus)
+{
+  i2ctr_rec *r;
+  uint32_t  now;
+  uint8_t   rs;
+
+  now= i2ctrace_ticks();
+  r= &act[bus];
+  rs= 0;
+  if (r->flags & i2ctr_fopen)
+  {
+    i2ctr_commit(bus, now);             // wiederholter Start beendet den Datensatz
+    rs= i2ctr_frstart;
+  }
+  r->start= now;
+  r->addr= 0;
+  r->cnt= 0;
+  r->flags= i2ctr_fopen | i2ctr_faddr | rs | (bus << i2ctr_busshift);
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_write
+
+     gesendetes Byte, ack: 1 = Acknowledge vom Slave
+   ------------------------------------------------------- */
+void i2ctrace_write(uint8_t bus, uint8_t data, uint8_t ack)
+{
+  i2ctr_rec *r;
+
+  r= &act[bus];
+  if (!(r->flags & i2ctr_fopen)) return;
+  if (r->flags & i2ctr_faddr)
+  {
+    r->flags &= ~i2ctr_faddr;
+    r->addr= data >> 1;
+    if (data & 1) r->flags |= i2ctr_fread;
+    if (!ack) r->flags |= i2ctr_fnackadr;
+    return;
+  }
+  if (r->cnt < 0xff) r->cnt++;
+  if (!ack) r->flags |= i2ctr_fnackdat;
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_read
+
+     gelesenes Byte
+   ------------------------------------------------------- */
+void i2ctrace_read(uint8_t bus)
+{
+  i2ctr_rec *r;
+
+  r= &act[bus];
+  if ((r->flags & i2ctr_fopen) && (r->cnt < 0xff)) r->cnt++;
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_stop
+
+     Stopbedingung auf bus
+   ------------------------------------------------------- */
+void i2ctrace_stop(uint8_t bus)
+{
+  if (act[bus].flags & i2ctr_fopen) i2ctr_commit(bus, i2ctrace_ticks());
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_count
+
+     Rueckgabe: Anzahl Eintraege im Ring
+   ------------------------------------------------------- */
+uint8_t i2ctrace_count(void)
+{
+  return ranz;
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_get
+
+     kopiert Eintrag idx (0 = aeltester) nach rec
+
+     Rueckgabe: 1 = ok, 0 = idx nicht vorhanden
+   ------------------------------------------------------- */
+uint8_t i2ctrace_get(uint8_t idx, i2ctr_rec *rec)
+{
+  uint8_t sreg, i;
+
+  sreg= SREG;
+  cli();
+  if (idx >= ranz)
+  {
+    SREG= sreg;
+    return 0;
+  }
+  i= (rput + i2ctr_size - ranz + idx) % i2ctr_size;
+  *rec= ring[i];
+  SREG= sreg;
+  return 1;
+}
+
+/* -------------------------------------------------------
+                        i2ctr_us
+
+     rechnet Timer1 Ticks (Prescaler 8) in us um
+   ------------------------------------------------------- */
+static uint32_t i2ctr_us(uint32_t ticks)
+{
+  #if (F_CPU == 16000000UL)
+    return ticks >> 1;
+  #elif (F_CPU == 8000000UL)
+    return ticks;
+  #else
+    return (uint64_t)ticks * 8 / (F_CPU / 1000000UL);
+  #endif
+}
+
+/* -------------------------------------------------------
+                        i2ctrace_dump
+
+     gibt den Ring als CSV auf out aus (aeltester
+     Eintrag zuerst)
+   ------------------------------------------------------- */
+void i2ctrace_dump(Print &out)
+{
+  i2ctr_rec r;
+  uint8_t   i;
+
+  out.println(F("bus,addr,dir,bytes,ack,rs,start_us,dur_us"));
+  for (i= 0; i2ctrace_get(i, &r); i++)
+  {
+    out.print(r.flags >> i2ctr_busshift);
+    out.print(F(",0x"));
+    if (r.addr < 0x10) out.print('0');
+    out.print(r.addr, HEX);
+    out.print((r.flags & i2ctr_fread) ? F(",r,") : F(",w,"));
+    out.print(r.cnt);
+    if (r.flags & i2ctr_fnackadr) out.print(F(",NA,"));
+    else if (r.flags & i2ctr_fnackdat) out.print(F(",ND,"));
+    else out.print(F(",A,"));
+    out.print((r.flags & i2ctr_frstart) ? 1 : 0);
+    out.print(',');
+    out.print(i2ctr_us(r.start));
+    out.print(',');
+    out.println(i2ctr_us(r.dur));
+  }
+  if (i2ctr_lost)
+  {
+    out.print(F("# lost,"));
+    out.println(i2ctr_lost);
+  }
+}
+
+#else
+
+/*
+   i2c_trace 0: der Sketch kann i2ctrace_begin und i2ctrace_dump
+   unveraendert aufrufen, Timer1 bleibt unbenutzt
+*/
+
+volatile uint16_t i2ctr_lost;
+
+void i2ctrace_begin(void) { }
+void i2ctrace_clear(void) { }
+uint8_t i2ctrace_count(void) { return 0; }
+uint8_t i2ctrace_get(uint8_t idx, i2ctr_rec *rec) { return 0; }
+
+void i2ctrace_dump(Print &out)
+{
+  out.println(F("# i2c_trace 0"));
+}
+
+#endif
@@ -0,0 +1,100 @@
+/* ---------------------------------------------------------------------------
+                                cp1_i2ctrace.h
+
+     Mitschnitt der I2C Transaktionen mit Zeitstempel
+
+     swi2c, swi2c_fast, hwi2c und der TWI-Treiber (Wire, twi_queue)
+     rufen bei Start, jedem Byte und Stop die i2ctr_xxx Makros auf (der
+     Bus von eepr ist ein swi2c_fast mit der Busnummer i2ctr_eepr).
+     Daraus wird je Transaktion ein Datensatz gebildet (Bus, Adresse,
+     Richtung, Anzahl Bytes, Ack / Nack, Beginn und Dauer) und in einem
+     Ringpuffer mit i2ctr_size Eintraegen abgelegt. Ist der Ring voll,
+     wird der aelteste Eintrag ueberschrieben (i2ctr_lost zaehlt mit).
+
+     Eingeschaltet wird der Mitschnitt mit
+
+         #define i2c_trace   1
+
+     in cp1_i2ctr.h (Library cp1_i2c, die Bibliotheken werden getrennt
+     vom Sketch uebersetzt, ein #define im Sketch erreicht sie nicht).
+     Dort stehen auch die Busnummern und die i2ctr_xxx Makros, bei
+     i2c_trace 0 sind sie leer und diese Library wird nicht benoetigt.
+
+     Zeitbasis ist Timer1 (normal mode, Prescaler 8, Ueberlauf-
+     interrupt zaehlt das obere Wort): 1 us bei 8 MHz, 0,5 us bei
+     16 MHz. Timer1 steht damit fuer anderes (PWM, Servo) nicht
+     mehr zur Verfuegung.
+
+         i2ctrace_begin();
+         ...
+         i2ctrace_dump(Serial);
+
+     Ausgabe von i2ctrace_dump (CSV, aeltester Eintrag zuerst):
+
+         bus,addr,dir,bytes,ack,rs,start_us,dur_us
+         0,0x68,w,1,A,0,1203344,212
+         0,0x68,r,7,A,1,1203556,655
+
+         bus      : i2ctr_swi2c .. i2ctr_twi
+         addr     : 7-Bit Deviceadresse
+         dir      : w / r
+         bytes    : Anzahl Datenbytes (ohne Adresse)
+         ack      : A = ok, NA = Nack auf Adresse, ND = Nack auf Daten
+         rs       : 1 = mit wiederholtem Start begonnen
+         start_us : Beginn (Startbedingung)
+         dur_us   : Dauer bis zur Stopbedingung bzw. zum wieder-
+                    holten Start
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_cp1_i2ctrace
+  #define in_cp1_i2ctrace
+
+  #include <inttypes.h>
+  #include "cp1_i2ctr.h"
+
+  #ifndef i2ctr_size
+    #define i2ctr_size      32          // Eintraege im Ringpuffer (je 9 Byte RAM)
+  #endif
+
+  // i2ctr_rec.flags
+  #define i2ctr_fread       0x01        // Lesezugriff
+  #define i2ctr_fnackadr    0x02        // Nack auf die Adresse
+  #define i2ctr_fnackdat    0x04        // Nack auf ein Datenbyte
+  #define i2ctr_frstart     0x08        // mit wiederholtem Start begonnen
+  #define i2ctr_busshift    4           // Bit 4..5 : Busnummer
+
+  typedef struct
+  {
+    uint32_t start;                     // Timer1 Ticks bei der Startbedingung
+    uint16_t dur;                       // Dauer in Ticks (max. 0xffff)
+    uint8_t  addr;                      // 7-Bit Adresse
+    uint8_t  cnt;                       // Anzahl Datenbytes
+    uint8_t  flags;
+  } i2ctr_rec;
+
+  #ifdef __cplusplus
+  extern "C" {
+  #endif
+
+  extern volatile uint16_t i2ctr_lost;  // ueberschriebene Eintraege
+
+  void     i2ctrace_begin(void);
+  void     i2ctrace_clear(void);
+  uint32_t i2ctrace_ticks(void);
+  uint8_t  i2ctrace_count(void);
+  uint8_t  i2ctrace_get(uint8_t idx, i2ctr_rec *rec);
+  void     i2ctrace_start(uint8_t bus);
+  void     i2ctrace_write(uint8_t bus, uint8_t data, uint8_t ack);
+  void     i2ctrace_read(uint8_t bus);
+  void     i2ctrace_stop(uint8_t bus);
+
+  #ifdef __cplusplus
+  }
+
+    #include "Print.h"
+    void   i2ctrace_dump(Print &out);
+  #endif
+
+#endif
@@ -0,0 +1,73 @@
+/* -------------------------------------------------------
+                         i2c_trace.ino
+
+     Mitschnitt der I2C Zugriffe: jede Sekunde werden die
+     Uhrzeitregister eines DS3231 / DS1307 (0xd0) mit
+     swi2c gelesen. Ein Zeichen auf der seriellen Schnitt-
+     stelle (38400 Bd) gibt den Mitschnitt als CSV aus und
+     loescht ihn.
+
+     Benoetigt nur cp1_i2c (swi2c), Beispiel mit RTC und
+     externem EEProm siehe cp1+/libraries/cp1_i2ctrace.
+
+     In cp1_i2ctr.h (cp1_i2c) muss dazu i2c_trace 1 gesetzt sein.
+     Der Mitschnitt belegt Timer1.
+
+     R. Seelig
+   ------------------------------------------------------ */
+
+#include "cp1_i2c.h"
+#include "cp1_i2ctrace.h"
+
+#define rtc_addr        0xd0         // 8-Bit I2C Adresse DS3231 / DS1307
+
+swi2c           i2c(P2_0, P2_1);     // Objekt Software-I2C : i2c(sda, scl)
+
+uint32_t        lastsek;
+uint8_t         zeit[3];             // Sekunden, Minuten, Stunden (BCD)
+
+/*  ---------------------------------------------------------
+                           rtc_read
+
+     liest die Register 0..2 (Sekunden, Minuten, Stunden)
+    --------------------------------------------------------- */
+void rtc_read(void)
+{
+  if (!i2c.start(rtc_addr)) { i2c.stop(); return; }    // kein Baustein
+  i2c.write(0);
+  i2c.stop();
+  i2c.start(rtc_addr | 1);
+  zeit[0]= i2c.read_ack();
+  zeit[1]= i2c.read_ack();
+  zeit[2]= i2c.read_nack();
+  i2c.stop();
+}
+
+/*  ---------------------------------------------------------
+                             setup
+    --------------------------------------------------------- */
+void setup()
+{
+  Serial.begin(38400);
+  i2ctrace_begin();
+  lastsek= 0;
+}
+
+/*  ---------------------------------------------------------
+                             loop
+    --------------------------------------------------------- */
+void loop()
+{
+  if ((millis() - lastsek) >= 1000)
+  {
+    lastsek= millis();
+    rtc_read();
+  }
+
+  if (Serial.available() > 0)
+  {
+    Serial.read();
+    i2ctrace_dump(Serial);
+    i2ctrace_clear();
+  }
+}
@@ -50,7 +50,7 @@
       int      aktyp;               // dto. fuer die Y-Achse
       uint16_t textcolor = 0xffff;  // Beinhaltet die Farbwahl fuer die Vordergrundfarbe
       uint16_t bkcolor = 0;         // dto. fuer die Hintergrundfarbe
-      uint8_t  outmode = 0;
+      uint8_t  outmode = 0;         // Drehung der Ausgabe 0..3 (MADCTL, siehe setrotation)
       uint8_t  textsize;            // Skalierung der Ausgabeschriftgroesse
       uint8_t  txoutmode = 0;       // Drehrichtung fuer die Textausgabe
       uint8_t  fntfilled = 1;       // gibt an, ob eine Zeichenausgabe ueber einen Hintergrund gelegt
@@ -65,12 +65,14 @@
       void init(uint16_t xres, uint16_t yres, uint8_t mirror, uint8_t colfolge);
       void ofsmode(int8_t ofs);
       void version_g();
+      void ramrows(uint8_t rows);
       void putpixel(int x, int y,uint16_t color);
       void clrscr();   
       void lcd_putchar(char ch);
       void putchar5x7(unsigned char ch);
       void putchar8x8(unsigned char ch);
-      void putchar12x16(unsigned char ch);    
+      void putchar12x16(unsigned char ch);
+      void getglyph(uint8_t fnt, unsigned char ch, uint16_t *g);
       void outtextxy(int x, int y, char *p);
       void setfont(uint8_t nr);
       void gotoxy(unsigned char x, unsigned char y);
@@ -82,6 +84,59 @@
       void fillellipse(int xm, int ym, int a, int b, uint16_t color );         
       void circle(int x, int y, int r, uint16_t color );                         
       void fillcircle(int x, int y, int r, uint16_t color );                    
+      void set_ram_address (uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+
+      /* ----------------------------------------------------------
+           push_pixels, push_buffer
+
+           schreiben Farbwerte in das mit set_ram_address
+           gesetzte Fenster:
+
+             push_pixels : color anz mal
+             push_buffer : n Farbwerte aus buf
+         ---------------------------------------------------------- */
+      void push_pixels(uint16_t color, uint16_t anz)
+      {
+        uint8_t hi= color >> 8;
+        uint8_t lo= color & 0xff;
+
+        while (anz--)
+        {
+          spi_lcdout(hi);
+          spi_lcdout(lo);
+        }
+      }
+
+      void push_buffer(const uint16_t *buf, uint16_t n)
+      {
+        uint16_t color;
+
+        while (n--)
+        {
+          color= *buf++;                  // laeuft parallel zum letzten Byte
+          spi_lcdout(color >> 8);
+          spi_lcdout(color & 0xff);
+        }
+      }
+
+      /* ----------------------------------------------------------
+           flush
+
+           wartet, bis das letzte Byte an das Display uebertragen
+           ist. Die Ausgabefunktionen kehren zurueck, waehrend es
+           noch gesendet wird (bei F_CPU/2 16 Takte).
+
+           Benutzt ein anderer Baustein denselben SPI-Bus, muss vor
+           dessen Zugriff flush() aufgerufen werden, sonst geht sein
+           erstes Byte verloren (WCOL). Da CE des Displays nach init
+           aktiv bleibt, muss der Sketch CE fuer diese Zeit selbst
+           auf High legen, sonst empfaengt das Display die Bytes
+           mit.
+         ---------------------------------------------------------- */
+      void flush()
+      {
+        spi_wait();
+      }
     
     protected:
   
@@ -98,21 +153,51 @@
       int8_t _lcyofs     = -32;
       
       uint8_t _mirror    = 0;
+      uint8_t _ramh      = 160;      // Zeilen Displayram (version_g: 132, siehe ramrows)
+
+      uint8_t  _spipend  = 0;        // letztes Byte auf SPI von hier, SPIF steht noch aus
+      uint8_t  _actmode  = 0xff;     // outmode, fuer den MADCTL gesetzt ist
+      int8_t   _xofs, _yofs;         // Adressverschiebung in dieser Lage
+      int8_t   _xmin, _ymin;         // kleinste sichtbare Koordinate (_mirror)
+      uint16_t _width, _height;      // Aufloesung in dieser Lage
       
       #define coladdr      0x2a
       #define rowaddr      0x2b
       #define writereg     0x2c    
       
       void spi_init();
-      void spi_lcdout(uint8_t data);
+
+      // wartet auf das Ende der laufenden SPI Uebertragung, falls das
+      // letzte Byte von hier gesendet wurde. SPIF allein reicht nicht:
+      // hat ein anderer Teilnehmer den Bus benutzt, ist SPIF geloescht
+      // und es wuerde ewig gewartet
+      void spi_wait()
+      {
+        if (_spipend)
+        {
+          while (!(SPSR & (1 << SPIF)));
+          _spipend= 0;
+        }
+      }
+
+      // sendet ein Byte ueber SPI: es wird vor dem Schreiben auf das
+      // vorherige Byte gewartet, nicht danach. Die Berechnung des
+      // naechsten Bytes laeuft so parallel zur Uebertragung (16 Takte)
+      void spi_lcdout(uint8_t data)
+      {
+        spi_wait();
+        SPDR= data;
+        _spipend= 1;
+      }
+
       void wrcmd(uint8_t cmd);
       void wrdata(uint8_t data);
-      void wrdata16(int data);
-      void set_ram_address (uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
-      void setxypos(int x, int y);
-      void setcol(int startcol);
-      void setpage(int startpage);    
-      void putpixeltx(int x, int y, uint16_t color);    
+      void wrwin(uint8_t cmd, uint16_t a1, uint16_t a2);
+      void fillwindow(int x1, int y1, int x2, int y2, uint16_t color);
+      void setrotation();
+      uint8_t clipwin(int *x1, int *y1, int *x2, int *y2);
+      void txmap(int *x, int *y);
+      void putglyph(int x, int y, uint16_t *g, uint8_t w, uint8_t h, uint8_t sc);
   };
     
 #endif
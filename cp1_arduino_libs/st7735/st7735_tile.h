@@ -0,0 +1,157 @@
+/* ---------------------------------------------------------------------------
+                               st7735_tile.h
+
+     Kachelweise Ausgabe fuer st7735 (optional)
+
+     Ein Bildspeicher fuer das ganze Display (128x160 RGB565 = 40 KByte)
+     passt nicht in das RAM des ATmega328. st7735tile sammelt stattdessen
+     die Grafikobjekte eines Bildes in einer Displayliste und setzt sie
+     Kachel fuer Kachel (tile_w x tile_h Punkte) in einem kleinen Puffer
+     zusammen. Jede Kachel wird danach mit einem einzigen Fenster
+     (set_ram_address / push_buffer) zum Display geschickt: ueberlappende
+     Objekte flackern nicht und werden nicht mehrfach uebertragen.
+
+     Fuer jede Kachel wird eine 16-Bit Pruefsumme ueber die sie beruehren-
+     den Objekte gebildet. Hat sie sich seit dem letzten render nicht
+     geaendert, wird die Kachel uebersprungen. Die Objektlisten selbst
+     werden nicht verglichen (dafuer reicht das RAM nicht): ergibt ein
+     geaenderter Kachelinhalt zufaellig dieselbe Pruefsumme (ca. 1 zu
+     65536), wird diese Kachel nicht neu gezeichnet und bleibt bis zur
+     naechsten Aenderung falsch. Wo das nicht sein darf, vor render
+     invalidate aufrufen (alle Kacheln werden ausgegeben).
+
+         st7735      lcd(P1_2, P1_3, P1_4);
+         st7735tile  tiles(&lcd);
+
+         tiles.area(40, 38, 88, 86);        // Ausgabebereich
+         tiles.bkcolor= ziffbk;
+         ...                                // feste Objekte eintragen
+         tiles.keep();                      // bleiben bei clear erhalten
+
+         tiles.clear();                     // je Bild
+         tiles.line(...);
+         tiles.render();
+
+     Koordinaten sind die des Displays (outmode). Der Bereich muss inner-
+     halb des Displays liegen, Objekte ganz ausserhalb des Bereichs werden
+     schon beim Eintragen verworfen. Texte (Font und textsize des Displays
+     beim Eintragen, ohne txoutmode) werden erst bei render gelesen und
+     muessen bis dahin erhalten bleiben. Bitmaps liegen im Flash (Aufbau
+     wie bei oled::bmpsw_show, 4 Bytes Breite / Hoehe, dann Zeilen mit
+     MSB = linker Punkt).
+
+     Die Groessen werden hier in der Datei festgelegt (die Bibliothek wird
+     getrennt vom Sketch uebersetzt). Der RAM-Bedarf eines st7735tile
+     Objekts ist tile_ram plus ca. 20 Bytes Verwaltung, render belegt
+     zusaetzlich ca. 30 Bytes Stack:
+
+         tile_ram = 2 * tile_w * tile_h  +  14 * tile_maxobj  +  2 * tile_maxtiles
+
+     Voreinstellung 16x8 Kacheln, 32 Objekte, 32 Kacheln: 768 Bytes, also
+     mehr als ein Drittel des RAMs eines ATmega328 (2 KByte). Ein Sketch
+     sollte mit #if pruefen, ob seine Werte (Bereich / tile_w * tile_h
+     Kacheln, Objekte je Bild) hineinpassen, area liefert bei zu vielen
+     Kacheln 0, lost zaehlt verworfene Objekte. Ueberschreitet tile_ram
+     tile_maxram, bricht die Uebersetzung ab.
+
+     R. Seelig
+   --------------------------------------------------------------------------- */
+
+#ifndef in_st7735_tile
+  #define in_st7735_tile
+
+  #include "st7735.h"
+
+  #ifndef tile_w
+    #define tile_w          16          // Kachelgroesse, 16x8 oder 32x4
+  #endif
+
+  #ifndef tile_h
+    #define tile_h          8
+  #endif
+
+  #ifndef tile_maxobj
+    #define tile_maxobj     32          // Eintraege der Displayliste (je 14 Bytes)
+  #endif
+
+  #ifndef tile_maxtiles
+    #define tile_maxtiles   32          // Kacheln im Bereich (z.B. 64x64 bei 16x8)
+  #endif
+
+  #ifndef tile_maxram
+    #define tile_maxram     1024        // Obergrenze fuer tile_ram
+  #endif
+
+  #define tile_ram          (2 * tile_w * tile_h + 14 * tile_maxobj + 2 * tile_maxtiles)
+
+  #if (tile_ram > tile_maxram)
+    #error "st7735_tile: Puffer groesser als tile_maxram"
+  #endif
+
+  enum { tobj_line, tobj_rect, tobj_fillrect, tobj_ellipse, tobj_fillellipse,
+         tobj_text, tobj_bitmap };
+
+  struct tileobj
+  {
+    uint8_t    typ;
+    uint8_t    fnt;                     // Text: fontnr | textsize << 4
+    int16_t    x1, y1, x2, y2;          // Ellipse: Mittelpunkt, a, b
+                                        // Text, Bitmap: umschliessendes Rechteck
+    uint16_t   color;
+    const void *p;                      // Text, Bitmap
+  };
+
+  class st7735tile
+  {
+    public:
+      uint16_t bkcolor = 0;             // Hintergrund der Kacheln
+      uint8_t  lost    = 0;             // Anzahl Objekte, die nicht in die Liste passten
+
+      st7735tile(st7735 *dev);
+      uint8_t area(int x1, int y1, int x2, int y2);
+      void keep();
+      void clear();
+      void reset();
+      void invalidate();
+      uint8_t render();
+
+      void line(int x0, int y0, int x1, int y1, uint16_t color);
+      void rectangle(int x1, int y1, int x2, int y2, uint16_t color);
+      void fillrect(int x1, int y1, int x2, int y2, uint16_t color);
+      void ellipse(int xm, int ym, int a, int b, uint16_t color);
+      void fillellipse(int xm, int ym, int a, int b, uint16_t color);
+      void circle(int x, int y, int r, uint16_t color);
+      void fillcircle(int x, int y, int r, uint16_t color);
+      void outtextxy(int x, int y, const char *p, uint16_t color);
+      void bitmap(int x, int y, const unsigned char *image, uint16_t color);
+
+    protected:
+
+    private:
+      st7735   *_dev;
+      int      _ax1, _ay1, _ax2, _ay2;  // Ausgabebereich
+      uint8_t  _cols, _rows;            // Kacheln im Bereich
+      uint8_t  _cnt;                    // Eintraege der Displayliste
+      uint8_t  _keep;                   // davon bleiben bei clear erhalten
+      uint8_t  _full;                   // naechstes render gibt alle Kacheln aus
+
+      int      _tx1, _ty1, _tx2, _ty2;  // aktuelle Kachel
+      uint8_t  _tw;                     // deren Breite (Zeilenlaenge im Puffer)
+
+      tileobj  _obj[tile_maxobj];
+      uint16_t _sig[tile_maxtiles];     // Pruefsummen beim letzten render
+      uint16_t _buf[tile_w * tile_h];
+
+      void add(tileobj *o);
+      void objbox(tileobj *o, int *x1, int *y1, int *x2, int *y2);
+      uint16_t objsig(uint16_t h, tileobj *o);
+      void hspan(int x1, int x2, int y, uint16_t color);
+      void pixel(int x, int y, uint16_t color);
+      void drawline(tileobj *o);
+      void drawellipse(tileobj *o);
+      void drawfillellipse(tileobj *o);
+      void drawtext(tileobj *o);
+      void drawbitmap(tileobj *o);
+  };
+
+#endif
@@ -11,6 +11,7 @@
 #include "cp1_i2c.h"
 #include "cp1_rtc.h"
 #include "st7735.h"
+#include "st7735_tile.h"
 #include "cp1_tm1637.h"
 
 /*
@@ -37,13 +38,14 @@
 // Objekte
 
 st7735 lcd(P1_2, P1_3, P1_4);  // Displayobjekt erzeugen
+st7735tile tiles(&lcd);        // kachelweise Ausgabe der Zeiger
 tm1637  tm16(A5, A4, 5);       // Tastaturobjekt
 swi2c i2c(P2_0, P2_1);         // Software - I2C : i2c(sda, scl)
 
 realtimeclock rtc;             // Objekt rtc
 
 
-volatile int oldstd, oldmin, oldsek;
+volatile int oldsek;
 
 char wtag[7][3] = {"So", "Mo", "Di", "Mi", "Do", "Fr", "Sa"};
 
@@ -55,8 +57,27 @@ char wtag[7][3] = {"So", "Mo", "Di", "Mi", "Do", "Fr", "Sa"};
 #define yuo             0                                   // dto. Y-Achse
 #define ruhr            53                                  // Radius der analogen Uhrendarstellung
 #define stdzeig         24                                  // Laenge Stundenzeiger, je kleiner Zahl umso groesser Zeiger
+#define zeigerr         24                                  // Radius des Bereichs, den die Zeiger ueberstreichen
+
+#define zeigobj         27                                  // Objekte je Bild: 16 Skalenstriche im Bereich + 11 Zeigerlinien
+
+/*
+   RAM der kachelweisen Ausgabe (st7735_tile.h, Voreinstellung 16x8
+   Kacheln, 32 Objekte, 32 Kacheln): tile_ram = 768 Bytes plus ca. 50
+   Bytes fuer Verwaltung und Stack von render. Der Zeigerbereich
+   (2*zeigerr+1 Punkte im Quadrat) belegt 4x7 = 28 Kacheln.
+*/
+#if ((((2*zeigerr+tile_w)/tile_w) * ((2*zeigerr+tile_h)/tile_h)) > tile_maxtiles)
+  #error "rtc_analog_uhr: Zeigerbereich hat mehr Kacheln als tile_maxtiles"
+#endif
+
+#if (zeigobj > tile_maxobj)
+  #error "rtc_analog_uhr: tile_maxobj zu klein fuer Skalen und Zeiger"
+#endif
 
 uint16_t ziffbk;                                            // Hintergrundfarbe des Ziffernblatts
+uint8_t  totiles = 0;                                       // 1 = zline traegt in die Displayliste ein
+uint8_t  tilesok = 0;                                       // 0 = Zeiger direkt zeichnen (Bereich / Liste zu klein)
 
 #define button_rechts   6      // PD6
 #define button_links    4      // PD4
@@ -176,6 +197,19 @@ void spiro_generate(int inner, int outer, int evol, int resol, int t, uint16_t c
                                    Analog-Uhr
    ----------------------------------------------------------------------------- */
 
+/* --------------------------------------------------------
+                          zline
+
+     zeichnet eine Linie direkt auf das Display oder
+     traegt sie bei totiles in die Displayliste der
+     kachelweisen Ausgabe ein
+   -------------------------------------------------------- */
+void zline(int x1, int y1, int x2, int y2, uint16_t col)
+{
+  if (totiles) tiles.line(x1,y1,x2,y2,col);
+          else lcd.line(x1,y1,x2,y2,col);
+}
+
 /* --------------------------------------------------------
                        zeigerpos
 
@@ -213,7 +247,7 @@ void drawstdskala(int x, int y, int r1, int r2, uint16_t col)
   {
     zeigerpos(x,y,r1,i*30,&zx1,&zy1);
     zeigerpos(x,y,r2,i*30,&zx2,&zy2);
-    lcd.line(zx1,zy1,zx2,zy2,col);
+    zline(zx1,zy1,zx2,zy2,col);
   }
 }
 
@@ -231,7 +265,7 @@ void drawminskala(int x, int y, int r1, int r2, uint16_t col)
   {
     zeigerpos(x,y,r1,i*6,&zx1,&zy1);
     zeigerpos(x,y,r2,i*6,&zx2,&zy2);
-    lcd.line(zx1,zy1,zx2,zy2,col);
+    zline(zx1,zy1,zx2,zy2,col);
   }
 }
 
@@ -246,17 +280,17 @@ void drawzeiger(int x, int y, int r, int w, uint16_t col)
   int x2,y2;
 
   zeigerpos(x,y,r,w, &x2 ,&y2);
-  lcd.line(x,y,x2,y2,col);
+  zline(x,y,x2,y2,col);
 
   zeigerpos(x+1,y,r,w, &x2 ,&y2);
-  lcd.line(x+1,y,x2,y2,col);
+  zline(x+1,y,x2,y2,col);
   zeigerpos(x-1,y,r,w, &x2 ,&y2);
-  lcd.line(x-1,y,x2,y2,col);
+  zline(x-1,y,x2,y2,col);
 
   zeigerpos(x,y+1,r,w, &x2 ,&y2);
-  lcd.line(x,y+1,x2,y2,col);
+  zline(x,y+1,x2,y2,col);
   zeigerpos(x,y-1,r,w, &x2 ,&y2);
-  lcd.line(x,y-1,x2,y2,col);
+  zline(x,y-1,x2,y2,col);
 }
 
 
@@ -271,7 +305,7 @@ void drawsmallzeiger(int x, int y, int r, int w, uint16_t col)
   int x2,y2;
 
   zeigerpos(x,y,r,w, &x2 ,&y2);
-  lcd.line(x,y,x2,y2,col);
+  zline(x,y,x2,y2,col);
 }
 
 /* --------------------------------------------------------
@@ -279,26 +313,44 @@ void drawsmallzeiger(int x, int y, int r, int w, uint16_t col)
 
       zeichnet die Zeiger einer Uhr.
 
-      ziffbk   : Farbwert des Ziffernblatts der Uhr
-      clear    : 0 = Zeiger werden gezeichnet
-                 1 = Zeiger werden mit Hintergrundfarbe
-                     gezeichnet (und somit geloescht)
+      Die Zeiger werden in die Displayliste von tiles
+      eingetragen (Ziffernblatt und Skalen sind dort
+      seit uhrscreen festgehalten), render gibt nur die
+      Kacheln aus, in denen sich etwas geaendert hat.
+      Die alten Zeiger muessen so nicht geloescht werden,
+      das Bild flackert nicht.
+
+      Passt etwas nicht in die Displayliste (tiles.lost),
+      wird ab dann ohne Kacheln gezeichnet: Ziffernblatt
+      loeschen, Skalen und Zeiger direkt ausgeben (flackert).
    -------------------------------------------------------- */
-void showzeiger(uint8_t astd, uint8_t amin, uint8_t asek, uint16_t ziffbk, uint8_t clear)
+void showzeiger(uint8_t astd, uint8_t amin, uint8_t asek)
 {
   if (astd > 12) astd -= 12;
-  if (clear)
+  if (tilesok)
   {
-    drawzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-20, amin*6, ziffbk);
-    drawzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-stdzeig, (astd*30) + (amin / 2), ziffbk);
-    drawsmallzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-20, asek*6, ziffbk);
+    tiles.clear();
+    totiles= 1;
   }
   else
   {
-    drawzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-20, amin*6, rgbfromega(red));
-    drawzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-stdzeig, (astd*30) + (amin / 2), rgbfromega(lightred));
-    drawsmallzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-20, asek*6, rgbfromega(black));
+    lcd.fillcircle(xuo+ruhr+9,yuo+ruhr+9,ruhr-12, ziffbk);
+    drawminskala(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/10)-16, ruhr-16, rgbfromega(9));
+    drawstdskala(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-16, ruhr-16, rgbfromega(0));
   }
+  drawzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-20, amin*6, rgbfromega(red));
+  drawzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-stdzeig, (astd*30) + (amin / 2), rgbfromega(lightred));
+  drawsmallzeiger(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-20, asek*6, rgbfromega(black));
+  totiles= 0;
+  if (!tilesok) return;
+
+  if (tiles.lost)
+  {
+    tilesok= 0;
+    showzeiger(astd, amin, asek);
+    return;
+  }
+  tiles.render();
 }
 
 
@@ -325,6 +377,18 @@ void uhrscreen(void)
   drawminskala(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/10)-16, ruhr-16, rgbfromega(9));
   drawstdskala(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-16, ruhr-16, rgbfromega(0));
 
+  // Bereich der Zeiger fuer die kachelweise Ausgabe: Ziffernblatt (Hintergrund)
+  // und die Skalenstriche darin bleiben in der Displayliste
+  tilesok= tiles.area(xuo+ruhr+9-zeigerr, yuo+ruhr+9-zeigerr, xuo+ruhr+9+zeigerr, yuo+ruhr+9+zeigerr);
+  if (!tilesok) return;
+  tiles.bkcolor= ziffbk;
+  tiles.reset();
+  totiles= 1;
+  drawminskala(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/10)-16, ruhr-16, rgbfromega(9));
+  drawstdskala(xuo+ruhr+9, yuo+ruhr+9, ruhr-(ruhr/5)-16, ruhr-16, rgbfromega(0));
+  totiles= 0;
+  tiles.keep();
+  if (tiles.lost) tilesok= 0;
 }
 
 /* -------------------------------------------------------
@@ -469,7 +533,7 @@ void setup()
   oldsek= date.sek;
    
   uhrscreen();
-  showzeiger(date.std, date.min, date.sek, ziffbk, 0);  
+  showzeiger(date.std, date.min, date.sek);
   digitalscreen();    
   
 }
@@ -483,14 +547,9 @@ void loop()
   uint8_t z_year;  
   uint8_t b,cx;  
       
-  // alte Uhrstellung loeschen
-  showzeiger(oldstd, oldmin, oldsek, ziffbk, 1);
-  oldsek= date.sek;
-  oldmin= date.min;
   oldsek= date.sek;
-  oldstd= date.std;
-  // neue Uhrstellung anzeigen
-  showzeiger(date.std, date.min, date.sek, ziffbk, 0);  
+  // neue Uhrstellung anzeigen, nur geaenderte Kacheln werden ausgegeben
+  showzeiger(date.std, date.min, date.sek);
   
   digitalscreen();
   